@@ -0,0 +1,519 @@
+/* duktape binding generation implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "options.h"
+#include "utils.h"
+#include "nsgenbind-ast.h"
+#include "webidl-ast.h"
+#include "ir.h"
+#include "duk-libdom.h"
+
+/** prefix for all generated functions */
+#define DLPFX "dukky"
+
+#define MAGICPFX "\\xFF\\xFFNETSURF_DUKTAPE_"
+
+/**
+ * how a callback argument is passed to the invocation function
+ */
+enum callback_argument_kind {
+        CBARG_INDEX, /**< index of a value on the value stack */
+        CBARG_STRING, /**< nul terminated string, NULL for null */
+        CBARG_BOOL, /**< boolean */
+        CBARG_INT, /**< signed integer */
+        CBARG_UINT, /**< unsigned integer */
+        CBARG_NUMBER, /**< number, also integers wider than duk_int_t */
+        CBARG_ENUM, /**< generated C enumeration */
+};
+
+/**
+ * get how a callback argument is passed
+ *
+ * Values with no direct C representation such as objects, unions,
+ * variadic arguments and nullable numbers are passed as an index of
+ * the value on the value stack.
+ */
+static enum callback_argument_kind
+callback_argument_kind(struct ir_operation_argument_entry *arge)
+{
+        struct ir_type_entry *type;
+
+        if ((arge->typec != 1) || (arge->elipsisc != 0)) {
+                return CBARG_INDEX;
+        }
+        type = arge->typev;
+
+        if (type->base == WEBIDL_TYPE_STRING) {
+                return CBARG_STRING;
+        }
+
+        if (type->nullable) {
+                return CBARG_INDEX;
+        }
+
+        switch (type->base) {
+        case WEBIDL_TYPE_BOOL:
+                return CBARG_BOOL;
+
+        case WEBIDL_TYPE_BYTE:
+        case WEBIDL_TYPE_OCTET:
+        case WEBIDL_TYPE_SHORT:
+        case WEBIDL_TYPE_LONG:
+                if (type->modifier == WEBIDL_TYPE_MODIFIER_UNSIGNED) {
+                        return CBARG_UINT;
+                }
+                return CBARG_INT;
+
+        case WEBIDL_TYPE_LONGLONG:
+                /* wider than duk_int_t so passed as a number */
+        case WEBIDL_TYPE_FLOAT:
+        case WEBIDL_TYPE_DOUBLE:
+                return CBARG_NUMBER;
+
+        case WEBIDL_TYPE_USER:
+                if (type->enumeration != NULL) {
+                        return CBARG_ENUM;
+                }
+                break;
+
+        default:
+                break;
+        }
+
+        return CBARG_INDEX;
+}
+
+/**
+ * output the parameter list of a callback invocation function
+ *
+ * Argument names are prefixed so they cannot be C keywords or clash
+ * with the leading parameters.
+ */
+static int
+output_callback_parameters(FILE* outf, struct ir_callback_entry *callbacke)
+{
+        struct ir_operation_argument_entry *arge;
+        int argc;
+
+        fprintf(outf,
+                "duk_context *ctx, struct %s_callback *cb, duk_idx_t thisidx",
+                DLPFX);
+
+        for (argc = 0; argc < callbacke->argumentc; argc++) {
+                arge = callbacke->argumentv + argc;
+
+                switch (callback_argument_kind(arge)) {
+                case CBARG_INDEX:
+                        fprintf(outf, ", duk_idx_t arg_%s", arge->name);
+                        break;
+
+                case CBARG_STRING:
+                        fprintf(outf, ", const char *arg_%s", arge->name);
+                        break;
+
+                case CBARG_BOOL:
+                        fprintf(outf, ", duk_bool_t arg_%s", arge->name);
+                        break;
+
+                case CBARG_INT:
+                        fprintf(outf, ", duk_int_t arg_%s", arge->name);
+                        break;
+
+                case CBARG_UINT:
+                        fprintf(outf, ", duk_uint_t arg_%s", arge->name);
+                        break;
+
+                case CBARG_NUMBER:
+                        fprintf(outf, ", duk_double_t arg_%s", arge->name);
+                        break;
+
+                case CBARG_ENUM:
+                        fprintf(outf, ", enum %s_%s arg_%s",
+                                DLPFX,
+                                arge->typev->enumeration->class_name,
+                                arge->name);
+                        break;
+                }
+        }
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int output_callback_handle_declaration(FILE* outf)
+{
+        fprintf(outf,
+                "/* Callback handles */\n"
+                "struct %s_callback {\n"
+                "\tvoid *func; /* pinned function or callback interface object */\n"
+                "\tduk_uint_t slot; /* stash slot keeping func reachable */\n"
+                "};\n"
+                "duk_bool_t %s_callback_set(duk_context *ctx, duk_idx_t idx, struct %s_callback *cb);\n"
+                "void %s_callback_clear(duk_context *ctx, struct %s_callback *cb);\n"
+                "void %s_callback_push(duk_context *ctx, struct %s_callback *cb);\n\n",
+                DLPFX,
+                DLPFX, DLPFX,
+                DLPFX, DLPFX,
+                DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int output_callback_handle_definition(FILE* outf)
+{
+        /* release a pinned reference */
+        fprintf(outf,
+                "/* Callback handles\n"
+                " *\n"
+                " * Each handle pins its value in a slot of an array in the global\n"
+                " * stash and keeps the heap pointer so invocation pushes it directly.\n"
+                " * Element 0 of the array heads a list of released slots so a\n"
+                " * handle with slot 0 refers to a value it has not pinned.\n"
+                " */\n"
+                "void\n"
+                "%s_callback_clear(duk_context *ctx, struct %s_callback *cb)\n"
+                "{\n"
+                "\tif (cb->slot == 0) {\n"
+                "\t\tcb->func = NULL;\n"
+                "\t\treturn;\n"
+                "\t}\n"
+                "\tduk_push_global_stash(ctx);\n"
+                "\tduk_get_prop_string(ctx, -1, \"%sCALLBACKS\");\n"
+                "\t/* ... stash slots */\n"
+                "\tduk_get_prop_index(ctx, -1, 0);\n"
+                "\tduk_put_prop_index(ctx, -2, cb->slot);\n"
+                "\tduk_push_uint(ctx, cb->slot);\n"
+                "\tduk_put_prop_index(ctx, -2, 0);\n"
+                "\tduk_pop_2(ctx);\n"
+                "\tcb->func = NULL;\n"
+                "\tcb->slot = 0;\n"
+                "}\n\n",
+                DLPFX, DLPFX, MAGICPFX);
+
+        /* pin a value */
+        fprintf(outf,
+                "duk_bool_t\n"
+                "%s_callback_set(duk_context *ctx, duk_idx_t idx, struct %s_callback *cb)\n"
+                "{\n"
+                "\tduk_uint_t slot;\n"
+                "\n"
+                "\tidx = duk_normalize_index(ctx, idx);\n"
+                "\t%s_callback_clear(ctx, cb);\n"
+                "\tif (!duk_is_object(ctx, idx)) {\n"
+                "\t\treturn 0;\n"
+                "\t}\n"
+                "\n"
+                "\tduk_push_global_stash(ctx);\n"
+                "\tif (!duk_get_prop_string(ctx, -1, \"%sCALLBACKS\")) {\n"
+                "\t\tduk_pop(ctx);\n"
+                "\t\tduk_push_array(ctx);\n"
+                "\t\tduk_push_uint(ctx, 0);\n"
+                "\t\tduk_put_prop_index(ctx, -2, 0);\n"
+                "\t\tduk_dup(ctx, -1);\n"
+                "\t\tduk_put_prop_string(ctx, -3, \"%sCALLBACKS\");\n"
+                "\t}\n"
+                "\t/* ... stash slots */\n"
+                "\tduk_get_prop_index(ctx, -1, 0);\n"
+                "\tslot = duk_get_uint(ctx, -1);\n"
+                "\tduk_pop(ctx);\n"
+                "\tif (slot != 0) {\n"
+                "\t\t/* reuse a released slot */\n"
+                "\t\tduk_get_prop_index(ctx, -1, slot);\n"
+                "\t\tduk_put_prop_index(ctx, -2, 0);\n"
+                "\t} else {\n"
+                "\t\tslot = duk_get_length(ctx, -1);\n"
+                "\t}\n"
+                "\tduk_dup(ctx, idx);\n"
+                "\tduk_put_prop_index(ctx, -2, slot);\n"
+                "\tduk_pop_2(ctx);\n"
+                "\n"
+                "\tcb->func = duk_get_heapptr(ctx, idx);\n"
+                "\tcb->slot = slot;\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX,
+                DLPFX,
+                MAGICPFX, MAGICPFX);
+
+        /* push the pinned value or null */
+        fprintf(outf,
+                "void\n"
+                "%s_callback_push(duk_context *ctx, struct %s_callback *cb)\n"
+                "{\n"
+                "\tif (cb->func == NULL) {\n"
+                "\t\tduk_push_null(ctx);\n"
+                "\t} else {\n"
+                "\t\tduk_push_heapptr(ctx, cb->func);\n"
+                "\t}\n"
+                "}\n\n",
+                DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int
+output_callback_declaration(FILE* outf, struct ir_callback_entry *callbacke)
+{
+        fprintf(outf, "/* %s callback%s */\n",
+                callbacke->name,
+                (callbacke->interface != NULL) ? " interface" : "");
+
+        fprintf(outf, "duk_int_t %s_%s_invoke(",
+                DLPFX, callbacke->class_name);
+        output_callback_parameters(outf, callbacke);
+        fprintf(outf, ");\n\n");
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int
+output_callback_definition(FILE* outf, struct ir_callback_entry *callbacke)
+{
+        struct ir_operation_argument_entry *arge;
+        int argc;
+
+        fprintf(outf, "duk_int_t\n%s_%s_invoke(",
+                DLPFX, callbacke->class_name);
+        output_callback_parameters(outf, callbacke);
+        fprintf(outf, ")\n{\n");
+
+        /* stack indexes must not move as the call is built */
+        fprintf(outf,
+                "\tif (thisidx != DUK_INVALID_INDEX) {\n"
+                "\t\tthisidx = duk_normalize_index(ctx, thisidx);\n"
+                "\t}\n");
+        for (argc = 0; argc < callbacke->argumentc; argc++) {
+                arge = callbacke->argumentv + argc;
+                if (callback_argument_kind(arge) == CBARG_INDEX) {
+                        fprintf(outf,
+                                "\targ_%s = duk_normalize_index(ctx, arg_%s);\n",
+                                arge->name, arge->name);
+                }
+        }
+        fprintf(outf, "\n");
+
+        fprintf(outf, "\tduk_push_heapptr(ctx, cb->func);\n");
+        if (callbacke->interface == NULL) {
+                fprintf(outf,
+                        "\t/* ... func */\n"
+                        "\tif (thisidx == DUK_INVALID_INDEX) {\n"
+                        "\t\tduk_push_undefined(ctx);\n"
+                        "\t} else {\n"
+                        "\t\tduk_dup(ctx, thisidx);\n"
+                        "\t}\n");
+        } else {
+                /* objects which are not callable have the operation
+                 * invoked on them
+                 */
+                fprintf(outf,
+                        "\tif (duk_is_callable(ctx, -1)) {\n"
+                        "\t\t/* ... func */\n"
+                        "\t\tif (thisidx == DUK_INVALID_INDEX) {\n"
+                        "\t\t\tduk_push_undefined(ctx);\n"
+                        "\t\t} else {\n"
+                        "\t\t\tduk_dup(ctx, thisidx);\n"
+                        "\t\t}\n"
+                        "\t} else {\n"
+                        "\t\t/* ... obj */\n"
+                        "\t\tduk_get_prop_string(ctx, -1, \"%s\");\n"
+                        "\t\tduk_insert(ctx, -2);\n"
+                        "\t}\n",
+                        callbacke->operation_name);
+        }
+        fprintf(outf, "\t/* ... func this */\n");
+
+        for (argc = 0; argc < callbacke->argumentc; argc++) {
+                arge = callbacke->argumentv + argc;
+
+                switch (callback_argument_kind(arge)) {
+                case CBARG_INDEX:
+                        fprintf(outf, "\tduk_dup(ctx, arg_%s);\n", arge->name);
+                        break;
+
+                case CBARG_STRING:
+                        fprintf(outf,
+                                "\tduk_push_string(ctx, arg_%s);\n",
+                                arge->name);
+                        break;
+
+                case CBARG_BOOL:
+                        fprintf(outf,
+                                "\tduk_push_boolean(ctx, arg_%s);\n",
+                                arge->name);
+                        break;
+
+                case CBARG_INT:
+                        fprintf(outf,
+                                "\tduk_push_int(ctx, arg_%s);\n",
+                                arge->name);
+                        break;
+
+                case CBARG_UINT:
+                        fprintf(outf,
+                                "\tduk_push_uint(ctx, arg_%s);\n",
+                                arge->name);
+                        break;
+
+                case CBARG_NUMBER:
+                        fprintf(outf,
+                                "\tduk_push_number(ctx, arg_%s);\n",
+                                arge->name);
+                        break;
+
+                case CBARG_ENUM:
+                        fprintf(outf,
+                                "\tduk_push_string(ctx, %s_%s_to_string(arg_%s));\n",
+                                DLPFX,
+                                arge->typev->enumeration->class_name,
+                                arge->name);
+                        break;
+                }
+        }
+
+        fprintf(outf,
+                "\treturn duk_pcall_method(ctx, %d);\n"
+                "}\n\n",
+                callbacke->argumentc);
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int output_event_handler_declaration(FILE* outf, struct ir *ir)
+{
+        fprintf(outf, "/* Event handler slots */\n");
+
+        output_enumeration_declaration(outf, &ir->event_handlers);
+
+        fprintf(outf,
+                "#define DUKKY_EVENT_HANDLER_COUNT %d\n"
+                "struct %s_callback *%s_event_handler_get(void *priv, enum %s_event_handler slot);\n"
+                "duk_bool_t %s_event_handler_push(duk_context *ctx, void *priv, enum %s_event_handler slot);\n"
+                "duk_bool_t %s_event_handler_set(duk_context *ctx, void *priv, duk_idx_t obj, enum %s_event_handler slot, duk_idx_t idx);\n"
+                "void %s_event_handler_fini(void *priv);\n\n",
+                ir->event_handlers.valuec,
+                DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX,
+                DLPFX, DLPFX,
+                DLPFX);
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int output_event_handler_definition(FILE* outf, struct ir *ir)
+{
+        int res;
+
+        res = output_enumeration_definition(outf, &ir->event_handlers);
+        if (res != 0) {
+                return res;
+        }
+
+        /* the slots are reached through the root class private data */
+        fprintf(outf,
+                "/* Leading members of the private data of root classes */\n"
+                "struct %s_private_root {\n"
+                "\tvoid *wrapped;\n"
+                "\tstruct %s_callback *handlers;\n"
+                "};\n\n",
+                DLPFX, DLPFX);
+
+        fprintf(outf,
+                "struct %s_callback *\n"
+                "%s_event_handler_get(void *priv, enum %s_event_handler slot)\n"
+                "{\n"
+                "\tstruct %s_callback *handlers;\n"
+                "\n"
+                "\thandlers = ((struct %s_private_root *)priv)->handlers;\n"
+                "\tif ((handlers == NULL) || (handlers[slot].func == NULL)) {\n"
+                "\t\treturn NULL;\n"
+                "\t}\n"
+                "\treturn &handlers[slot];\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        fprintf(outf,
+                "duk_bool_t\n"
+                "%s_event_handler_push(duk_context *ctx, void *priv, enum %s_event_handler slot)\n"
+                "{\n"
+                "\tstruct %s_callback *cb;\n"
+                "\n"
+                "\tcb = %s_event_handler_get(priv, slot);\n"
+                "\tif (cb == NULL) {\n"
+                "\t\tduk_push_null(ctx);\n"
+                "\t\treturn 0;\n"
+                "\t}\n"
+                "\tduk_push_heapptr(ctx, cb->func);\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX);
+
+        /* The handles are not pinned in the global stash, the object
+         * keeps the values reachable in a hidden array instead so a
+         * handler referring to its own element does not keep it alive.
+         */
+        fprintf(outf,
+                "duk_bool_t\n"
+                "%s_event_handler_set(duk_context *ctx, void *priv, duk_idx_t obj, enum %s_event_handler slot, duk_idx_t idx)\n"
+                "{\n"
+                "\tstruct %s_private_root *root = priv;\n"
+                "\n"
+                "\tobj = duk_normalize_index(ctx, obj);\n"
+                "\tidx = duk_normalize_index(ctx, idx);\n"
+                "\tif (root->handlers == NULL) {\n"
+                "\t\tif (!duk_is_object(ctx, idx)) {\n"
+                "\t\t\treturn 1;\n"
+                "\t\t}\n"
+                "\t\troot->handlers = calloc(DUKKY_EVENT_HANDLER_COUNT, sizeof(struct %s_callback));\n"
+                "\t\tif (root->handlers == NULL) {\n"
+                "\t\t\treturn 0;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tif (!duk_get_prop_string(ctx, obj, \"%sEVENT_HANDLERS\")) {\n"
+                "\t\tduk_pop(ctx);\n"
+                "\t\tduk_push_array(ctx);\n"
+                "\t\tduk_dup(ctx, -1);\n"
+                "\t\tduk_put_prop_string(ctx, obj, \"%sEVENT_HANDLERS\");\n"
+                "\t}\n"
+                "\t/* ... handlers */\n"
+                "\tif (duk_is_object(ctx, idx)) {\n"
+                "\t\tduk_dup(ctx, idx);\n"
+                "\t\troot->handlers[slot].func = duk_get_heapptr(ctx, idx);\n"
+                "\t} else {\n"
+                "\t\tduk_push_null(ctx);\n"
+                "\t\troot->handlers[slot].func = NULL;\n"
+                "\t}\n"
+                "\tduk_put_prop_index(ctx, -2, slot);\n"
+                "\tduk_pop(ctx);\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, MAGICPFX, MAGICPFX);
+
+        /* the values go with the object so only the slots are freed */
+        fprintf(outf,
+                "void\n"
+                "%s_event_handler_fini(void *priv)\n"
+                "{\n"
+                "\tstruct %s_private_root *root = priv;\n"
+                "\n"
+                "\tfree(root->handlers);\n"
+                "\troot->handlers = NULL;\n"
+                "}\n\n",
+                DLPFX, DLPFX);
+
+        return 0;
+}
@@ -22,6 +22,11 @@
 #include "ir.h"
 #include "duk-libdom.h"
 
+/** prefix for all generated functions */
+#define DLPFX "dukky"
+
+#define MAGICPFX "\\xFF\\xFFNETSURF_DUKTAPE_"
+
 #define NSGENBIND_PREFACE                                               \
     "/* Generated by nsgenbind\n"                                       \
     " *\n"                                                              \
@@ -81,14 +86,44 @@ int output_ccode(FILE* outf, struct genbind_node *node)
 }
 
 /* exported interface documented in duk-libdom.h */
-int output_tool_prologue(FILE* outf)
+int output_class_include(FILE* outf, struct ir_entry *entry, bool inlineinit)
+{
+        char *fname;
+        char *fpath;
+        int fnamel;
+
+        fnamel = strlen(entry->class_name) + SLEN("_inline.h") + 1;
+        fname = malloc(fnamel);
+        snprintf(fname, fnamel, "%s%s.h",
+                 entry->class_name, inlineinit ? "_inline" : "");
+
+        fpath = genb_fpath(fname);
+        fprintf(outf, "#include \"%s\"\n", fpath);
+        free(fpath);
+        free(fname);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_tool_prologue(FILE* outf, struct ir_entry *entry)
 {
         char *fpath;
 
+        if (options->profiletime) {
+                /* the profile timers read the monotonic clock */
+                fprintf(outf, "\n#include <time.h>\n");
+        }
+
         fpath = genb_fpath("binding.h");
         fprintf(outf, "\n#include \"%s\"\n", fpath);
         free(fpath);
 
+        /* a class only needs its own header when they are split */
+        if ((entry != NULL) && options->splitheaders) {
+                return output_class_include(outf, entry, false);
+        }
+
         fpath = genb_fpath("private.h");
         fprintf(outf, "#include \"%s\"\n", fpath);
         free(fpath);
@@ -229,3 +264,1010 @@ char *gen_idl2c_name(const char *idlname)
         }
         return name;
 }
+
+/* exported interface documented in duk-libdom.h */
+int output_cstring(FILE* outf, const char *str)
+{
+        const unsigned char *chr = (const unsigned char *)str;
+        size_t idx;
+
+        fputc('"', outf);
+        for (idx = 0; chr[idx] != 0; idx++) {
+                if ((chr[idx] == '"') || (chr[idx] == '\\')) {
+                        fputc('\\', outf);
+                        fputc(chr[idx], outf);
+                } else if ((chr[idx] < 0x20) || (chr[idx] >= 0x7f) ||
+                           ((chr[idx] == '?') && (chr[idx + 1] == '?')) ||
+                           ((chr[idx] == '/') && (idx > 0) &&
+                            (chr[idx - 1] == '*'))) {
+                        /* octal escapes avoid trigraphs and ending a
+                         * comment the literal is quoted in
+                         */
+                        fprintf(outf, "\\%03o", chr[idx]);
+                } else {
+                        fputc(chr[idx], outf);
+                }
+        }
+        fputc('"', outf);
+
+        return 0;
+}
+
+/**
+ * names of generated functions with profiling counters
+ *
+ * The index of a name is the identifier used for the counter in the
+ * generated profile table.
+ */
+static struct {
+        int namec;
+        char **namev;
+} profile;
+
+/* exported interface documented in duk-libdom.h */
+int output_profile_counter(FILE* outf,
+                           struct ir_entry *entry,
+                           const char *member,
+                           const char *kind)
+{
+        char **namev;
+        char *name;
+        int namel;
+
+        if (!options->profile) {
+                return 0;
+        }
+
+        namev = realloc(profile.namev, (profile.namec + 1) * sizeof(char *));
+        if (namev == NULL) {
+                return -1;
+        }
+        profile.namev = namev;
+
+        namel = strlen(entry->name) + 3;
+        if (member != NULL) {
+                namel += strlen(member) + 2;
+        }
+        if (kind != NULL) {
+                namel += strlen(kind) + 1;
+        }
+        name = malloc(namel);
+        if (name == NULL) {
+                return -1;
+        }
+        snprintf(name, namel, "%s%s%s%s%s",
+                 entry->name,
+                 (member != NULL) ? "::" : "",
+                 (member != NULL) ? member : "",
+                 (kind != NULL) ? " " : "",
+                 (kind != NULL) ? kind : "");
+
+        if (options->profiletime) {
+                fprintf(outf,
+                        "\tDUKKY_PROFILE_TIMED(%d);\n",
+                        profile.namec);
+        } else {
+                fprintf(outf,
+                        "\t%s_profile_table[%d].calls++;\n",
+                        DLPFX, profile.namec);
+        }
+
+        profile.namev[profile.namec++] = name;
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_profile_declaration(FILE* outf)
+{
+        if (!options->profile) {
+                return 0;
+        }
+
+        fprintf(outf,
+                "/* Profiling counters */\n"
+                "struct %s_profile_entry {\n"
+                "\tconst char *name; /* name of the binding function */\n"
+                "\tunsigned long calls; /* number of calls */\n"
+                "\tunsigned long long nsec; /* time in function */\n"
+                "};\n"
+                "\n"
+                "#define DUKKY_PROFILE_COUNT %d\n"
+                "\n"
+                "extern struct %s_profile_entry %s_profile_table[DUKKY_PROFILE_COUNT + 1];\n"
+                "void %s_profile_dump(FILE *fh);\n"
+                "void %s_profile_reset(void);\n"
+                "\n",
+                DLPFX,
+                profile.namec,
+                DLPFX, DLPFX,
+                DLPFX,
+                DLPFX);
+
+        if (options->profiletime) {
+                fprintf(outf,
+                        "struct %s_profile_timer {\n"
+                        "\tint id;\n"
+                        "\tunsigned long long start;\n"
+                        "};\n"
+                        "struct %s_profile_timer %s_profile_start(int id);\n"
+                        "void %s_profile_end(struct %s_profile_timer *timer);\n"
+                        "\n"
+                        "/* the timer is stopped as the function scope is left */\n"
+                        "#if defined(__GNUC__)\n"
+                        "#define DUKKY_PROFILE_TIMED(id) \\\n"
+                        "\tstruct %s_profile_timer %s_profile_timer \\\n"
+                        "\t__attribute__((cleanup(%s_profile_end))) = %s_profile_start(id)\n"
+                        "#else\n"
+                        "/* without scope cleanup only calls are counted */\n"
+                        "#define DUKKY_PROFILE_TIMED(id) %s_profile_table[id].calls++\n"
+                        "#endif\n"
+                        "\n",
+                        DLPFX,
+                        DLPFX, DLPFX,
+                        DLPFX, DLPFX,
+                        DLPFX, DLPFX,
+                        DLPFX, DLPFX,
+                        DLPFX);
+        }
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_profile_definition(FILE* outf)
+{
+        int idx;
+
+        if (!options->profile) {
+                return 0;
+        }
+
+        fprintf(outf,
+                "/* Profiling counters */\n"
+                "struct %s_profile_entry %s_profile_table[DUKKY_PROFILE_COUNT + 1] = {\n",
+                DLPFX, DLPFX);
+        for (idx = 0; idx < profile.namec; idx++) {
+                fprintf(outf, "\t{ \"%s\", 0, 0 },\n", profile.namev[idx]);
+                free(profile.namev[idx]);
+        }
+        fprintf(outf, "\t{ NULL, 0, 0 },\n};\n\n");
+
+        free(profile.namev);
+        profile.namev = NULL;
+        profile.namec = 0;
+
+        fprintf(outf,
+                "void %s_profile_dump(FILE *fh)\n"
+                "{\n"
+                "\tint idx;\n"
+                "\tfor (idx = 0; idx < DUKKY_PROFILE_COUNT; idx++) {\n"
+                "\t\tif (%s_profile_table[idx].calls != 0) {\n"
+                "\t\t\tfprintf(fh, \"%%s calls:%%lu nsec:%%llu\\n\",\n"
+                "\t\t\t    %s_profile_table[idx].name,\n"
+                "\t\t\t    %s_profile_table[idx].calls,\n"
+                "\t\t\t    %s_profile_table[idx].nsec);\n"
+                "\t\t}\n"
+                "\t}\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        fprintf(outf,
+                "void %s_profile_reset(void)\n"
+                "{\n"
+                "\tint idx;\n"
+                "\tfor (idx = 0; idx < DUKKY_PROFILE_COUNT; idx++) {\n"
+                "\t\t%s_profile_table[idx].calls = 0;\n"
+                "\t\t%s_profile_table[idx].nsec = 0;\n"
+                "\t}\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX);
+
+        if (options->profiletime) {
+                fprintf(outf,
+                        "static inline unsigned long long %s_profile_now(void)\n"
+                        "{\n"
+                        "\tstruct timespec ts;\n"
+                        "\tclock_gettime(CLOCK_MONOTONIC, &ts);\n"
+                        "\treturn (ts.tv_sec * 1000000000ULL) + ts.tv_nsec;\n"
+                        "}\n\n"
+                        "struct %s_profile_timer %s_profile_start(int id)\n"
+                        "{\n"
+                        "\tstruct %s_profile_timer timer;\n"
+                        "\t%s_profile_table[id].calls++;\n"
+                        "\ttimer.id = id;\n"
+                        "\ttimer.start = %s_profile_now();\n"
+                        "\treturn timer;\n"
+                        "}\n\n"
+                        "void %s_profile_end(struct %s_profile_timer *timer)\n"
+                        "{\n"
+                        "\t%s_profile_table[timer->id].nsec += %s_profile_now() - timer->start;\n"
+                        "}\n\n",
+                        DLPFX,
+                        DLPFX, DLPFX,
+                        DLPFX,
+                        DLPFX,
+                        DLPFX,
+                        DLPFX, DLPFX,
+                        DLPFX, DLPFX);
+        }
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_profile_placement(FILE* outf,
+                             struct ir *ir,
+                             struct ir_entry *entry,
+                             const char *member,
+                             const char *kind)
+{
+        unsigned long count;
+
+        if (options->profileuse == NULL) {
+                return 0;
+        }
+
+        count = ir_profile_count(ir, entry, member, kind);
+        if (count == 0) {
+                fprintf(outf, "DUKKY_COLD\n");
+        } else if (count >= ir->profile_hot) {
+                fprintf(outf, "DUKKY_HOT\n");
+        }
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_profile_placement_declaration(FILE* outf)
+{
+        if (options->profileuse == NULL) {
+                return 0;
+        }
+
+        fprintf(outf,
+                "/* Placement of functions from the call frequency profile */\n"
+                "#if defined(__GNUC__) && defined(__ELF__)\n"
+                "#define DUKKY_HOT __attribute__((hot, section(\".text.hot.%s\")))\n"
+                "#define DUKKY_COLD __attribute__((cold, section(\".text.unlikely.%s\")))\n"
+                "#elif defined(__GNUC__)\n"
+                "#define DUKKY_HOT __attribute__((hot))\n"
+                "#define DUKKY_COLD __attribute__((cold))\n"
+                "#else\n"
+                "#define DUKKY_HOT\n"
+                "#define DUKKY_COLD\n"
+                "#endif\n"
+                "\n",
+                DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_pruned_declaration(FILE* outf)
+{
+        fprintf(outf,
+                "/* Stub for pruned methods and attributes */\n"
+                "duk_ret_t %s_pruned_stub(duk_context *ctx);\n"
+                "\n",
+                DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_pruned_definition(FILE* outf)
+{
+        fprintf(outf,
+                "/* Stub for pruned methods and attributes */\n"
+                "duk_ret_t %s_pruned_stub(duk_context *ctx)\n"
+                "{\n"
+                "\treturn duk_error(ctx, DUK_ERR_TYPE_ERROR, \"not supported\");\n"
+                "}\n\n",
+                DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_wrapper_declaration(FILE* outf)
+{
+        fprintf(outf,
+                "/* Wrapper cache */\n"
+                "void *%s_wrapper_find(duk_context *ctx, void *native);\n"
+                "duk_bool_t %s_wrapper_push(duk_context *ctx, void *native);\n"
+                "int %s_wrapper_insert(duk_context *ctx, void *native, duk_idx_t idx);\n"
+                "int %s_wrapper_insert_proxy(duk_context *ctx, void *native, duk_idx_t idx, duk_idx_t proxy_idx);\n"
+                "void %s_wrapper_remove(duk_context *ctx, void *native, duk_idx_t idx);\n"
+                "unsigned int %s_wrapper_generation(duk_context *ctx, void *native);\n"
+                "void %s_wrapper_invalidate(duk_context *ctx, void *native);\n"
+                "\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_wrapper_definition(FILE* outf)
+{
+        fprintf(outf,
+                "/* Wrapper cache\n"
+                " *\n"
+                " * Open addressed table from native objects to the heap pointers of\n"
+                " * the objects wrapping them. The heap pointers are weak references\n"
+                " * removed by the generated finalizers. The generation of an entry\n"
+                " * is advanced when the native object is invalidated and discards\n"
+                " * cached [Pure] attribute values.\n"
+                " *\n"
+                " * The table is process global and shared by every heap, it is not\n"
+                " * locked so all heaps must be used from a single thread.\n"
+                " */\n"
+                "struct %s_wrapper_entry {\n"
+                "\tvoid *native; /* native object or NULL for an empty slot */\n"
+                "\tvoid *heap; /* global object of the heap holding the wrapper */\n"
+                "\tvoid *heapptr; /* wrapper object */\n"
+                "\tvoid *object; /* object pushed, the wrapper or its proxy */\n"
+                "\tunsigned int generation; /* invalidation count, never zero */\n"
+                "\tunsigned int length; /* cached collection length */\n"
+                "\tunsigned int length_generation; /* generation of length */\n"
+                "};\n\n"
+                "static struct {\n"
+                "\tsize_t size; /* number of slots, a power of two */\n"
+                "\tsize_t used; /* number of occupied slots */\n"
+                "\tstruct %s_wrapper_entry *entries;\n"
+                "} %s_wrapper_table;\n\n",
+                DLPFX, DLPFX, DLPFX);
+
+        fprintf(outf,
+                "static inline size_t %s_wrapper_hash(void *native)\n"
+                "{\n"
+                "\tsize_t hash = ((size_t)native >> 4) * 2654435761U;\n"
+                "\treturn hash ^ (hash >> 16);\n"
+                "}\n\n"
+                "static void *%s_wrapper_heap(duk_context *ctx)\n"
+                "{\n"
+                "\tvoid *heap;\n"
+                "\tduk_push_global_object(ctx);\n"
+                "\theap = duk_get_heapptr(ctx, -1);\n"
+                "\tduk_pop(ctx);\n"
+                "\treturn heap;\n"
+                "}\n\n",
+                DLPFX, DLPFX);
+
+        fprintf(outf,
+                "static struct %s_wrapper_entry *\n"
+                "%s_wrapper_slot(void *native, void *heap)\n"
+                "{\n"
+                "\tsize_t mask = %s_wrapper_table.size - 1;\n"
+                "\tsize_t slot = %s_wrapper_hash(native) & mask;\n"
+                "\tstruct %s_wrapper_entry *entry;\n"
+                "\tfor (;;) {\n"
+                "\t\tentry = &%s_wrapper_table.entries[slot];\n"
+                "\t\tif ((entry->native == NULL) ||\n"
+                "\t\t    ((entry->native == native) && (entry->heap == heap))) {\n"
+                "\t\t\treturn entry;\n"
+                "\t\t}\n"
+                "\t\tslot = (slot + 1) & mask;\n"
+                "\t}\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        fprintf(outf,
+                "static int %s_wrapper_grow(void)\n"
+                "{\n"
+                "\tstruct %s_wrapper_entry *old = %s_wrapper_table.entries;\n"
+                "\tsize_t oldsize = %s_wrapper_table.size;\n"
+                "\tsize_t size = (oldsize == 0) ? 64 : oldsize * 2;\n"
+                "\tsize_t idx;\n"
+                "\t%s_wrapper_table.entries = calloc(size, sizeof(struct %s_wrapper_entry));\n"
+                "\tif (%s_wrapper_table.entries == NULL) {\n"
+                "\t\t%s_wrapper_table.entries = old;\n"
+                "\t\treturn -1;\n"
+                "\t}\n"
+                "\t%s_wrapper_table.size = size;\n"
+                "\tfor (idx = 0; idx < oldsize; idx++) {\n"
+                "\t\tif (old[idx].native != NULL) {\n"
+                "\t\t\t*%s_wrapper_slot(old[idx].native, old[idx].heap) = old[idx];\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tfree(old);\n"
+                "\treturn 0;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX, DLPFX, DLPFX);
+
+        fprintf(outf,
+                "void *%s_wrapper_find(duk_context *ctx, void *native)\n"
+                "{\n"
+                "\tif ((%s_wrapper_table.used == 0) || (native == NULL)) {\n"
+                "\t\treturn NULL;\n"
+                "\t}\n"
+                "\treturn %s_wrapper_slot(native, %s_wrapper_heap(ctx))->object;\n"
+                "}\n\n"
+                "duk_bool_t %s_wrapper_push(duk_context *ctx, void *native)\n"
+                "{\n"
+                "\tvoid *heapptr = %s_wrapper_find(ctx, native);\n"
+                "\tif (heapptr == NULL) {\n"
+                "\t\treturn false;\n"
+                "\t}\n"
+                "\tduk_push_heapptr(ctx, heapptr);\n"
+                "\treturn true;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX);
+
+        fprintf(outf,
+                "int %s_wrapper_insert_proxy(duk_context *ctx, void *native, duk_idx_t idx, duk_idx_t proxy_idx)\n"
+                "{\n"
+                "\tstruct %s_wrapper_entry *entry;\n"
+                "\tvoid *heapptr = duk_get_heapptr(ctx, idx);\n"
+                "\tvoid *object = duk_get_heapptr(ctx, proxy_idx);\n"
+                "\tvoid *heap = %s_wrapper_heap(ctx);\n"
+                "\tif ((native == NULL) || (heapptr == NULL) || (object == NULL)) {\n"
+                "\t\treturn -1;\n"
+                "\t}\n"
+                "\tif (((%s_wrapper_table.used + 1) * 2) > %s_wrapper_table.size) {\n"
+                "\t\tif (%s_wrapper_grow() != 0) {\n"
+                "\t\t\treturn -1;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tentry = %s_wrapper_slot(native, heap);\n"
+                "\tif (entry->native == NULL) {\n"
+                "\t\tentry->native = native;\n"
+                "\t\tentry->heap = heap;\n"
+                "\t\tentry->generation = 1;\n"
+                "\t\t%s_wrapper_table.used++;\n"
+                "\t}\n"
+                "\tentry->heapptr = heapptr;\n"
+                "\tentry->object = object;\n"
+                "\tentry->length_generation = 0;\n"
+                "\treturn 0;\n"
+                "}\n\n"
+                "int %s_wrapper_insert(duk_context *ctx, void *native, duk_idx_t idx)\n"
+                "{\n"
+                "\treturn %s_wrapper_insert_proxy(ctx, native, idx, idx);\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX);
+
+        fprintf(outf,
+                "void %s_wrapper_remove(duk_context *ctx, void *native, duk_idx_t idx)\n"
+                "{\n"
+                "\tstruct %s_wrapper_entry *entries = %s_wrapper_table.entries;\n"
+                "\tsize_t mask = %s_wrapper_table.size - 1;\n"
+                "\tsize_t hole;\n"
+                "\tsize_t slot;\n"
+                "\tsize_t home;\n"
+                "\tif ((%s_wrapper_table.used == 0) || (native == NULL)) {\n"
+                "\t\treturn;\n"
+                "\t}\n"
+                "\thole = %s_wrapper_slot(native, %s_wrapper_heap(ctx)) - entries;\n"
+                "\tif ((entries[hole].native == NULL) ||\n"
+                "\t    (entries[hole].heapptr != duk_get_heapptr(ctx, idx))) {\n"
+                "\t\t/* not cached or replaced by a newer wrapper */\n"
+                "\t\treturn;\n"
+                "\t}\n"
+                "\t/* shift following entries back so no probe sequence is broken */\n"
+                "\tfor (slot = (hole + 1) & mask;\n"
+                "\t     entries[slot].native != NULL;\n"
+                "\t     slot = (slot + 1) & mask) {\n"
+                "\t\thome = %s_wrapper_hash(entries[slot].native) & mask;\n"
+                "\t\tif (((slot - home) & mask) >= ((slot - hole) & mask)) {\n"
+                "\t\t\tentries[hole] = entries[slot];\n"
+                "\t\t\thole = slot;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tentries[hole].native = NULL;\n"
+                "\tentries[hole].heap = NULL;\n"
+                "\tentries[hole].heapptr = NULL;\n"
+                "\tentries[hole].object = NULL;\n"
+                "\tentries[hole].generation = 0;\n"
+                "\tif (--%s_wrapper_table.used == 0) {\n"
+                "\t\tfree(entries);\n"
+                "\t\t%s_wrapper_table.entries = NULL;\n"
+                "\t\t%s_wrapper_table.size = 0;\n"
+                "\t}\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX, DLPFX, DLPFX);
+
+        fprintf(outf,
+                "unsigned int %s_wrapper_generation(duk_context *ctx, void *native)\n"
+                "{\n"
+                "\tif ((%s_wrapper_table.used == 0) || (native == NULL)) {\n"
+                "\t\treturn 0;\n"
+                "\t}\n"
+                "\treturn %s_wrapper_slot(native, %s_wrapper_heap(ctx))->generation;\n"
+                "}\n\n"
+                "void %s_wrapper_invalidate(duk_context *ctx, void *native)\n"
+                "{\n"
+                "\tstruct %s_wrapper_entry *entry;\n"
+                "\tif ((%s_wrapper_table.used == 0) || (native == NULL)) {\n"
+                "\t\treturn;\n"
+                "\t}\n"
+                "\tentry = %s_wrapper_slot(native, %s_wrapper_heap(ctx));\n"
+                "\tif ((entry->native != NULL) && (++entry->generation == 0)) {\n"
+                "\t\tentry->generation = 1;\n"
+                "\t}\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+bool
+interface_property_getters(struct ir *ir,
+                           struct ir_entry *interfacee,
+                           struct ir_operation_entry **indexed_out,
+                           struct ir_operation_entry **named_out,
+                           struct ir_attribute_entry **length_out)
+{
+        struct ir_operation_entry *indexed = NULL;
+        struct ir_operation_entry *named = NULL;
+        struct ir_attribute_entry *length = NULL;
+        struct ir_operation_entry *operatione;
+        struct ir_entry *entry;
+        int attrc;
+
+        if ((interfacee->type != IR_ENTRY_TYPE_INTERFACE) ||
+            (interfacee->u.interface.noobject)) {
+                return false;
+        }
+
+        /* nearest declaration along the inheritance chain */
+        for (entry = interfacee;
+             entry != NULL;
+             entry = ir_inherit_entry(ir, entry)) {
+                operatione = entry->u.interface.indexed_getter;
+                if ((indexed == NULL) &&
+                    (operatione != NULL) &&
+                    (operatione->method != NULL)) {
+                        indexed = operatione;
+                }
+
+                operatione = entry->u.interface.named_getter;
+                if ((named == NULL) &&
+                    (operatione != NULL) &&
+                    (operatione->method != NULL)) {
+                        named = operatione;
+                }
+
+                for (attrc = 0;
+                     (length == NULL) &&
+                             (attrc < entry->u.interface.attributec);
+                     attrc++) {
+                        if ((!entry->u.interface.attributev[attrc].pruned) &&
+                            (strcmp(entry->u.interface.attributev[attrc].name,
+                                    "length") == 0)) {
+                                length = entry->u.interface.attributev + attrc;
+                        }
+                }
+        }
+
+        if (indexed_out != NULL) {
+                *indexed_out = indexed;
+        }
+        if (named_out != NULL) {
+                *named_out = named;
+        }
+        if (length_out != NULL) {
+                *length_out = length;
+        }
+
+        return ((indexed != NULL) || (named != NULL));
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_proxy_declaration(FILE* outf)
+{
+        fprintf(outf,
+                "/* Indexed and named properties */\n"
+                "struct %s_proxy_class {\n"
+                "\tconst char *indexed; /* indexed property getter method or NULL */\n"
+                "\tconst char *named; /* named property getter method or NULL */\n"
+                "\tduk_bool_t length; /* indexes are bounded by the length attribute */\n"
+                "};\n"
+                "duk_ret_t %s_proxy_get(duk_context *ctx, void *native, const struct %s_proxy_class *klass);\n"
+                "duk_ret_t %s_proxy_has(duk_context *ctx, void *native, const struct %s_proxy_class *klass);\n"
+                "\n",
+                DLPFX,
+                DLPFX, DLPFX,
+                DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_proxy_definition(FILE* outf)
+{
+        /* array index keys */
+        fprintf(outf,
+                "/* Indexed and named properties */\n"
+                "static duk_bool_t\n"
+                "%s_proxy_index(duk_context *ctx, duk_idx_t idx, duk_uint_t *index_out)\n"
+                "{\n"
+                "\tduk_double_t index = 0;\n"
+                "\tduk_size_t len;\n"
+                "\tduk_size_t pos;\n"
+                "\tconst char *str;\n"
+                "\tif (!duk_is_string(ctx, idx)) {\n"
+                "\t\treturn false;\n"
+                "\t}\n"
+                "\t/* canonical array index string */\n"
+                "\tstr = duk_get_lstring(ctx, idx, &len);\n"
+                "\tif ((len == 0) || (len > 10) || ((str[0] == '0') && (len > 1))) {\n"
+                "\t\treturn false;\n"
+                "\t}\n"
+                "\tfor (pos = 0; pos < len; pos++) {\n"
+                "\t\tif ((str[pos] < '0') || (str[pos] > '9')) {\n"
+                "\t\t\treturn false;\n"
+                "\t\t}\n"
+                "\t\tindex = (index * 10) + (str[pos] - '0');\n"
+                "\t}\n"
+                "\tif (index >= 4294967295.0) {\n"
+                "\t\treturn false;\n"
+                "\t}\n"
+                "\t*index_out = (duk_uint_t)index;\n"
+                "\treturn true;\n"
+                "}\n\n",
+                DLPFX);
+
+        /* property name keys */
+        fprintf(outf,
+                "static duk_bool_t %s_proxy_name(duk_context *ctx, duk_idx_t idx)\n"
+                "{\n"
+                "\tconst unsigned char *str;\n"
+                "\tif (!duk_is_string(ctx, idx)) {\n"
+                "\t\treturn false;\n"
+                "\t}\n"
+                "\t/* symbols are never named properties */\n"
+                "\tstr = (const unsigned char *)duk_get_string(ctx, idx);\n"
+                "\treturn !(((str[0] & 0xc0) == 0x80) || (str[0] == 0xff));\n"
+                "}\n\n",
+                DLPFX);
+
+        /* cached length */
+        fprintf(outf,
+                "static duk_uint_t %s_proxy_length(duk_context *ctx, void *native)\n"
+                "{\n"
+                "\tstruct %s_wrapper_entry *entry;\n"
+                "\tduk_uint_t length;\n"
+                "\tif ((native != NULL) && (%s_wrapper_table.used != 0)) {\n"
+                "\t\tentry = %s_wrapper_slot(native, %s_wrapper_heap(ctx));\n"
+                "\t\tif ((entry->native != NULL) &&\n"
+                "\t\t    (entry->length_generation == entry->generation)) {\n"
+                "\t\t\treturn entry->length;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tduk_get_prop_string(ctx, 0, \"length\");\n"
+                "\tlength = duk_get_uint(ctx, -1);\n"
+                "\tduk_pop(ctx);\n"
+                "\t/* the getter may have changed the table */\n"
+                "\tif ((native != NULL) && (%s_wrapper_table.used != 0)) {\n"
+                "\t\tentry = %s_wrapper_slot(native, %s_wrapper_heap(ctx));\n"
+                "\t\tif (entry->native != NULL) {\n"
+                "\t\t\tentry->length = length;\n"
+                "\t\t\tentry->length_generation = entry->generation;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\treturn length;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX,
+                DLPFX, DLPFX, DLPFX);
+
+        /* getter method call */
+        fprintf(outf,
+                "static duk_bool_t\n"
+                "%s_proxy_call(duk_context *ctx, const char *method)\n"
+                "{\n"
+                "\t/* ... argument */\n"
+                "\tduk_get_prop_string(ctx, 0, method);\n"
+                "\tduk_insert(ctx, -2);\n"
+                "\t/* the target is this so its private data is read directly */\n"
+                "\tduk_dup(ctx, 0);\n"
+                "\tduk_insert(ctx, -2);\n"
+                "\t/* ... method this argument */\n"
+                "\tduk_call_method(ctx, 1);\n"
+                "\t/* ... result */\n"
+                "\treturn !duk_is_null_or_undefined(ctx, -1);\n"
+                "}\n\n",
+                DLPFX);
+
+        /* get trap */
+        fprintf(outf,
+                "duk_ret_t\n"
+                "%s_proxy_get(duk_context *ctx, void *native, const struct %s_proxy_class *klass)\n"
+                "{\n"
+                "\tduk_uint_t index;\n"
+                "\t/* target key receiver */\n"
+                "\tif ((klass->indexed != NULL) && %s_proxy_index(ctx, 1, &index)) {\n"
+                "\t\tif (klass->length && (index >= %s_proxy_length(ctx, native))) {\n"
+                "\t\t\treturn 0;\n"
+                "\t\t}\n"
+                "\t\tduk_push_uint(ctx, index);\n"
+                "\t\treturn %s_proxy_call(ctx, klass->indexed) ? 1 : 0;\n"
+                "\t}\n"
+                "\tif ((klass->named != NULL) && %s_proxy_name(ctx, 1)) {\n"
+                "\t\t/* ordinary properties shadow named properties */\n"
+                "\t\tduk_dup(ctx, 1);\n"
+                "\t\tif (!duk_has_prop(ctx, 0)) {\n"
+                "\t\t\tduk_dup(ctx, 1);\n"
+                "\t\t\tduk_to_string(ctx, -1);\n"
+                "\t\t\treturn %s_proxy_call(ctx, klass->named) ? 1 : 0;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tduk_dup(ctx, 1);\n"
+                "\tduk_get_prop(ctx, 0);\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        /* has trap */
+        fprintf(outf,
+                "duk_ret_t\n"
+                "%s_proxy_has(duk_context *ctx, void *native, const struct %s_proxy_class *klass)\n"
+                "{\n"
+                "\tduk_uint_t index;\n"
+                "\tduk_bool_t found;\n"
+                "\t/* target key */\n"
+                "\tif ((klass->indexed != NULL) && %s_proxy_index(ctx, 1, &index)) {\n"
+                "\t\tif (klass->length) {\n"
+                "\t\t\tfound = (index < %s_proxy_length(ctx, native));\n"
+                "\t\t} else {\n"
+                "\t\t\tduk_push_uint(ctx, index);\n"
+                "\t\t\tfound = %s_proxy_call(ctx, klass->indexed);\n"
+                "\t\t}\n"
+                "\t} else {\n"
+                "\t\tduk_dup(ctx, 1);\n"
+                "\t\tfound = duk_has_prop(ctx, 0);\n"
+                "\t\tif (!found && (klass->named != NULL) && %s_proxy_name(ctx, 1)) {\n"
+                "\t\t\tduk_dup(ctx, 1);\n"
+                "\t\t\tduk_to_string(ctx, -1);\n"
+                "\t\t\tfound = %s_proxy_call(ctx, klass->named);\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\tduk_push_boolean(ctx, found);\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+bool
+interface_iterable(struct ir *ir,
+                   struct ir_entry *interfacee,
+                   struct ir_operation_entry **indexed_out)
+{
+        struct ir_iterable_entry *iterablee;
+        struct ir_operation_entry *indexed = NULL;
+        struct ir_attribute_entry *length = NULL;
+
+        if ((interfacee->type != IR_ENTRY_TYPE_INTERFACE) ||
+            (interfacee->u.interface.noobject)) {
+                return false;
+        }
+
+        iterablee = &interfacee->u.interface.iterable;
+        if (iterablee->type == IR_ITERABLE_NONE) {
+                return false;
+        }
+
+        /* value iterators without a binding method use the indexed
+         * properties up to the length
+         */
+        if ((iterablee->method == NULL) &&
+            (iterablee->type == IR_ITERABLE_VALUE)) {
+                interface_property_getters(ir, interfacee,
+                                           &indexed, NULL, &length);
+                if (length == NULL) {
+                        indexed = NULL;
+                }
+        }
+
+        if (indexed_out != NULL) {
+                *indexed_out = indexed;
+        }
+
+        return ((iterablee->method != NULL) || (indexed != NULL));
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_iterator_declaration(FILE* outf)
+{
+        fprintf(outf,
+                "/* Iteration of iterable, maplike and setlike interfaces */\n"
+                "enum %s_iterator_kind {\n"
+                "\tDUKKY_ITERATOR_KEYS,\n"
+                "\tDUKKY_ITERATOR_VALUES,\n"
+                "\tDUKKY_ITERATOR_ENTRIES,\n"
+                "};\n"
+                "typedef int (%s_iterator_step)(duk_context *ctx, duk_idx_t idx, void *priv, duk_uint_t cursor);\n"
+                "duk_ret_t %s_iterator_new(duk_context *ctx, %s_iterator_step *step, enum %s_iterator_kind kind);\n"
+                "duk_ret_t %s_iterator_foreach(duk_context *ctx, %s_iterator_step *step);\n"
+                "duk_ret_t %s_iterator___proto(duk_context *ctx, void *udata);\n"
+                "\n",
+                DLPFX,
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        return 0;
+}
+
+/* exported interface documented in duk-libdom.h */
+int output_iterator_definition(FILE* outf)
+{
+        /* iterator private data */
+        fprintf(outf,
+                "/* Iteration of iterable, maplike and setlike interfaces */\n"
+                "struct %s_iterator {\n"
+                "\t%s_iterator_step *step; /* NULL once exhausted */\n"
+                "\tvoid *priv; /* private data of the iterated object */\n"
+                "\tvoid *result; /* result object returned by every step */\n"
+                "\tduk_uint_t cursor;\n"
+                "\tenum %s_iterator_kind kind;\n"
+                "};\n\n",
+                DLPFX, DLPFX, DLPFX);
+
+        /* iterator creation */
+        fprintf(outf,
+                "duk_ret_t\n"
+                "%s_iterator_new(duk_context *ctx, %s_iterator_step *step, enum %s_iterator_kind kind)\n"
+                "{\n"
+                "\tstruct %s_iterator *iter;\n"
+                "\tvoid *priv;\n"
+                "\tduk_set_top(ctx, 0);\n"
+                "\tduk_push_this(ctx);\n"
+                "\tduk_get_prop_string(ctx, 0, %s_magic_string_private);\n"
+                "\tpriv = duk_get_pointer(ctx, -1);\n"
+                "\tduk_pop(ctx);\n"
+                "\tif (priv == NULL) return 0;\n"
+                "\titer = calloc(1, sizeof(*iter));\n"
+                "\tif (iter == NULL) return 0;\n"
+                "\titer->step = step;\n"
+                "\titer->priv = priv;\n"
+                "\titer->kind = kind;\n"
+                "\t/* iterated */\n"
+                "\tduk_push_object(ctx);\n"
+                "\tduk_get_global_string(ctx, \"%sITERATOR_PROTOTYPE\");\n"
+                "\tduk_set_prototype(ctx, 1);\n"
+                "\tduk_push_pointer(ctx, iter);\n"
+                "\tduk_put_prop_string(ctx, 1, %s_magic_string_private);\n"
+                "\t/* the iterator keeps the iterated object alive */\n"
+                "\tduk_dup(ctx, 0);\n"
+                "\tduk_put_prop_string(ctx, 1, \"%sITERATED\");\n"
+                "\t/* and the result object it reuses */\n"
+                "\tduk_push_object(ctx);\n"
+                "\tduk_push_boolean(ctx, false);\n"
+                "\tduk_put_prop_string(ctx, -2, \"done\");\n"
+                "\titer->result = duk_get_heapptr(ctx, -1);\n"
+                "\tduk_put_prop_string(ctx, 1, \"%sITERATOR_RESULT\");\n"
+                "\t/* iterated iterator */\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX,
+                MAGICPFX, DLPFX, MAGICPFX, MAGICPFX);
+
+        /* iterator next method */
+        fprintf(outf,
+                "static duk_ret_t %s_iterator_next(duk_context *ctx)\n"
+                "{\n"
+                "\tstruct %s_iterator *iter;\n"
+                "\tint count = 0;\n"
+                "\tduk_set_top(ctx, 0);\n"
+                "\tduk_push_this(ctx);\n"
+                "\tduk_get_prop_string(ctx, 0, %s_magic_string_private);\n"
+                "\titer = duk_get_pointer(ctx, -1);\n"
+                "\tduk_pop(ctx);\n"
+                "\tif (iter == NULL) return 0;\n"
+                "\t/* iterator */\n"
+                "\tduk_push_heapptr(ctx, iter->result);\n"
+                "\tduk_get_prop_string(ctx, 0, \"%sITERATED\");\n"
+                "\t/* iterator result iterated */\n"
+                "\tif (iter->step != NULL) {\n"
+                "\t\tcount = iter->step(ctx, 2, iter->priv, iter->cursor);\n"
+                "\t}\n"
+                "\tif (count == 0) {\n"
+                "\t\titer->step = NULL;\n"
+                "\t\tduk_set_top(ctx, 2);\n"
+                "\t\tduk_push_undefined(ctx);\n"
+                "\t\tduk_put_prop_string(ctx, 1, \"value\");\n"
+                "\t\tduk_push_boolean(ctx, true);\n"
+                "\t\tduk_put_prop_string(ctx, 1, \"done\");\n"
+                "\t\treturn 1;\n"
+                "\t}\n"
+                "\tif (count == 1) {\n"
+                "\t\t/* the key is the index */\n"
+                "\t\tduk_push_uint(ctx, iter->cursor);\n"
+                "\t\tduk_insert(ctx, -2);\n"
+                "\t}\n"
+                "\titer->cursor++;\n"
+                "\t/* iterator result iterated key value */\n"
+                "\tswitch (iter->kind) {\n"
+                "\tcase DUKKY_ITERATOR_KEYS:\n"
+                "\t\tduk_pop(ctx);\n"
+                "\t\tbreak;\n"
+                "\tcase DUKKY_ITERATOR_VALUES:\n"
+                "\t\tduk_remove(ctx, -2);\n"
+                "\t\tbreak;\n"
+                "\tcase DUKKY_ITERATOR_ENTRIES:\n"
+                "\t\tduk_push_array(ctx);\n"
+                "\t\tduk_insert(ctx, -3);\n"
+                "\t\tduk_put_prop_index(ctx, -3, 1);\n"
+                "\t\tduk_put_prop_index(ctx, -2, 0);\n"
+                "\t\tbreak;\n"
+                "\t}\n"
+                "\tduk_put_prop_string(ctx, 1, \"value\");\n"
+                "\tduk_set_top(ctx, 2);\n"
+                "\treturn 1;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, MAGICPFX);
+
+        /* forEach calls back directly without result objects */
+        fprintf(outf,
+                "duk_ret_t %s_iterator_foreach(duk_context *ctx, %s_iterator_step *step)\n"
+                "{\n"
+                "\tvoid *priv;\n"
+                "\tduk_uint_t cursor;\n"
+                "\tint count;\n"
+                "\tduk_set_top(ctx, 2);\n"
+                "\tif (!duk_is_function(ctx, 0)) {\n"
+                "\t\treturn duk_error(ctx, DUK_ERR_TYPE_ERROR, \"forEach callback is not a function\");\n"
+                "\t}\n"
+                "\tduk_push_this(ctx);\n"
+                "\tduk_get_prop_string(ctx, 2, %s_magic_string_private);\n"
+                "\tpriv = duk_get_pointer(ctx, -1);\n"
+                "\tduk_pop(ctx);\n"
+                "\tif (priv == NULL) return 0;\n"
+                "\t/* callback thisarg iterated */\n"
+                "\tfor (cursor = 0; ; cursor++) {\n"
+                "\t\tduk_dup(ctx, 0);\n"
+                "\t\tduk_dup(ctx, 1);\n"
+                "\t\tcount = step(ctx, 2, priv, cursor);\n"
+                "\t\tif (count == 0) {\n"
+                "\t\t\tduk_pop_2(ctx);\n"
+                "\t\t\tbreak;\n"
+                "\t\t}\n"
+                "\t\tif (count == 1) {\n"
+                "\t\t\tduk_push_uint(ctx, cursor);\n"
+                "\t\t} else {\n"
+                "\t\t\tduk_insert(ctx, -2);\n"
+                "\t\t}\n"
+                "\t\t/* ... callback thisarg value key */\n"
+                "\t\tduk_dup(ctx, 2);\n"
+                "\t\tduk_call_method(ctx, 3);\n"
+                "\t\tduk_pop(ctx);\n"
+                "\t}\n"
+                "\treturn 0;\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX);
+
+        /* iterator prototype */
+        fprintf(outf,
+                "static duk_ret_t %s_iterator_self(duk_context *ctx)\n"
+                "{\n"
+                "\tduk_push_this(ctx);\n"
+                "\treturn 1;\n"
+                "}\n\n"
+                "static duk_ret_t %s_iterator_finalizer(duk_context *ctx)\n"
+                "{\n"
+                "\tduk_get_prop_string(ctx, 0, %s_magic_string_private);\n"
+                "\tfree(duk_get_pointer(ctx, -1));\n"
+                "\treturn 0;\n"
+                "}\n\n"
+                "duk_ret_t %s_iterator___proto(duk_context *ctx, void *udata)\n"
+                "{\n"
+                "\tduk_push_c_function(ctx, %s_iterator_next, 0);\n"
+                "\tduk_put_prop_string(ctx, 0, \"next\");\n"
+                "\tduk_push_c_function(ctx, %s_iterator_self, 0);\n"
+                "\tduk_put_prop_string(ctx, 0, DUK_WELLKNOWN_SYMBOL(\"Symbol.iterator\"));\n"
+                "\tduk_push_c_function(ctx, %s_iterator_finalizer, 1);\n"
+                "\tduk_set_finalizer(ctx, 0);\n"
+                "\treturn 1; /* The prototype object */\n"
+                "}\n\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        return 0;
+}
@@ -37,26 +37,9 @@ get_member_default_str(struct ir_entry *dictionarye,
                        enum webidl_type member_type,
                        char **defl_out)
 {
-        struct webidl_node *lit_node;
-        enum webidl_node_type lit_type;
-        int *lit_int;
-        float *lit_flt;
-
-        lit_node = webidl_node_getnode(
-                webidl_node_find_type(
-                        webidl_node_getnode(membere->node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_OPTIONAL));
-        if (lit_node == NULL) {
-                *defl_out = NULL;
-                return 0;
-        }
-
-        lit_type = webidl_node_gettype(lit_node);
+        switch (membere->defl.type) {
 
-        switch (lit_type) {
-
-        case WEBIDL_NODE_TYPE_LITERAL_BOOL:
+        case IR_DEFAULT_BOOL:
                 if (member_type != WEBIDL_TYPE_BOOL) {
                         fprintf(stderr,
                                 "Dictionary %s:%s literal boolean type mismatch\n",
@@ -64,32 +47,29 @@ get_member_default_str(struct ir_entry *dictionarye,
                                 membere->name);
                         return -1;
                 }
-                lit_int = webidl_node_getint(lit_node);
-                if (*lit_int == 0) {
+                if (membere->defl.intval == 0) {
                         *defl_out = strdup("false");
                 } else {
                         *defl_out = strdup("true");
                 }
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_NULL:
+        case IR_DEFAULT_NULL:
                 *defl_out = strdup("NULL");
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_STRING:
-                *defl_out = strdup(webidl_node_gettext(lit_node));
+        case IR_DEFAULT_STRING:
+                *defl_out = strdup(membere->defl.text);
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_INT:
-                lit_int = webidl_node_getint(lit_node);
+        case IR_DEFAULT_INT:
                 *defl_out = malloc(128);
-                snprintf(*defl_out, 128, "%d", *lit_int);
+                snprintf(*defl_out, 128, "%d", membere->defl.intval);
                 break;
 
-        case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
-                lit_flt = webidl_node_getfloat(lit_node);
+        case IR_DEFAULT_FLOAT:
                 *defl_out = malloc(128);
-                snprintf(*defl_out, 128, "%f", *lit_flt);
+                snprintf(*defl_out, 128, "%f", membere->defl.fltval);
                 break;
 
         default:
@@ -108,44 +88,26 @@ output_member_acessor(FILE* outf,
                       struct ir_entry *dictionarye,
                       struct ir_operation_argument_entry *membere)
 {
-        struct webidl_node *type_node;
-        enum webidl_type *argument_type;
+        enum webidl_type argument_type;
         char *defl; /* default for member */
         int res;
 
-        type_node = webidl_node_find_type(
-                webidl_node_getnode(membere->node),
-                NULL,
-                WEBIDL_NODE_TYPE_TYPE);
-
-        if (type_node == NULL) {
+        if (membere->typec == 0) {
                 fprintf(stderr, "%s:%s has no type\n",
                         dictionarye->name,
                         membere->name);
                 return -1;
         }
 
-        argument_type = (enum webidl_type *)webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_BASE));
-
-        if (argument_type == NULL) {
-                fprintf(stderr,
-                        "%s:%s has no type base\n",
-                        dictionarye->name,
-                        membere->name);
-                return -1;
-        }
+        argument_type = membere->typev[0].base;
 
         /* get default text */
-        res = get_member_default_str(dictionarye, membere, *argument_type, &defl);
+        res = get_member_default_str(dictionarye, membere, argument_type, &defl);
         if (res != 0) {
                 return res;
         }
 
-        switch (*argument_type) {
+        switch (argument_type) {
 
         case WEBIDL_TYPE_STRING:
                 fprintf(outf,
@@ -270,12 +232,12 @@ output_member_acessor(FILE* outf,
                         "Dictionary %s:%s unhandled type (%d)",
                         dictionarye->name,
                         membere->name,
-                        *argument_type);
+                        argument_type);
                 fprintf(outf,
                         "/* Dictionary %s:%s unhandled type (%d) */\n\n",
                         dictionarye->name,
                         membere->name,
-                        *argument_type);
+                        argument_type);
         }
 
         if (defl != NULL) {
@@ -333,7 +295,7 @@ int output_dictionary(struct ir *ir, struct ir_entry *dictionarye)
                             GENBIND_METHOD_TYPE_PREFACE);
 
         /* tool prologue */
-        output_tool_prologue(ifacef);
+        output_tool_prologue(ifacef, dictionarye);
 
         /* binding prologue */
         output_method_cdata(ifacef,
@@ -389,37 +351,18 @@ output_member_declaration(FILE* outf,
                       struct ir_entry *dictionarye,
                       struct ir_operation_argument_entry *membere)
 {
-        struct webidl_node *type_node;
-        enum webidl_type *argument_type;
-
-        type_node = webidl_node_find_type(
-                webidl_node_getnode(membere->node),
-                NULL,
-                WEBIDL_NODE_TYPE_TYPE);
+        enum webidl_type argument_type;
 
-        if (type_node == NULL) {
+        if (membere->typec == 0) {
                 fprintf(stderr, "%s:%s has no type\n",
                         dictionarye->name,
                         membere->name);
                 return -1;
         }
 
-        argument_type = (enum webidl_type *)webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_BASE));
-
-        if (argument_type == NULL) {
-                fprintf(stderr,
-                        "%s:%s has no type base\n",
-                        dictionarye->name,
-                        membere->name);
-                return -1;
-        }
-
+        argument_type = membere->typev[0].base;
 
-        switch (*argument_type) {
+        switch (argument_type) {
 
         case WEBIDL_TYPE_STRING:
                 fprintf(outf,
@@ -453,7 +396,7 @@ output_member_declaration(FILE* outf,
                         "/* Dictionary %s:%s unhandled type (%d) */\n",
                         dictionarye->name,
                         membere->name,
-                        *argument_type);
+                        argument_type);
         }
 
         return 0;
@@ -0,0 +1,303 @@
+/* duktape binding generation implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "options.h"
+#include "utils.h"
+#include "nsgenbind-ast.h"
+#include "webidl-ast.h"
+#include "ir.h"
+#include "duk-libdom.h"
+
+/** prefix for all generated functions */
+#define DLPFX "dukky"
+
+/** FNV-1a prime used by the generated string hash */
+#define ENUM_HASH_PRIME 16777619U
+
+/** FNV-1a offset basis, the first seed tried for a perfect hash */
+#define ENUM_HASH_BASIS 2166136261U
+
+/** number of seeds tried at each table size */
+#define ENUM_HASH_SEEDS 4096
+
+/** largest hash table generated */
+#define ENUM_HASH_MAX_SIZE 65536
+
+/**
+ * string hash matching the one in the generated conversion function
+ *
+ * The high bits are folded in as the multiply only carries changes in
+ * the seed and characters upwards.
+ */
+static unsigned int enumeration_hash(unsigned int seed, const char *str)
+{
+        unsigned int hash = seed;
+
+        while (*str != 0) {
+                hash = (hash ^ (unsigned char)*str++) * ENUM_HASH_PRIME;
+        }
+        return hash ^ (hash >> 16);
+}
+
+/**
+ * find a perfect hash for the values of an enumeration
+ *
+ * The smallest power of two table, and within it the first seed, where
+ * every value hashes to a different slot is used.
+ *
+ * \param enumeratione The enumeration to hash.
+ * \param seed_out Updated with the hash seed.
+ * \param size_out Updated with the table size.
+ * \return The table mapping slots to value indexes or -1 for empty
+ *         slots or NULL if no perfect hash was found.
+ */
+static int *
+enumeration_perfect_hash(struct ir_enumeration_entry *enumeratione,
+                         unsigned int *seed_out,
+                         unsigned int *size_out)
+{
+        unsigned int size;
+        unsigned int seed;
+        unsigned int slot;
+        int *table;
+        int vidx;
+
+        size = 1;
+        while (size < (unsigned int)enumeratione->valuec) {
+                size *= 2;
+        }
+
+        for (; size <= ENUM_HASH_MAX_SIZE; size *= 2) {
+                table = malloc(size * sizeof(int));
+                if (table == NULL) {
+                        return NULL;
+                }
+
+                for (seed = ENUM_HASH_BASIS;
+                     seed < ENUM_HASH_BASIS + ENUM_HASH_SEEDS;
+                     seed++) {
+                        memset(table, 0xff, size * sizeof(int));
+
+                        for (vidx = 0; vidx < enumeratione->valuec; vidx++) {
+                                slot = enumeration_hash(seed,
+                                                enumeratione->valuev[vidx]);
+                                slot &= size - 1;
+                                if (table[slot] != -1) {
+                                        break;
+                                }
+                                table[slot] = vidx;
+                        }
+
+                        if (vidx == enumeratione->valuec) {
+                                *seed_out = seed;
+                                *size_out = size;
+                                return table;
+                        }
+                }
+                free(table);
+        }
+
+        return NULL;
+}
+
+/* exported function documented in duk-libdom.h */
+int
+output_enumeration_value_name(FILE* outf,
+                              struct ir_enumeration_entry *enumeratione,
+                              int vidx)
+{
+        const char *value;
+        const char *prev;
+        const char *a;
+        const char *b;
+        int pidx;
+
+        value = enumeratione->valuev[vidx];
+
+        for (a = DLPFX; *a != 0; a++) {
+                fputc(toupper((unsigned char)*a), outf);
+        }
+        fprintf(outf, "_");
+        for (a = enumeratione->class_name; *a != 0; a++) {
+                fputc(toupper((unsigned char)*a), outf);
+        }
+        fprintf(outf, "_");
+
+        if (*value == 0) {
+                fprintf(outf, "EMPTY");
+        } else {
+                for (a = value; *a != 0; a++) {
+                        if (isalnum((unsigned char)*a)) {
+                                fputc(toupper((unsigned char)*a), outf);
+                        } else {
+                                fputc('_', outf);
+                        }
+                }
+        }
+
+        /* check for an earlier value with the same identifier */
+        for (pidx = 0; pidx < vidx; pidx++) {
+                prev = enumeratione->valuev[pidx];
+                if ((*value == 0) || (*prev == 0)) {
+                        continue;
+                }
+                for (a = value, b = prev; (*a != 0) && (*b != 0); a++, b++) {
+                        if ((isalnum((unsigned char)*a) ?
+                             toupper((unsigned char)*a) : '_') !=
+                            (isalnum((unsigned char)*b) ?
+                             toupper((unsigned char)*b) : '_')) {
+                                break;
+                        }
+                }
+                if ((*a == 0) && (*b == 0)) {
+                        fprintf(outf, "_%d", vidx);
+                        break;
+                }
+        }
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int
+output_enumeration_declaration(FILE* outf,
+                               struct ir_enumeration_entry *enumeratione)
+{
+        int vidx;
+
+        fprintf(outf, "/* %s enumeration */\n", enumeratione->name);
+
+        fprintf(outf, "enum %s_%s {\n", DLPFX, enumeratione->class_name);
+        for (vidx = 0; vidx < enumeratione->valuec; vidx++) {
+                fprintf(outf, "\t");
+                output_enumeration_value_name(outf, enumeratione, vidx);
+                fprintf(outf, " = %d, /* ", vidx);
+                output_cstring(outf, enumeratione->valuev[vidx]);
+                fprintf(outf, " */\n");
+        }
+        fprintf(outf, "};\n");
+
+        fprintf(outf,
+                "int %s_%s_from_string(const char *str, size_t len);\n",
+                DLPFX, enumeratione->class_name);
+        fprintf(outf,
+                "const char *%s_%s_to_string(enum %s_%s value);\n\n",
+                DLPFX, enumeratione->class_name,
+                DLPFX, enumeratione->class_name);
+
+        return 0;
+}
+
+/* exported function documented in duk-libdom.h */
+int
+output_enumeration_definition(FILE* outf,
+                              struct ir_enumeration_entry *enumeratione)
+{
+        unsigned int seed;
+        unsigned int size;
+        unsigned int slot;
+        int *table;
+        int vidx;
+
+        table = enumeration_perfect_hash(enumeratione, &seed, &size);
+        if (table == NULL) {
+                fprintf(stderr,
+                        "Error: unable to hash values of enumeration %s\n",
+                        enumeratione->name);
+                return -1;
+        }
+
+        /* value strings with their lengths */
+        fprintf(outf,
+                "/* %s enumeration values */\n"
+                "static const struct %s_enum_value %s_%s_values[%d] = {\n",
+                enumeratione->name,
+                DLPFX, DLPFX, enumeratione->class_name,
+                enumeratione->valuec);
+        for (vidx = 0; vidx < enumeratione->valuec; vidx++) {
+                fprintf(outf, "\t{ ");
+                output_cstring(outf, enumeratione->valuev[vidx]);
+                fprintf(outf, ", %d },\n",
+                        (int)strlen(enumeratione->valuev[vidx]));
+        }
+        fprintf(outf, "};\n\n");
+
+        /* string to value through the perfect hash */
+        fprintf(outf,
+                "int\n"
+                "%s_%s_from_string(const char *str, size_t len)\n"
+                "{\n",
+                DLPFX, enumeratione->class_name);
+        fprintf(outf,
+                "\tstatic const %s table[%u] = {",
+                (enumeratione->valuec < 128) ? "signed char" : "short",
+                size);
+        for (slot = 0; slot < size; slot++) {
+                if ((slot % 16) == 0) {
+                        fprintf(outf, "\n\t\t");
+                } else {
+                        fprintf(outf, " ");
+                }
+                fprintf(outf, "%d,", table[slot]);
+        }
+        fprintf(outf, "\n\t};\n");
+        free(table);
+
+        fprintf(outf,
+                "\tconst struct %s_enum_value *value;\n"
+                "\tunsigned int hash = 0x%08xU;\n"
+                "\tsize_t idx;\n"
+                "\tint res;\n"
+                "\n"
+                "\tfor (idx = 0; idx < len; idx++) {\n"
+                "\t\thash = (hash ^ (unsigned char)str[idx]) * %uU;\n"
+                "\t}\n"
+                "\tres = table[(hash ^ (hash >> 16)) & 0x%x];\n"
+                "\tif (res < 0) {\n"
+                "\t\treturn -1;\n"
+                "\t}\n"
+                "\tvalue = &%s_%s_values[res];\n"
+                "\tif (value->len != len) {\n"
+                "\t\treturn -1;\n"
+                "\t}\n"
+                "\tfor (idx = 0; idx < len; idx++) {\n"
+                "\t\tif (value->str[idx] != str[idx]) {\n"
+                "\t\t\treturn -1;\n"
+                "\t\t}\n"
+                "\t}\n"
+                "\treturn res;\n"
+                "}\n\n",
+                DLPFX,
+                seed,
+                ENUM_HASH_PRIME,
+                size - 1,
+                DLPFX, enumeratione->class_name);
+
+        /* value to interned string */
+        fprintf(outf,
+                "const char *\n"
+                "%s_%s_to_string(enum %s_%s value)\n"
+                "{\n"
+                "\tif ((unsigned int)value >= %d) {\n"
+                "\t\treturn NULL;\n"
+                "\t}\n"
+                "\treturn %s_%s_values[value].str;\n"
+                "}\n\n",
+                DLPFX, enumeratione->class_name,
+                DLPFX, enumeratione->class_name,
+                enumeratione->valuec,
+                DLPFX, enumeratione->class_name);
+
+        return 0;
+}
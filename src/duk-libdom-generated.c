@@ -28,6 +28,115 @@
 #include "ir.h"
 #include "duk-libdom.h"
 
+/** prefix for all generated functions */
+#define DLPFX "dukky"
+
+/* exported function documented in duk-libdom.h */
+bool attribute_is_event_handler(struct ir_attribute_entry *atributee)
+{
+        /* this can generate for onxxx event handlers */
+        return ((!atributee->pruned) &&
+                (atributee->typec == 1) &&
+                (atributee->typev[0].base == WEBIDL_TYPE_USER) &&
+                (atributee->typev[0].name != NULL) &&
+                (strcmp(atributee->typev[0].name, "EventHandler") == 0) &&
+                (atributee->name[0] == 'o') &&
+                (atributee->name[1] == 'n') &&
+                (atributee->name[2] != 0));
+}
+
+static int compare_event_name(const void *a, const void *b)
+{
+        return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+/* exported function documented in duk-libdom.h */
+int event_handler_slots_new(struct ir *ir)
+{
+        struct ir_enumeration_entry *slots = &ir->event_handlers;
+        struct ir_attribute_entry *atributee;
+        struct ir_entry *entry;
+        int idx;
+        int attrc;
+        int namec = 0;
+
+        /* replace any slots from earlier output */
+        free(slots->valuev);
+        free(slots->class_name);
+        memset(slots, 0, sizeof(*slots));
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+                if (entry->type != IR_ENTRY_TYPE_INTERFACE) {
+                        continue;
+                }
+                for (attrc = 0; attrc < entry->u.interface.attributec; attrc++) {
+                        if (attribute_is_event_handler(
+                                    entry->u.interface.attributev + attrc)) {
+                                namec++;
+                        }
+                }
+        }
+        if (namec == 0) {
+                return 0;
+        }
+
+        slots->valuev = calloc(namec, sizeof(char *));
+        if (slots->valuev == NULL) {
+                return -1;
+        }
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+                if (entry->type != IR_ENTRY_TYPE_INTERFACE) {
+                        continue;
+                }
+                for (attrc = 0; attrc < entry->u.interface.attributec; attrc++) {
+                        atributee = entry->u.interface.attributev + attrc;
+                        if (attribute_is_event_handler(atributee)) {
+                                slots->valuev[slots->valuec++] =
+                                        atributee->name + 2;
+                        }
+                }
+        }
+
+        /* one slot per event name whichever interfaces it appears on */
+        qsort(slots->valuev, slots->valuec, sizeof(char *),
+              compare_event_name);
+        namec = 1;
+        for (idx = 1; idx < slots->valuec; idx++) {
+                if (strcmp(slots->valuev[namec - 1],
+                           slots->valuev[idx]) != 0) {
+                        slots->valuev[namec++] = slots->valuev[idx];
+                }
+        }
+        slots->valuec = namec;
+
+        slots->name = "EventHandler";
+        slots->class_name = gen_idl2c_name(slots->name);
+
+        return 0;
+}
+
+/**
+ * output the slot constant of an event handler attribute
+ */
+static int
+output_event_handler_slot(FILE* outf, struct ir_attribute_entry *atributee)
+{
+        const char *a;
+
+        fprintf(outf, "DUKKY_EVENT_HANDLER_");
+        for (a = atributee->name + 2; *a != 0; a++) {
+                if (isalnum((unsigned char)*a)) {
+                        fputc(toupper((unsigned char)*a), outf);
+                } else {
+                        fputc('_', outf);
+                }
+        }
+        return 0;
+}
+
 static int
 output_generated_attribute_user_getter(FILE* outf,
                                   struct ir_entry *interfacee,
@@ -35,15 +144,17 @@ output_generated_attribute_user_getter(FILE* outf,
 {
         UNUSED(interfacee);
 
-        if ((atributee->typev[0].name != NULL) &&
-            strcmp(atributee->typev[0].name, "EventHandler") == 0) {
-
-                /* this can generate for onxxx event handlers */
-                if ((atributee->name[0] != 'o') ||
-                    (atributee->name[1] != 'n')) {
-                        return -1; /* not onxxx */
-                }
+        if (attribute_is_event_handler(atributee)) {
+                /* a handler set from script is read from its slot */
+                fprintf(outf, "\tif (%s_event_handler_push(ctx, priv, ", DLPFX);
+                output_event_handler_slot(outf, atributee);
+                fprintf(outf,
+                        ")) {\n"
+                        "\t\treturn 1;\n"
+                        "\t}\n"
+                        "\tduk_pop(ctx);\n\n");
 
+                /* otherwise it may come from a content attribute */
                 fprintf(outf,
                         "\tdom_event_target *et = (dom_event_target *)(((node_private_t *)priv)->node);\n"
                         "\tdom_string *name;\n"
@@ -210,15 +321,10 @@ output_generated_attribute_user_setter(FILE* outf,
 {
         UNUSED(interfacee);
 
-        if ((atributee->typev[0].name != NULL) &&
-            strcmp(atributee->typev[0].name, "EventHandler") == 0) {
-
-                /* this can generate for onxxx event handlers */
-                if ((atributee->name[0] != 'o') ||
-                    (atributee->name[1] != 'n')) {
-                        return -1; /* not onxxx */
-                }
-
+        if (attribute_is_event_handler(atributee)) {
+                /* the handlers table is kept for content attribute
+                 * handlers and the value also stored in its slot
+                 */
                 fprintf(outf,
                         "\t/* handlerfn */\n"
                         "\tduk_push_this(ctx);\n"
@@ -231,14 +337,21 @@ output_generated_attribute_user_setter(FILE* outf,
                         "\t/* handlerfn this handlers %s handlerfn */\n"
                         "\tduk_put_prop(ctx, -3);\n"
                         "\t/* handlerfn this handlers */\n"
-                        "\tdukky_register_event_listener_for(ctx,\n"
-                        "\t\t(dom_element *)((node_private_t *)priv)->node,\n"
-                        "\t\tcorestring_dom_%s, false);\n"
-                        "\treturn 0;\n",
+                        "\tif (!%s_event_handler_set(ctx, priv, -2, ",
                         atributee->name + 2,
                         strlen(atributee->name + 2),
                         atributee->name + 2,
                         atributee->name + 2,
+                        DLPFX);
+                output_event_handler_slot(outf, atributee);
+                fprintf(outf,
+                        ", 0)) {\n"
+                        "\t\treturn duk_error(ctx, DUK_ERR_RANGE_ERROR, \"alloc failed\");\n"
+                        "\t}\n"
+                        "\tdukky_register_event_listener_for(ctx,\n"
+                        "\t\t(dom_element *)((node_private_t *)priv)->node,\n"
+                        "\t\tcorestring_dom_%s, false);\n"
+                        "\treturn 0;\n",
                         atributee->name + 2);
                 return 0;
         }
@@ -21,6 +21,7 @@
 #include "webidl-ast.h"
 #include "ir.h"
 #include "duk-libdom.h"
+#include "report.h"
 
 /** prefix for all generated functions */
 #define DLPFX "dukky"
@@ -163,13 +164,19 @@ output_dump_stack(FILE* outf)
 static int
 output_add_method(FILE* outf,
                   const char *class_name,
-                  const char *method)
+                  const char *method,
+                  bool pruned)
 {
         fprintf(outf, "\t/* Add a method */\n");
         fprintf(outf, "\tduk_dup(ctx, 0);\n");
         fprintf(outf, "\tduk_push_string(ctx, \"%s\");\n", method);
-        fprintf(outf, "\tduk_push_c_function(ctx, %s_%s_%s, DUK_VARARGS);\n",
-                DLPFX, class_name, method);
+        if (pruned) {
+                fprintf(outf, "\tduk_push_c_function(ctx, %s_pruned_stub, DUK_VARARGS);\n",
+                        DLPFX);
+        } else {
+                fprintf(outf, "\tduk_push_c_function(ctx, %s_%s_%s, DUK_VARARGS);\n",
+                        DLPFX, class_name, method);
+        }
         output_dump_stack(outf);
         fprintf(outf, "\tduk_def_prop(ctx, -3,\n");
         fprintf(outf, "\t             DUK_DEFPROP_HAVE_VALUE |\n");
@@ -204,6 +211,31 @@ output_populate_rw_property(FILE* outf, const char *class_name, const char *prop
         return 0;
 }
 
+/**
+ * Generate source to populate a pruned property on a prototype
+ *
+ * Getting or setting the property calls the shared stub which throws.
+ */
+static int
+output_populate_pruned_property(FILE* outf, const char *property)
+{
+        fprintf(outf, "\t/* Add pruned property */\n");
+        fprintf(outf, "\tduk_dup(ctx, 0);\n");
+        fprintf(outf, "\tduk_push_string(ctx, \"%s\");\n", property);
+        fprintf(outf, "\tduk_push_c_function(ctx, %s_pruned_stub, 0);\n",
+                DLPFX);
+        fprintf(outf, "\tduk_push_c_function(ctx, %s_pruned_stub, 1);\n",
+                DLPFX);
+        output_dump_stack(outf);
+        fprintf(outf, "\tduk_def_prop(ctx, -4, DUK_DEFPROP_HAVE_GETTER |\n");
+        fprintf(outf, "\t\tDUK_DEFPROP_HAVE_SETTER |\n");
+        fprintf(outf, "\t\tDUK_DEFPROP_HAVE_ENUMERABLE | DUK_DEFPROP_ENUMERABLE |\n");
+        fprintf(outf, "\t\tDUK_DEFPROP_HAVE_CONFIGURABLE);\n");
+        fprintf(outf, "\tduk_pop(ctx);\n\n");
+
+        return 0;
+}
+
 /**
  * Generate source to populate a readonly property on a prototype
  */
@@ -264,20 +296,268 @@ output_get_method_private(FILE* outf, char *class_name)
 }
 
 
+/**
+ * output the private member holding the wrapper cache key
+ *
+ * The key is held in the private data of the root class of the
+ * inheritance chain.
+ */
+static int
+output_wrapped_member(FILE* outf, struct ir *ir, struct ir_entry *interfacee)
+{
+        fprintf(outf, "priv->");
+        while ((interfacee = ir_inherit_entry(ir, interfacee)) != NULL) {
+                fprintf(outf, "parent.");
+        }
+        fprintf(outf, "%s_wrapped", DLPFX);
+
+        return 0;
+}
+
+/**
+ * generate the proxy traps for indexed and named properties
+ *
+ * The traps pass the getters found for the interface to the generic
+ *  implementation in the binding. The native object is only passed
+ *  when the length attribute is [Pure] which allows the length to be
+ *  cached until the object is invalidated.
+ */
+static int
+output_interface_proxy(FILE* outf, struct ir *ir, struct ir_entry *interfacee)
+{
+        struct ir_operation_entry *indexed;
+        struct ir_operation_entry *named;
+        struct ir_attribute_entry *length;
+        bool cached;
+
+        if (!interface_property_getters(ir, interfacee,
+                                        &indexed, &named, &length)) {
+                return 0;
+        }
+
+        cached = ((indexed != NULL) &&
+                  (length != NULL) &&
+                  (length->cache == IR_ATTRIBUTE_CACHE_GENERATION));
+
+        fprintf(outf,
+                "static const struct %s_proxy_class %s_%s___proxy = {\n",
+                DLPFX, DLPFX, interfacee->class_name);
+        if (indexed != NULL) {
+                fprintf(outf, "\t\"%s\", /* indexed */\n", indexed->name);
+        } else {
+                fprintf(outf, "\tNULL, /* indexed */\n");
+        }
+        if (named != NULL) {
+                fprintf(outf, "\t\"%s\", /* named */\n", named->name);
+        } else {
+                fprintf(outf, "\tNULL, /* named */\n");
+        }
+        fprintf(outf, "\t%d, /* length */\n", (length != NULL) ? 1 : 0);
+        fprintf(outf, "};\n\n");
+
+        /* get and has traps */
+        fprintf(outf,
+                "static duk_ret_t %s_%s___proxy_get(duk_context *ctx)\n"
+                "{\n",
+                DLPFX, interfacee->class_name);
+        if (cached) {
+                output_safe_get_private(outf, interfacee->class_name, 0);
+                fprintf(outf, "\treturn %s_proxy_get(ctx, ", DLPFX);
+                output_wrapped_member(outf, ir, interfacee);
+        } else {
+                fprintf(outf, "\treturn %s_proxy_get(ctx, NULL", DLPFX);
+        }
+        fprintf(outf, ", &%s_%s___proxy);\n"
+                "}\n\n",
+                DLPFX, interfacee->class_name);
+
+        fprintf(outf,
+                "static duk_ret_t %s_%s___proxy_has(duk_context *ctx)\n"
+                "{\n",
+                DLPFX, interfacee->class_name);
+        if (cached) {
+                output_safe_get_private(outf, interfacee->class_name, 0);
+                fprintf(outf, "\treturn %s_proxy_has(ctx, ", DLPFX);
+                output_wrapped_member(outf, ir, interfacee);
+        } else {
+                fprintf(outf, "\treturn %s_proxy_has(ctx, NULL", DLPFX);
+        }
+        fprintf(outf, ", &%s_%s___proxy);\n"
+                "}\n\n",
+                DLPFX, interfacee->class_name);
+
+        return 0;
+}
+
+/** iteration methods with the kind of iterator each creates */
+static const struct {
+        const char *name;
+        const char *kind;
+} iterable_methods[] = {
+        { "entries", "DUKKY_ITERATOR_ENTRIES" },
+        { "keys", "DUKKY_ITERATOR_KEYS" },
+        { "values", "DUKKY_ITERATOR_VALUES" },
+        { "forEach", NULL },
+};
+
+/**
+ * check if an interface operation would clash with an iteration method
+ */
+static bool
+interface_has_operation(struct ir_entry *interfacee, const char *name)
+{
+        int opc;
+
+        for (opc = 0; opc < interfacee->u.interface.operationc; opc++) {
+                if ((interfacee->u.interface.operationv[opc].name != NULL) &&
+                    (strcmp(interfacee->u.interface.operationv[opc].name,
+                            name) == 0)) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/**
+ * generate the iteration methods of an iterable, maplike or setlike
+ *  interface
+ *
+ * The binding method named after the declaration is the step function
+ *  called with priv and the cursor. It pushes the key and value, or
+ *  only the value of a value iterator whose keys are the indexes, and
+ *  returns the number of values pushed or 0 once the cursor is past the
+ *  end. The cursor is kept in the native iterator so a step allocates
+ *  nothing itself.
+ */
+static int
+output_interface_iterable(FILE* outf,
+                          struct ir *ir,
+                          struct ir_entry *interfacee)
+{
+        struct ir_iterable_entry *iterablee;
+        struct ir_operation_entry *indexed;
+        unsigned int midx;
+        int cdatac;
+
+        iterablee = &interfacee->u.interface.iterable;
+        if (iterablee->type == IR_ITERABLE_NONE) {
+                return 0;
+        }
+
+        if ((iterablee->type == IR_ITERABLE_MAPLIKE) ||
+            (iterablee->type == IR_ITERABLE_SETLIKE)) {
+                WARN(WARNING_UNIMPLEMENTED,
+                     "Unimplemented: %s %s members other than iteration",
+                     interfacee->name, iterablee->method_name);
+        }
+
+        if (!interface_iterable(ir, interfacee, &indexed)) {
+                WARN(WARNING_UNIMPLEMENTED,
+                     "Unimplemented: method %s::%s();",
+                     interfacee->name, iterablee->method_name);
+                return 0;
+        }
+
+        /* step function */
+        fprintf(outf,
+                "static int\n"
+                "%s_%s___iterate(duk_context *ctx, duk_idx_t idx, void *iter_priv, duk_uint_t cursor)\n"
+                "{\n",
+                DLPFX, interfacee->class_name);
+
+        if (indexed != NULL) {
+                fprintf(outf,
+                        "\t(void)iter_priv;\n"
+                        "\t/* indexed properties up to the length */\n"
+                        "\tduk_get_prop_string(ctx, idx, \"length\");\n"
+                        "\tif (cursor >= duk_get_uint(ctx, -1)) {\n"
+                        "\t\tduk_pop(ctx);\n"
+                        "\t\treturn 0;\n"
+                        "\t}\n"
+                        "\tduk_pop(ctx);\n"
+                        "\tduk_get_prop_string(ctx, idx, \"%s\");\n"
+                        "\tduk_dup(ctx, idx);\n"
+                        "\tduk_push_uint(ctx, cursor);\n"
+                        "\tduk_call_method(ctx, 1);\n"
+                        "\treturn 1;\n",
+                        indexed->name);
+        } else {
+                fprintf(outf,
+                        "\t%s_private_t *priv = iter_priv;\n"
+                        "\t(void)priv;\n",
+                        interfacee->class_name);
+                cdatac = output_ccode(outf, iterablee->method);
+                if (cdatac == 0) {
+                        fprintf(outf, "\treturn 0;\n");
+                }
+        }
+        fprintf(outf, "}\n\n");
+
+        /* iteration methods */
+        for (midx = 0;
+             midx < sizeof(iterable_methods) / sizeof(iterable_methods[0]);
+             midx++) {
+                if (interface_has_operation(interfacee,
+                                            iterable_methods[midx].name)) {
+                        WARN(WARNING_DUPLICATED,
+                             "%s::%s operation hides the iteration method",
+                             interfacee->name, iterable_methods[midx].name);
+                        continue;
+                }
+
+                output_profile_placement(outf, ir, interfacee,
+                                         iterable_methods[midx].name,
+                                         "method");
+                fprintf(outf,
+                        "static duk_ret_t %s_%s_%s(duk_context *ctx)\n"
+                        "{\n",
+                        DLPFX, interfacee->class_name,
+                        iterable_methods[midx].name);
+                output_profile_counter(outf, interfacee,
+                                       iterable_methods[midx].name,
+                                       "method");
+                report_member(REPORT_MEMBER_METHOD, REPORT_IMPL_GENERATED);
+                if (iterable_methods[midx].kind != NULL) {
+                        fprintf(outf,
+                                "\treturn %s_iterator_new(ctx, %s_%s___iterate, %s);\n",
+                                DLPFX, DLPFX, interfacee->class_name,
+                                iterable_methods[midx].kind);
+                } else {
+                        fprintf(outf,
+                                "\treturn %s_iterator_foreach(ctx, %s_%s___iterate);\n",
+                                DLPFX, DLPFX, interfacee->class_name);
+                }
+                fprintf(outf, "}\n\n");
+        }
+
+        return 0;
+}
+
 /**
  * generate the interface constructor
+ *
+ * The first initialisor parameter is the native object the new object
+ *  wraps and is entered in the wrapper cache. If the cache cannot grow
+ *  the same error duktape raises when it runs out of memory is thrown.
+ *  Instances of interfaces with indexed or named properties are
+ *  returned wrapped in a proxy which the instance keeps alive.
  */
 static int
-output_interface_constructor(FILE* outf, struct ir_entry *interfacee)
+output_interface_constructor(FILE* outf,
+                             struct ir *ir,
+                             struct ir_entry *interfacee)
 {
         int init_argc;
 
         /* constructor definition */
+        output_profile_placement(outf, ir, interfacee, NULL, "constructor");
         fprintf(outf,
                 "static duk_ret_t %s_%s___constructor(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name);
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, NULL, "constructor");
+
         output_create_private(outf, interfacee->class_name);
 
         /* generate call to initialisor */
@@ -291,8 +571,43 @@ output_interface_constructor(FILE* outf, struct ir_entry *interfacee)
         }
         fprintf(outf, ");\n");
 
+        if (interfacee->class_init_argc > 0) {
+                fprintf(outf, "\t");
+                output_wrapped_member(outf, ir, interfacee);
+                fprintf(outf, " = duk_get_pointer(ctx, 1);\n");
+        }
 
         fprintf(outf, "\tduk_set_top(ctx, 1);\n");
+
+        if (interface_property_getters(ir, interfacee, NULL, NULL, NULL)) {
+                /* the proxy is returned in place of the instance */
+                fprintf(outf,
+                        "\n"
+                        "\t/* proxy for indexed and named properties */\n"
+                        "\tduk_dup(ctx, 0);\n"
+                        "\tduk_get_prop_string(ctx, 0, \"%sPROXY_HANDLER\");\n"
+                        "\tduk_push_proxy(ctx, 0);\n"
+                        "\t/* the instance keeps the proxy alive */\n"
+                        "\tduk_dup(ctx, 1);\n"
+                        "\tduk_put_prop_string(ctx, 0, \"%sPROXY\");\n",
+                        MAGICPFX, MAGICPFX);
+                if (interfacee->class_init_argc > 0) {
+                        fprintf(outf, "\tif (%s_wrapper_insert_proxy(ctx, ",
+                                DLPFX);
+                        output_wrapped_member(outf, ir, interfacee);
+                        fprintf(outf,
+                                ", 0, 1) != 0) {\n"
+                                "\t\treturn duk_error(ctx, DUK_ERR_RANGE_ERROR, \"alloc failed\");\n"
+                                "\t}\n");
+                }
+        } else if (interfacee->class_init_argc > 0) {
+                fprintf(outf, "\tif (%s_wrapper_insert(ctx, ", DLPFX);
+                output_wrapped_member(outf, ir, interfacee);
+                fprintf(outf,
+                        ", 0) != 0) {\n"
+                        "\t\treturn duk_error(ctx, DUK_ERR_RANGE_ERROR, \"alloc failed\");\n"
+                        "\t}\n");
+        }
         fprintf(outf, "\treturn 1;\n");
 
         fprintf(outf, "}\n\n");
@@ -300,25 +615,67 @@ output_interface_constructor(FILE* outf, struct ir_entry *interfacee)
         return 0;
 }
 
+/**
+ * find if an interface or any it inherits from has event handlers
+ *
+ * Only objects of such interfaces can have handlers stored in their
+ *  slots so this decides the output from the entry and those it
+ *  inherits, which its fingerprint covers.
+ */
+static bool
+interface_has_event_handler(struct ir *ir, struct ir_entry *interfacee)
+{
+        int attrc;
+
+        while (interfacee != NULL) {
+                for (attrc = 0;
+                     attrc < interfacee->u.interface.attributec;
+                     attrc++) {
+                        if (attribute_is_event_handler(
+                                    interfacee->u.interface.attributev + attrc)) {
+                                return true;
+                        }
+                }
+                interfacee = ir_inherit_entry(ir, interfacee);
+        }
+        return false;
+}
+
 /**
  * generate the interface destructor
  */
 static int
-output_interface_destructor(FILE* outf, struct ir_entry *interfacee)
+output_interface_destructor(FILE* outf,
+                            struct ir *ir,
+                            struct ir_entry *interfacee)
 {
         /* destructor definition */
+        output_profile_placement(outf, ir, interfacee, NULL, "finalizer");
         fprintf(outf,
                 "static duk_ret_t %s_%s___destructor(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name);
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, NULL, "finalizer");
+
         output_safe_get_private(outf, interfacee->class_name, 0);
 
+        if (interfacee->class_init_argc > 0) {
+                fprintf(outf, "\t%s_wrapper_remove(ctx, ", DLPFX);
+                output_wrapped_member(outf, ir, interfacee);
+                fprintf(outf, ", 0);\n");
+        }
+
         /* generate call to finaliser */
         fprintf(outf,
                 "\t%s_%s___fini(ctx, priv);\n",
                 DLPFX, interfacee->class_name);
 
+        /* release any event handler slots */
+        if (interface_has_event_handler(ir, interfacee)) {
+                fprintf(outf, "\t%s_event_handler_fini(priv);\n", DLPFX);
+        }
+
         fprintf(outf,"\tfree(priv);\n");
         fprintf(outf,"\treturn 0;\n");
 
@@ -449,6 +806,73 @@ output_interface_inherit_init(FILE* outf,
         return 0;
 }
 
+/* exported function documented in duk-libdom.h */
+bool interface_init_inline(struct ir_entry *interfacee)
+{
+        static const enum genbind_method_type class_cdata[] = {
+                GENBIND_METHOD_TYPE_PREFACE,
+                GENBIND_METHOD_TYPE_PROLOGUE,
+                GENBIND_METHOD_TYPE_EPILOGUE,
+                GENBIND_METHOD_TYPE_POSTFACE,
+        };
+        unsigned int idx;
+
+        if ((!options->inlineinit) ||
+            (interfacee->type != IR_ENTRY_TYPE_INTERFACE) ||
+            (interfacee->refcount < 1)) {
+                return false;
+        }
+
+        /* the code may depend on the class cdata of its own source file */
+        for (idx = 0; idx < sizeof(class_cdata) / sizeof(class_cdata[0]); idx++) {
+                if (genbind_node_find_method(interfacee->class,
+                                             NULL,
+                                             class_cdata[idx]) != NULL) {
+                        return false;
+                }
+        }
+
+        return true;
+}
+
+/**
+ * count the parameters of the initialisor of an interface
+ */
+static int interface_init_argc(struct ir_entry *interfacee)
+{
+        struct genbind_node *init_node;
+        struct genbind_node *param_node;
+        int argc = 0;
+
+        init_node = genbind_node_find_method(interfacee->class,
+                                             NULL,
+                                             GENBIND_METHOD_TYPE_INIT);
+        param_node = genbind_node_find_type(
+                genbind_node_getnode(init_node),
+                NULL, GENBIND_NODE_TYPE_PARAMETER);
+        while (param_node != NULL) {
+                argc++;
+                param_node = genbind_node_find_type(
+                        genbind_node_getnode(init_node),
+                        param_node, GENBIND_NODE_TYPE_PARAMETER);
+        }
+
+        return argc;
+}
+
+/**
+ * output the storage class of an initialiser or finaliser
+ */
+static void
+output_interface_init_storage(FILE* outf, struct ir_entry *interfacee)
+{
+        if (interface_init_inline(interfacee)) {
+                fprintf(outf, "static inline ");
+        } else if (interfacee->refcount == 0) {
+                fprintf(outf, "static ");
+        }
+}
+
 static int
 output_interface_init_declaration(FILE* outf,
                                   struct ir_entry *interfacee,
@@ -456,9 +880,7 @@ output_interface_init_declaration(FILE* outf,
 {
         struct genbind_node *param_node;
 
-        if  (interfacee->refcount == 0) {
-                fprintf(outf, "static ");
-        }
+        output_interface_init_storage(outf, interfacee);
         fprintf(outf,
                 "void %s_%s___init(duk_context *ctx, %s_private_t *priv",
                 DLPFX, interfacee->class_name, interfacee->class_name);
@@ -539,9 +961,7 @@ output_interface_fini(FILE* outf,
 
 
         /* finaliser definition */
-        if  (interfacee->refcount == 0) {
-                fprintf(outf, "static ");
-        }
+        output_interface_init_storage(outf, interfacee);
         fprintf(outf,
                 "void %s_%s___fini(duk_context *ctx, %s_private_t *priv)\n",
                 DLPFX, interfacee->class_name, interfacee->class_name);
@@ -581,7 +1001,8 @@ output_prototype_method(FILE* outf,
                 /* normal method on prototype */
                 output_add_method(outf,
                                   interfacee->class_name,
-                                  operatione->name);
+                                  operatione->name,
+                                  operatione->pruned);
         } else {
                 /* special method on prototype */
                 fprintf(outf,
@@ -619,6 +1040,9 @@ output_prototype_attribute(FILE *outf,
                            struct ir_entry *interfacee,
                            struct ir_attribute_entry *attributee)
 {
+        if (attributee->pruned) {
+                return output_populate_pruned_property(outf, attributee->name);
+        }
     if ((attributee->putforwards == NULL) &&
         (attributee->modifier == WEBIDL_TYPE_MODIFIER_READONLY)) {
                 return output_populate_ro_property(outf,
@@ -730,6 +1154,76 @@ output_global_create_prototype(FILE* outf,
 }
 
 
+/**
+ * generate the iteration methods on a prototype
+ *
+ * The default iterator is entries for pair iterators and maplike and
+ *  values for value iterators and setlike.
+ */
+static int
+output_prototype_iterable(FILE* outf, struct ir_entry *interfacee)
+{
+        struct ir_iterable_entry *iterablee;
+        const char *default_iterator;
+        unsigned int midx;
+
+        iterablee = &interfacee->u.interface.iterable;
+
+        for (midx = 0;
+             midx < sizeof(iterable_methods) / sizeof(iterable_methods[0]);
+             midx++) {
+                if (!interface_has_operation(interfacee,
+                                             iterable_methods[midx].name)) {
+                        output_add_method(outf,
+                                          interfacee->class_name,
+                                          iterable_methods[midx].name,
+                                          false);
+                }
+        }
+
+        if ((iterablee->type == IR_ITERABLE_PAIR) ||
+            (iterablee->type == IR_ITERABLE_MAPLIKE)) {
+                default_iterator = "entries";
+        } else {
+                default_iterator = "values";
+        }
+
+        if (!interface_has_operation(interfacee, default_iterator)) {
+                fprintf(outf,
+                        "\t/* Default iterator */\n"
+                        "\tduk_push_c_function(ctx, %s_%s_%s, DUK_VARARGS);\n"
+                        "\tduk_put_prop_string(ctx, 0, DUK_WELLKNOWN_SYMBOL(\"Symbol.iterator\"));\n\n",
+                        DLPFX, interfacee->class_name, default_iterator);
+        }
+
+        return 0;
+}
+
+/**
+ * generate the proxy handler on a prototype
+ *
+ * The constructor wraps instances in a proxy using this handler.
+ */
+static int
+output_prototype_proxy_handler(FILE* outf, struct ir_entry *interfacee)
+{
+        fprintf(outf,
+                "\t/* Proxy handler for indexed and named properties */\n"
+                "\tduk_dup(ctx, 0);\n"
+                "\tduk_push_object(ctx);\n"
+                "\tduk_push_c_function(ctx, %s_%s___proxy_get, 3);\n"
+                "\tduk_put_prop_string(ctx, -2, \"get\");\n"
+                "\tduk_push_c_function(ctx, %s_%s___proxy_has, 2);\n"
+                "\tduk_put_prop_string(ctx, -2, \"has\");\n"
+                "\tduk_put_prop_string(ctx, -2, \"%sPROXY_HANDLER\");\n"
+                "\tduk_pop(ctx);\n\n",
+                DLPFX, interfacee->class_name,
+                DLPFX, interfacee->class_name,
+                MAGICPFX);
+
+        return 0;
+}
+
 /**
  * generate the interface prototype creator
  */
@@ -773,6 +1267,16 @@ output_interface_prototype(FILE* outf,
         /* generate setting of constants */
         output_prototype_constants(outf, interfacee);
 
+        /* generate iteration methods */
+        if (interface_iterable(ir, interfacee, NULL)) {
+                output_prototype_iterable(outf, interfacee);
+        }
+
+        /* generate proxy handler for indexed and named properties */
+        if (interface_property_getters(ir, interfacee, NULL, NULL, NULL)) {
+                output_prototype_proxy_handler(outf, interfacee);
+        }
+
         /* if this is the global object, output all interfaces which do not
          * prevent us from doing so
          */
@@ -801,17 +1305,21 @@ output_interface_prototype(FILE* outf,
  */
 static int
 output_interface_elipsis_operation(FILE* outf,
+                                   struct ir *ir,
                                struct ir_entry *interfacee,
                                struct ir_operation_entry *operatione)
 {
         int cdatac; /* cdata blocks output */
 
         /* overloaded method definition */
+        output_profile_placement(outf, ir, interfacee, operatione->name, "method");
         fprintf(outf,
                 "static duk_ret_t %s_%s_%s(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, operatione->name);
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, operatione->name, "method");
+
         /**
          * \todo This is where the checking of the parameters to the
          * operation with elipsis should go
@@ -823,6 +1331,9 @@ output_interface_elipsis_operation(FILE* outf,
         output_get_method_private(outf, interfacee->class_name);
 
         cdatac = output_ccode(outf, operatione->method);
+        report_member(REPORT_MEMBER_METHOD,
+                      (cdatac == 0) ? REPORT_IMPL_UNIMPLEMENTED :
+                      REPORT_IMPL_HANDWRITTEN);
         if (cdatac == 0) {
                 /* no implementation so generate default */
                 WARN(WARNING_UNIMPLEMENTED,
@@ -841,17 +1352,21 @@ output_interface_elipsis_operation(FILE* outf,
  */
 static int
 output_interface_overloaded_operation(FILE* outf,
+                                      struct ir *ir,
                                struct ir_entry *interfacee,
                                struct ir_operation_entry *operatione)
 {
         int cdatac; /* cdata blocks output */
 
         /* overloaded method definition */
+        output_profile_placement(outf, ir, interfacee, operatione->name, "method");
         fprintf(outf,
                 "static duk_ret_t %s_%s_%s(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, operatione->name);
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, operatione->name, "method");
+
         /** \todo This is where the checking of the parameters to the
          * overloaded operation should go
          */
@@ -861,6 +1376,9 @@ output_interface_overloaded_operation(FILE* outf,
         cdatac = output_cdata(outf,
                               operatione->method,
                               GENBIND_NODE_TYPE_CDATA);
+        report_member(REPORT_MEMBER_METHOD,
+                      (cdatac == 0) ? REPORT_IMPL_UNIMPLEMENTED :
+                      REPORT_IMPL_HANDWRITTEN);
 
         if (cdatac == 0) {
                 /* no implementation so generate default */
@@ -905,60 +1423,123 @@ output_operation_optional_defaults(FILE* outf,
         int argc;
         for (argc = 0; argc < argumentc; argc++) {
                 struct ir_operation_argument_entry *cure;
-                struct webidl_node *lit_node; /* literal node */
-                enum webidl_node_type lit_type;
-                int *lit_int;
-                char *lit_str;
 
                 cure = argumentv + argc;
 
-                lit_node = webidl_node_getnode(
-                        webidl_node_find_type(
-                                webidl_node_getnode(cure->node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_OPTIONAL));
-
-                if (lit_node != NULL) {
+                switch (cure->defl.type) {
+                case IR_DEFAULT_NULL:
+                        fprintf(outf, "\t\tduk_push_null(ctx);\n");
+                        break;
 
-                        lit_type = webidl_node_gettype(lit_node);
+                case IR_DEFAULT_INT:
+                        fprintf(outf,
+                                "\t\tduk_push_int(ctx, %d);\n",
+                                cure->defl.intval);
+                        break;
 
-                        switch (lit_type) {
-                        case WEBIDL_NODE_TYPE_LITERAL_NULL:
-                                fprintf(outf,
-                                        "\t\tduk_push_null(ctx);\n");
-                                break;
+                case IR_DEFAULT_BOOL:
+                        fprintf(outf,
+                                "\t\tduk_push_boolean(ctx, %d);\n",
+                                cure->defl.intval);
+                        break;
 
-                        case WEBIDL_NODE_TYPE_LITERAL_INT:
-                                lit_int = webidl_node_getint(lit_node);
-                                fprintf(outf,
-                                        "\t\tduk_push_int(ctx, %d);\n",
-                                        *lit_int);
-                                break;
+                case IR_DEFAULT_STRING:
+                        fprintf(outf, "\t\tduk_push_string(ctx, ");
+                        output_cstring(outf, cure->defl.text);
+                        fprintf(outf, ");\n");
+                        break;
 
-                        case WEBIDL_NODE_TYPE_LITERAL_BOOL:
-                                lit_int = webidl_node_getint(lit_node);
-                                fprintf(outf,
-                                        "\t\tduk_push_boolean(ctx, %d);\n",
-                                        *lit_int);
-                                break;
+                case IR_DEFAULT_FLOAT:
+                case IR_DEFAULT_NONE:
+                default:
+                        fprintf(outf, "\t\tduk_push_undefined(ctx);\n");
+                        break;
+                }
+        }
+        return 0;
+}
 
-                        case WEBIDL_NODE_TYPE_LITERAL_STRING:
-                                lit_str = webidl_node_gettext(lit_node);
-                                fprintf(outf,
-                                        "\t\tduk_push_string(ctx, \"%s\");\n",
-                                        lit_str);
-                                break;
+/**
+ * generate the variables holding converted enumeration arguments
+ *
+ * An argument which is not passed holds its default value, or the first
+ * value of the enumeration if it has no default.
+ */
+static int
+output_operation_enumeration_arguments(
+        FILE* outf,
+        struct ir_operation_overload_entry *overloade)
+{
+        struct ir_operation_argument_entry *argumente;
+        struct ir_enumeration_entry *enumeratione;
+        int argidx;
+        int vidx;
 
-                        case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
-                        default:
-                                fprintf(outf,
-                                        "\t\tduk_push_undefined(ctx);\n");
-                                break;
+        for (argidx = 0; argidx < overloade->argumentc; argidx++) {
+                argumente = overloade->argumentv + argidx;
+                if ((argumente->typec == 0) ||
+                    (argumente->typev[0].base != WEBIDL_TYPE_USER) ||
+                    (argumente->typev[0].enumeration == NULL)) {
+                        continue;
+                }
+                enumeratione = argumente->typev[0].enumeration;
+
+                vidx = enumeratione->valuec - 1;
+                if (argumente->defl.type == IR_DEFAULT_STRING) {
+                        while ((vidx > 0) &&
+                               (strcmp(enumeratione->valuev[vidx],
+                                       argumente->defl.text) != 0)) {
+                                vidx--;
                         }
                 } else {
-                        fprintf(outf, "\t\tduk_push_undefined(ctx);\n");
+                        vidx = 0;
+                }
+
+                fprintf(outf,
+                        "\tenum %s_%s %s_enum_%s = ",
+                        DLPFX, enumeratione->class_name,
+                        DLPFX, argumente->name);
+                output_enumeration_value_name(outf, enumeratione, vidx);
+                fprintf(outf, ";\n"
+                        "\t(void)%s_enum_%s;\n",
+                        DLPFX, argumente->name);
+        }
+
+        return 0;
+}
+
+/**
+ * generate the callback handles of callback arguments
+ *
+ * The handle refers to the argument on the value stack for the
+ *  duration of the call and is not pinned. It may be passed to the
+ *  invocation function of the callback or its value pinned with
+ *  dukky_callback_set(). An argument which is not passed or is null
+ *  leaves the handle empty.
+ */
+static int
+output_operation_callback_arguments(
+        FILE* outf,
+        struct ir_operation_overload_entry *overloade)
+{
+        struct ir_operation_argument_entry *argumente;
+        int argidx;
+
+        for (argidx = 0; argidx < overloade->argumentc; argidx++) {
+                argumente = overloade->argumentv + argidx;
+                if ((argumente->typec == 0) ||
+                    (argumente->typev[0].base != WEBIDL_TYPE_USER) ||
+                    (argumente->typev[0].callback == NULL)) {
+                        continue;
                 }
+
+                fprintf(outf,
+                        "	struct %s_callback %s_callback_%s = { NULL, 0 };\n"
+                        "	(void)%s_callback_%s;\n",
+                        DLPFX, DLPFX, argumente->name,
+                        DLPFX, argumente->name);
         }
+
         return 0;
 }
 
@@ -971,17 +1552,11 @@ output_operation_argument_type_check(
         int argidx)
 {
         struct ir_operation_argument_entry *argumente;
-        struct webidl_node *type_node;
-        enum webidl_type *argument_type;
+        enum webidl_type argument_type;
 
         argumente = overloade->argumentv + argidx;
 
-        type_node = webidl_node_find_type(
-                webidl_node_getnode(argumente->node),
-                NULL,
-                WEBIDL_NODE_TYPE_TYPE);
-
-        if (type_node == NULL) {
+        if (argumente->typec == 0) {
                 fprintf(stderr, "%s:%s %dth argument %s has no type\n",
                         interfacee->name,
                         operatione->name,
@@ -990,30 +1565,16 @@ output_operation_argument_type_check(
                 return -1;
         }
 
-        argument_type = (enum webidl_type *)webidl_node_getint(
-                webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_BASE));
-
-        if (argument_type == NULL) {
-                fprintf(stderr,
-                        "%s:%s %dth argument %s has no type base\n",
-                        interfacee->name,
-                        operatione->name,
-                        argidx,
-                        argumente->name);
-                return -1;
-        }
+        argument_type = argumente->typev[0].base;
 
-        if (*argument_type == WEBIDL_TYPE_ANY) {
+        if (argument_type == WEBIDL_TYPE_ANY) {
                 /* allowing any type needs no check */
                 return 0;
         }
 
         fprintf(outf, "\tif (%s_argc > %d) {\n", DLPFX, argidx);
 
-        switch (*argument_type) {
+        switch (argument_type) {
         case WEBIDL_TYPE_STRING:
                 /* coerce values to string */
                 fprintf(outf,
@@ -1040,6 +1601,66 @@ output_operation_argument_type_check(
                         "\t\t}\n", argidx, DLPFX, argidx, argumente->name);
                 break;
 
+        case WEBIDL_TYPE_USER:
+                if (argumente->typev[0].enumeration != NULL) {
+                        /* coerce to string which must be a listed value */
+                        fprintf(outf,
+                                "\t\tduk_size_t %s_len;\n"
+                                "\t\tconst char *%s_str;\n"
+                                "\t\tint %s_value;\n"
+                                "\t\tduk_to_string(ctx, %d);\n"
+                                "\t\t%s_str = duk_get_lstring(ctx, %d, &%s_len);\n"
+                                "\t\t%s_value = %s_%s_from_string(%s_str, %s_len);\n"
+                                "\t\tif (%s_value < 0) {\n"
+                                "\t\t\treturn duk_error(ctx, DUK_ERR_TYPE_ERROR, %s_error_fmt_enum_type, %d, \"%s\", \"%s\");\n"
+                                "\t\t}\n"
+                                "\t\t%s_enum_%s = %s_value;\n",
+                                DLPFX,
+                                DLPFX,
+                                DLPFX,
+                                argidx,
+                                DLPFX, argidx, DLPFX,
+                                DLPFX, DLPFX,
+                                argumente->typev[0].enumeration->class_name,
+                                DLPFX, DLPFX,
+                                DLPFX,
+                                DLPFX, argidx, argumente->name,
+                                argumente->typev[0].enumeration->name,
+                                DLPFX, argumente->name, DLPFX);
+                        break;
+                }
+                if (argumente->typev[0].callback != NULL) {
+                        struct ir_callback_entry *callbacke;
+
+                        /* callback functions must be callable and
+                         * callback interfaces may be any object
+                         */
+                        callbacke = argumente->typev[0].callback;
+                        fprintf(outf,
+                                "\t\tif (%s(ctx, %d)) {\n"
+                                "\t\t\t%s_callback_%s.func = duk_get_heapptr(ctx, %d);\n"
+                                "\t\t}",
+                                (callbacke->interface == NULL) ?
+                                "duk_is_callable" : "duk_is_object",
+                                argidx,
+                                DLPFX, argumente->name, argidx);
+                        if (argumente->typev[0].nullable) {
+                                fprintf(outf,
+                                        " else if (!duk_is_null_or_undefined(ctx, %d))",
+                                        argidx);
+                        }
+                        fprintf(outf,
+                                " else {\n"
+                                "\t\t\treturn duk_error(ctx, DUK_ERR_TYPE_ERROR, %s_error_fmt_callback_type, %d, \"%s\", \"%s\");\n"
+                                "\t\t}\n",
+                                DLPFX, argidx, argumente->name,
+                                callbacke->name);
+                        break;
+                }
+                fprintf(outf,
+                        "\t\t/* unhandled type check */\n");
+                break;
+
 
         default:
                 fprintf(outf,
@@ -1057,6 +1678,7 @@ output_operation_argument_type_check(
  */
 static int
 output_interface_operation(FILE* outf,
+                           struct ir *ir,
                            struct ir_entry *interfacee,
                            struct ir_operation_entry *operatione)
 {
@@ -1074,12 +1696,14 @@ output_interface_operation(FILE* outf,
 
         if (operatione->overloadc != 1) {
                 return output_interface_overloaded_operation(outf,
+                                                             ir,
                                                              interfacee,
                                                              operatione);
         }
 
         if (operatione->overloadv->elipsisc != 0) {
                 return output_interface_elipsis_operation(outf,
+                                                          ir,
                                                           interfacee,
                                                           operatione);
         }
@@ -1087,11 +1711,14 @@ output_interface_operation(FILE* outf,
         /* normal method definition */
         overloade = operatione->overloadv;
 
+        output_profile_placement(outf, ir, interfacee, operatione->name, "method");
         fprintf(outf,
                 "static duk_ret_t %s_%s_%s(duk_context *ctx)\n",
                 DLPFX, interfacee->class_name, operatione->name);
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, operatione->name, "method");
+
         /* check arguments */
 
         /* generate check for minimum number of parameters */
@@ -1143,6 +1770,9 @@ output_interface_operation(FILE* outf,
 
         /* generate argument type checks */
 
+        output_operation_enumeration_arguments(outf, overloade);
+        output_operation_callback_arguments(outf, overloade);
+
         fprintf(outf, "\t/* check types of passed arguments are correct */\n");
 
         for (argidx = 0; argidx < overloade->argumentc; argidx++) {
@@ -1156,6 +1786,9 @@ output_interface_operation(FILE* outf,
         output_get_method_private(outf, interfacee->class_name);
 
         cdatac = output_ccode(outf, operatione->method);
+        report_member(REPORT_MEMBER_METHOD,
+                      (cdatac == 0) ? REPORT_IMPL_UNIMPLEMENTED :
+                      REPORT_IMPL_HANDWRITTEN);
         if (cdatac == 0) {
                 /* no implementation so generate default */
                 WARN(WARNING_UNIMPLEMENTED,
@@ -1178,14 +1811,18 @@ output_interface_operation(FILE* outf,
  * generate class methods for each interface operation
  */
 static int
-output_interface_operations(FILE* outf, struct ir_entry *ife)
+output_interface_operations(FILE* outf, struct ir *ir, struct ir_entry *ife)
 {
         int opc;
         int res = 0;
 
         for (opc = 0; opc < ife->u.interface.operationc; opc++) {
+                if (ife->u.interface.operationv[opc].pruned) {
+                        continue;
+                }
                 res = output_interface_operation(
                         outf,
+                        ir,
                         ife,
                         ife->u.interface.operationv + opc);
                 if (res != 0) {
@@ -1198,38 +1835,59 @@ output_interface_operations(FILE* outf, struct ir_entry *ife)
 
 
 
+/**
+ * check if the result of an attribute getter is cached
+ *
+ * Unimplemented getters return nothing so are never cached.
+ */
+static bool attribute_getter_cached(struct ir_attribute_entry *atributee)
+{
+        return ((atributee->cache != IR_ATTRIBUTE_CACHE_NONE) &&
+                (atributee->getter != NULL));
+}
+
 /**
  * Output class property getter for a single attribute
  */
 static int
 output_attribute_getter(FILE* outf,
+                        struct ir *ir,
                         struct ir_entry *interfacee,
                         struct ir_attribute_entry *atributee)
 {
         /* getter definition */
+        output_profile_placement(outf, ir, interfacee, atributee->name, "getter");
         fprintf(outf,
-                "static duk_ret_t %s_%s_%s_getter(duk_context *ctx)\n",
-                DLPFX, interfacee->class_name, atributee->name);
+                "static duk_ret_t %s_%s_%s_getter%s(duk_context *ctx)\n",
+                DLPFX, interfacee->class_name, atributee->name,
+                attribute_getter_cached(atributee) ? "_compute" : "");
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, atributee->name, "getter");
+
         output_get_method_private(outf, interfacee->class_name);
 
         /* if binding available for this attribute getter process it */
         if (atributee->getter != NULL) {
+                enum report_impl impl = REPORT_IMPL_HANDWRITTEN;
                 int res;
                 res = output_ccode(outf, atributee->getter);
                 if (res == 0) {
                         /* no code provided for this getter so generate */
+                        impl = REPORT_IMPL_GENERATED;
                         res = output_generated_attribute_getter(outf,
                                                                 interfacee,
                                                                 atributee);
                 }
                 if (res >= 0) {
+                        report_member(REPORT_MEMBER_GETTER, impl);
                         fprintf(outf, "}\n\n");
                         return res;
                 }
         }
 
+        report_member(REPORT_MEMBER_GETTER, REPORT_IMPL_UNIMPLEMENTED);
+
         /* no implementation so generate default and warnings if required */
         const char *type_str;
         if (atributee->typec == 0) {
@@ -1259,6 +1917,107 @@ output_attribute_getter(FILE* outf,
 }
 
 
+/**
+ * Check if an attribute setter must invalidate the native object
+ *
+ * When the binding caches [Pure] attribute results a setter with an
+ *  implementation changes the object and invalidates it. A
+ *  putforwards setter changes the object of the forwarded attribute
+ *  whose own setter invalidates it.
+ */
+static bool attribute_setter_invalidates(struct ir *ir,
+                                         struct ir_attribute_entry *atributee)
+{
+        return (ir->generation_cache &&
+                (atributee->modifier != WEBIDL_TYPE_MODIFIER_READONLY) &&
+                (atributee->setter != NULL));
+}
+
+/**
+ * Output class property getter caching the result of an attribute
+ *
+ * The result of the getter is kept in a hidden property on the
+ *  instance. [Pure] results also record the generation of the native
+ *  object in the wrapper cache and are recomputed once it is
+ *  invalidated.
+ */
+static int
+output_cached_attribute_getter(FILE* outf,
+                               struct ir *ir,
+                               struct ir_entry *interfacee,
+                               struct ir_attribute_entry *atributee)
+{
+        output_profile_placement(outf, ir, interfacee, atributee->name, "getter");
+        fprintf(outf,
+                "static duk_ret_t %s_%s_%s_getter(duk_context *ctx)\n",
+                DLPFX, interfacee->class_name, atributee->name);
+        fprintf(outf,"{\n");
+
+        if (atributee->cache == IR_ATTRIBUTE_CACHE_GENERATION) {
+                fprintf(outf, "\tunsigned int generation;\n");
+        }
+        fprintf(outf, "\tduk_ret_t ret;\n\n");
+
+        if (atributee->cache == IR_ATTRIBUTE_CACHE_GENERATION) {
+                output_get_method_private(outf, interfacee->class_name);
+
+                fprintf(outf, "\tgeneration = %s_wrapper_generation(ctx, ",
+                        DLPFX);
+                output_wrapped_member(outf, ir, interfacee);
+                fprintf(outf, ");\n");
+
+                fprintf(outf,
+                        "\tif (generation != 0) {\n"
+                        "\t\t/* return value cached in this generation */\n"
+                        "\t\tduk_push_this(ctx);\n"
+                        "\t\tduk_get_prop_string(ctx, -1, \"%sCACHE_%s_%s_GENERATION\");\n"
+                        "\t\tif (duk_get_uint(ctx, -1) == generation) {\n"
+                        "\t\t\tduk_get_prop_string(ctx, -2, \"%sCACHE_%s_%s\");\n"
+                        "\t\t\treturn 1;\n"
+                        "\t\t}\n"
+                        "\t\tduk_pop_2(ctx);\n"
+                        "\t}\n\n",
+                        MAGICPFX, interfacee->class_name, atributee->name,
+                        MAGICPFX, interfacee->class_name, atributee->name);
+        } else {
+                fprintf(outf,
+                        "\t/* return cached value */\n"
+                        "\tduk_push_this(ctx);\n"
+                        "\tif (duk_get_prop_string(ctx, -1, \"%sCACHE_%s_%s\")) {\n"
+                        "\t\treturn 1;\n"
+                        "\t}\n"
+                        "\tduk_pop_2(ctx);\n\n",
+                        MAGICPFX, interfacee->class_name, atributee->name);
+        }
+
+        fprintf(outf,
+                "\tret = %s_%s_%s_getter_compute(ctx);\n",
+                DLPFX, interfacee->class_name, atributee->name);
+
+        fprintf(outf,
+                "\tif (%s) {\n"
+                "\t\t/* cache value on instance */\n"
+                "\t\tduk_push_this(ctx);\n"
+                "\t\tduk_dup(ctx, -2);\n"
+                "\t\tduk_put_prop_string(ctx, -2, \"%sCACHE_%s_%s\");\n",
+                (atributee->cache == IR_ATTRIBUTE_CACHE_GENERATION) ?
+                "(ret > 0) && (generation != 0)" : "ret > 0",
+                MAGICPFX, interfacee->class_name, atributee->name);
+        if (atributee->cache == IR_ATTRIBUTE_CACHE_GENERATION) {
+                fprintf(outf,
+                        "\t\tduk_push_uint(ctx, generation);\n"
+                        "\t\tduk_put_prop_string(ctx, -2, \"%sCACHE_%s_%s_GENERATION\");\n",
+                        MAGICPFX, interfacee->class_name, atributee->name);
+        }
+        fprintf(outf,
+                "\t\tduk_pop(ctx);\n"
+                "\t}\n"
+                "\treturn ret;\n"
+                "}\n\n");
+
+        return 0;
+}
+
 /**
  * Generate class property setter for a putforwards attribute
  */
@@ -1294,39 +2053,100 @@ output_putforwards_setter(FILE* outf,
         return 0;
 }
 
+/**
+ * Generate the conversion of a value set on an enumeration attribute
+ *
+ * Values which are not listed by the enumeration are ignored so the
+ * setter implementation only sees valid values, which it is given as
+ * dukky_enum_<attribute> as well as the string on the stack.
+ */
+static int
+output_enumeration_setter_check(FILE* outf,
+                                struct ir_attribute_entry *atributee)
+{
+        if ((atributee->typec != 1) ||
+            (atributee->typev[0].base != WEBIDL_TYPE_USER) ||
+            (atributee->typev[0].enumeration == NULL)) {
+                return 0;
+        }
+
+        fprintf(outf,
+                "\tenum %s_%s %s_enum_%s;\n"
+                "\t{\n"
+                "\t\tduk_size_t %s_len;\n"
+                "\t\tconst char *%s_str;\n"
+                "\t\tint %s_value;\n"
+                "\t\tduk_to_string(ctx, 0);\n"
+                "\t\t%s_str = duk_get_lstring(ctx, 0, &%s_len);\n"
+                "\t\t%s_value = %s_%s_from_string(%s_str, %s_len);\n"
+                "\t\tif (%s_value < 0) {\n"
+                "\t\t\treturn 0;\n"
+                "\t\t}\n"
+                "\t\t%s_enum_%s = %s_value;\n"
+                "\t\t(void)%s_enum_%s;\n"
+                "\t}\n\n",
+                DLPFX, atributee->typev[0].enumeration->class_name,
+                DLPFX, atributee->name,
+                DLPFX,
+                DLPFX,
+                DLPFX,
+                DLPFX, DLPFX,
+                DLPFX, DLPFX,
+                atributee->typev[0].enumeration->class_name,
+                DLPFX, DLPFX,
+                DLPFX,
+                DLPFX, atributee->name, DLPFX,
+                DLPFX, atributee->name);
+
+        return 0;
+}
+
 /**
  * Generate class property setter for a single attribute
  */
 static int
 output_attribute_setter(FILE* outf,
+                        struct ir *ir,
                         struct ir_entry *interfacee,
                         struct ir_attribute_entry *atributee)
 {
+        enum report_impl impl = REPORT_IMPL_HANDWRITTEN;
         int res = -1;
 
        /* setter definition */
+        output_profile_placement(outf, ir, interfacee, atributee->name, "setter");
         fprintf(outf,
-                "static duk_ret_t %s_%s_%s_setter(duk_context *ctx)\n",
-                DLPFX, interfacee->class_name, atributee->name);
+                "static duk_ret_t %s_%s_%s_setter%s(duk_context *ctx)\n",
+                DLPFX, interfacee->class_name, atributee->name,
+                attribute_setter_invalidates(ir, atributee) ? "_apply" : "");
         fprintf(outf,"{\n");
 
+        output_profile_counter(outf, interfacee, atributee->name, "setter");
+
         output_get_method_private(outf, interfacee->class_name);
 
         /* if binding available for this attribute getter process it */
         if (atributee->setter != NULL) {
+                output_enumeration_setter_check(outf, atributee);
+
                 res = output_ccode(outf, atributee->setter);
                 if (res == 0) {
                         /* no code provided for this setter so generate */
+                        impl = REPORT_IMPL_GENERATED;
                         res = output_generated_attribute_setter(outf,
                                                                 interfacee,
                                                                 atributee);
                 }
         } else if (atributee->putforwards != NULL) {
+                impl = REPORT_IMPL_GENERATED;
                 res = output_putforwards_setter(outf,
                                                 interfacee,
                                                 atributee);
         }
 
+        report_member(REPORT_MEMBER_SETTER,
+                      (res < 0) ? REPORT_IMPL_UNIMPLEMENTED : impl);
+
         /* implementation not generated from any other source */
         if (res < 0) {
                 const char *type_str;
@@ -1358,11 +2178,48 @@ output_attribute_setter(FILE* outf,
 }
 
 
+/**
+ * Output class property setter invalidating the native object
+ *
+ * The binding setter is generated as <setter>_apply and the native
+ *  object is invalidated once it returns so [Pure] results computed
+ *  by the setter code itself are not kept.
+ */
+static int
+output_invalidating_attribute_setter(FILE* outf,
+                                     struct ir *ir,
+                                     struct ir_entry *interfacee,
+                                     struct ir_attribute_entry *atributee)
+{
+        output_profile_placement(outf, ir, interfacee, atributee->name, "setter");
+        fprintf(outf,
+                "static duk_ret_t %s_%s_%s_setter(duk_context *ctx)\n",
+                DLPFX, interfacee->class_name, atributee->name);
+        fprintf(outf,"{\n");
+        fprintf(outf, "\tduk_ret_t ret;\n\n");
+
+        output_get_method_private(outf, interfacee->class_name);
+
+        fprintf(outf,
+                "\tret = %s_%s_%s_setter_apply(ctx);\n",
+                DLPFX, interfacee->class_name, atributee->name);
+
+        fprintf(outf, "\t%s_wrapper_invalidate(ctx, ", DLPFX);
+        output_wrapped_member(outf, ir, interfacee);
+        fprintf(outf, ");\n");
+
+        fprintf(outf, "\treturn ret;\n");
+        fprintf(outf, "}\n\n");
+
+        return 0;
+}
+
 /**
  * Generate class property getter/setter for a single attribute
  */
 static int
 output_interface_attribute(FILE* outf,
+                           struct ir *ir,
                            struct ir_entry *interfacee,
                            struct ir_attribute_entry *atributee)
 {
@@ -1372,12 +2229,21 @@ output_interface_attribute(FILE* outf,
             atributee->property_name = gen_idl2c_name(atributee->name);
         }
 
-        res = output_attribute_getter(outf, interfacee, atributee);
+        res = output_attribute_getter(outf, ir, interfacee, atributee);
+        if (attribute_getter_cached(atributee)) {
+                output_cached_attribute_getter(outf, ir, interfacee, atributee);
+        }
 
         /* only read/write and putforward attributes have a setter */
         if ((atributee->modifier != WEBIDL_TYPE_MODIFIER_READONLY) ||
             (atributee->putforwards != NULL)) {
-                res = output_attribute_setter(outf, interfacee, atributee);
+                res = output_attribute_setter(outf, ir, interfacee, atributee);
+                if (attribute_setter_invalidates(ir, atributee)) {
+                        output_invalidating_attribute_setter(outf,
+                                                             ir,
+                                                             interfacee,
+                                                             atributee);
+                }
         }
 
         return res;
@@ -1387,13 +2253,17 @@ output_interface_attribute(FILE* outf,
  * generate class property getters and setters for each interface attribute
  */
 static int
-output_interface_attributes(FILE* outf, struct ir_entry *ife)
+output_interface_attributes(FILE* outf, struct ir *ir, struct ir_entry *ife)
 {
         int attrc;
 
         for (attrc = 0; attrc < ife->u.interface.attributec; attrc++) {
+                if (ife->u.interface.attributev[attrc].pruned) {
+                        continue;
+                }
                 output_interface_attribute(
                         outf,
+                        ir,
                         ife,
                         ife->u.interface.attributev + attrc);
         }
@@ -1432,7 +2302,7 @@ int output_interface(struct ir *ir, struct ir_entry *interfacee)
                             GENBIND_METHOD_TYPE_PREFACE);
 
         /* tool prologue */
-        output_tool_prologue(ifacef);
+        output_tool_prologue(ifacef, interfacee);
 
         /* binding prologue */
         output_method_cdata(ifacef,
@@ -1444,28 +2314,54 @@ int output_interface(struct ir *ir, struct ir_entry *interfacee)
                             interfacee->class,
                             GENBIND_METHOD_TYPE_PROLOGUE);
 
+        /* inline initialisors and finalisers, split per class with the
+         * class headers
+         */
+        if (options->inlineinit && !options->splitheaders) {
+                char *fpath;
+
+                fpath = genb_fpath("inline.h");
+                fprintf(ifacef, "#include \"%s\"\n", fpath);
+                free(fpath);
+        } else if (interface_init_inline(interfacee)) {
+                output_class_include(ifacef, interfacee, true);
+        } else if ((inherite != NULL) && interface_init_inline(inherite)) {
+                output_class_include(ifacef, inherite, true);
+        }
+
         fprintf(ifacef, "\n");
 
-        /* initialisor */
-        res = output_interface_init(ifacef, interfacee, inherite);
-        if (res != 0) {
-                goto op_error;
-        }
+        if (interface_init_inline(interfacee)) {
+                /* the constructor still needs the initialisor arguments */
+                interfacee->class_init_argc = interface_init_argc(interfacee);
+        } else {
+                /* initialisor */
+                res = output_interface_init(ifacef, interfacee, inherite);
+                if (res != 0) {
+                        goto op_error;
+                }
 
-        /* finaliser */
-        output_interface_fini(ifacef, interfacee, inherite);
+                /* finaliser */
+                output_interface_fini(ifacef, interfacee, inherite);
+        }
 
         /* constructor */
-        output_interface_constructor(ifacef, interfacee);
+        output_interface_constructor(ifacef, ir, interfacee);
 
         /* destructor */
-        output_interface_destructor(ifacef, interfacee);
+        output_interface_destructor(ifacef, ir, interfacee);
 
         /* operations */
-        output_interface_operations(ifacef, interfacee);
+        output_interface_operations(ifacef, ir, interfacee);
 
         /* attributes */
-        output_interface_attributes(ifacef, interfacee);
+        output_interface_attributes(ifacef, ir, interfacee);
+
+        /* indexed and named property proxy traps */
+        output_interface_proxy(ifacef, ir, interfacee);
+
+        /* iterable, maplike and setlike iteration */
+        output_interface_iterable(ifacef, ir, interfacee);
 
         /* prototype */
         output_interface_prototype(ifacef, ir, interfacee, inherite);
@@ -1498,6 +2394,28 @@ op_error:
         return res;
 }
 
+/* exported function documented in duk-libdom.h */
+int output_interface_inline(FILE* outf,
+                            struct ir *ir,
+                            struct ir_entry *interfacee)
+{
+        struct ir_entry *inherite;
+        int res;
+
+        if (!interface_init_inline(interfacee)) {
+                return 0;
+        }
+
+        inherite = ir_inherit_entry(ir, interfacee);
+
+        res = output_interface_init(outf, interfacee, inherite);
+        if (res != 0) {
+                return res;
+        }
+
+        return output_interface_fini(outf, interfacee, inherite);
+}
+
 /* exported function documented in duk-libdom.h */
 int output_interface_declaration(FILE* outf, struct ir_entry *interfacee)
 {
@@ -1524,6 +2442,13 @@ int output_interface_declaration(FILE* outf, struct ir_entry *interfacee)
                 return 0;
         }
 
+        /* inline initialisors and finalisers are defined in inline.h */
+        if (interface_init_inline(interfacee)) {
+                fprintf(outf, "\n");
+
+                return 0;
+        }
+
         /* finaliser declaration */
         fprintf(outf,
                 "void %s_%s___fini(duk_context *ctx, %s_private_t *priv);\n",
@@ -21,6 +21,8 @@
 #include "webidl-ast.h"
 #include "ir.h"
 #include "duk-libdom.h"
+#include "stats.h"
+#include "report.h"
 
 /** prefix for all generated functions */
 #define DLPFX "dukky"
@@ -110,75 +112,273 @@ static int close_header(struct ir *ir,
 
 
 /**
- * generate private header
+ * output the private structure of a class
+ */
+static void
+output_private_struct(FILE *privf, struct ir *ir, struct ir_entry *interfacee)
+{
+        struct ir_entry *inherite;
+        struct genbind_node *priv_node;
+
+        switch (interfacee->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                fprintf(privf,
+                        "/* Private data for %s interface */\n",
+                        interfacee->name);
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                fprintf(privf,
+                        "/* Private data for %s dictionary */\n",
+                        interfacee->name);
+                break;
+        }
+
+        fprintf(privf, "typedef struct {\n");
+
+        /* find parent entry and include in private */
+        inherite = ir_inherit_entry(ir, interfacee);
+        if (inherite != NULL) {
+                fprintf(privf, "\t%s_private_t parent;\n",
+                        inherite->class_name);
+        } else if (interfacee->type == IR_ENTRY_TYPE_INTERFACE) {
+                /* root classes hold the wrapper cache key */
+                fprintf(privf, "\tvoid *%s_wrapped;\n", DLPFX);
+                if (ir->event_handlers.valuec > 0) {
+                        /* and the event handler slots */
+                        fprintf(privf,
+                                "\tstruct %s_callback *%s_handlers;\n",
+                                DLPFX, DLPFX);
+                }
+        }
+
+        /* for each private variable on the class output it here. */
+        priv_node = genbind_node_find_type(
+                genbind_node_getnode(interfacee->class),
+                NULL,
+                GENBIND_NODE_TYPE_PRIVATE);
+        while (priv_node != NULL) {
+                fprintf(privf, "\t");
+
+                output_ctype(privf, priv_node, true);
+
+                fprintf(privf, ";\n");
+
+                priv_node = genbind_node_find_type(
+                        genbind_node_getnode(interfacee->class),
+                        priv_node,
+                        GENBIND_NODE_TYPE_PRIVATE);
+        }
+
+        fprintf(privf, "} __attribute__((aligned)) %s_private_t;\n\n", interfacee->class_name);
+}
+
+/**
+ * output the prototype declarations of a class
+ */
+static void output_class_declaration(FILE *protof, struct ir_entry *entry)
+{
+        switch (entry->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                output_interface_declaration(protof, entry);
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                output_dictionary_declaration(protof, entry);
+                break;
+        }
+}
+
+/**
+ * check if a class has no output
+ */
+static bool class_noobject(struct ir_entry *entry)
+{
+        return ((entry->type == IR_ENTRY_TYPE_INTERFACE) &&
+                (entry->u.interface.noobject));
+}
+
+/**
+ * generate the split header of a class
+ *
+ * The header holds the private structure and prototype declarations
+ *  of a single class and includes only the header of the class it
+ *  inherits from. Each class source includes just its own header so
+ *  changing a class only rebuilds the classes derived from it.
  */
 static int
-output_private_header(struct ir *ir)
+output_class_header(struct ir *ir, struct ir_entry *entry)
+{
+        struct ir_entry *inherite;
+        FILE *hdrf;
+
+        /* open header */
+        hdrf = open_header(ir, entry->class_name);
+        if (hdrf == NULL) {
+                return -1;
+        }
+
+        inherite = ir_inherit_entry(ir, entry);
+        if (inherite != NULL) {
+                output_class_include(hdrf, inherite, false);
+                fprintf(hdrf, "\n");
+        }
+
+        output_private_struct(hdrf, ir, entry);
+
+        output_class_declaration(hdrf, entry);
+
+        close_header(ir, hdrf, entry->class_name);
+
+        return 0;
+}
+
+/**
+ * generate the split inline initialisor header of a class
+ *
+ * The header holds the static inline initialisor and finaliser of a
+ *  class which is inherited from and includes the inline header of its
+ *  parent. Only the class and its descendants include it, after the
+ *  binding prologue, so changing a class does not rebuild unrelated
+ *  classes.
+ */
+static int
+output_class_inline_header(struct ir *ir, struct ir_entry *entry)
+{
+        struct ir_entry *inherite;
+        char *name;
+        int namel;
+        FILE *hdrf;
+        int res;
+
+        namel = strlen(entry->class_name) + SLEN("_inline") + 1;
+        name = malloc(namel);
+        if (name == NULL) {
+                return -1;
+        }
+        snprintf(name, namel, "%s_inline", entry->class_name);
+
+        /* open header */
+        hdrf = open_header(ir, name);
+        if (hdrf == NULL) {
+                free(name);
+                return -1;
+        }
+
+        output_class_include(hdrf, entry, false);
+
+        inherite = ir_inherit_entry(ir, entry);
+        if ((inherite != NULL) && interface_init_inline(inherite)) {
+                output_class_include(hdrf, inherite, true);
+        }
+        fprintf(hdrf, "\n");
+
+        res = output_interface_inline(hdrf, ir, entry);
+
+        close_header(ir, hdrf, name);
+        free(name);
+
+        return res;
+}
+
+/**
+ * generate umbrella header including the split header of every class
+ */
+static int
+output_umbrella_header(struct ir *ir, const char *name)
 {
         int idx;
-        FILE *privf;
+        FILE *hdrf;
 
         /* open header */
-        privf = open_header(ir, "private");
+        hdrf = open_header(ir, name);
+        if (hdrf == NULL) {
+                return -1;
+        }
 
         for (idx = 0; idx < ir->entryc; idx++) {
-                struct ir_entry *interfacee;
-                struct ir_entry *inherite;
-                struct genbind_node *priv_node;
+                struct ir_entry *entry;
 
-                interfacee = ir->entries + idx;
+                entry = ir->entries + idx;
 
-                /* do not generate private structs for interfaces marked no
-                 * output
-                 */
-                if ((interfacee->type == IR_ENTRY_TYPE_INTERFACE) &&
-                    (interfacee->u.interface.noobject)) {
-                        continue;
+                if (!class_noobject(entry)) {
+                        output_class_include(hdrf, entry, false);
                 }
+        }
 
-                switch (interfacee->type) {
-                case IR_ENTRY_TYPE_INTERFACE:
-                        fprintf(privf,
-                                "/* Private data for %s interface */\n",
-                                interfacee->name);
-                        break;
+        close_header(ir, hdrf, name);
 
-                case IR_ENTRY_TYPE_DICTIONARY:
-                        fprintf(privf,
-                                "/* Private data for %s dictionary */\n",
-                                interfacee->name);
-                        break;
+        return 0;
+}
+
+/**
+ * generate split class headers
+ *
+ * The private and prototype headers become umbrellas including the
+ *  header of every class.
+ */
+static int
+output_split_headers(struct ir *ir)
+{
+        int idx;
+        int res;
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                struct ir_entry *entry;
+
+                entry = ir->entries + idx;
+
+                /* no header for interfaces marked no output */
+                if (class_noobject(entry)) {
+                        continue;
                 }
 
-                fprintf(privf, "typedef struct {\n");
+                res = output_class_header(ir, entry);
+                if (res != 0) {
+                        return res;
+                }
 
-                /* find parent entry and include in private */
-                inherite = ir_inherit_entry(ir, interfacee);
-                if (inherite != NULL) {
-                        fprintf(privf, "\t%s_private_t parent;\n",
-                                inherite->class_name);
+                if (interface_init_inline(entry)) {
+                        res = output_class_inline_header(ir, entry);
+                        if (res != 0) {
+                                return res;
+                        }
                 }
+        }
 
-                /* for each private variable on the class output it here. */
-                priv_node = genbind_node_find_type(
-                        genbind_node_getnode(interfacee->class),
-                        NULL,
-                        GENBIND_NODE_TYPE_PRIVATE);
-                while (priv_node != NULL) {
-                        fprintf(privf, "\t");
+        res = output_umbrella_header(ir, "private");
+        if (res != 0) {
+                return res;
+        }
 
-                        output_ctype(privf, priv_node, true);
+        return output_umbrella_header(ir, "prototype");
+}
 
-                        fprintf(privf, ";\n");
+/**
+ * generate private header
+ */
+static int
+output_private_header(struct ir *ir)
+{
+        int idx;
+        FILE *privf;
 
-                        priv_node = genbind_node_find_type(
-                                genbind_node_getnode(interfacee->class),
-                                priv_node,
-                                GENBIND_NODE_TYPE_PRIVATE);
-                }
+        /* open header */
+        privf = open_header(ir, "private");
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                struct ir_entry *interfacee;
 
-                fprintf(privf, "} __attribute__((aligned)) %s_private_t;\n\n", interfacee->class_name);
+                interfacee = ir->entries + idx;
+
+                /* do not generate private structs for interfaces marked no
+                 * output
+                 */
+                if (class_noobject(interfacee)) {
+                        continue;
+                }
 
+                output_private_struct(privf, ir, interfacee);
         }
 
         close_header(ir, privf, "private");
@@ -198,23 +398,54 @@ output_prototype_header(struct ir *ir)
         /* open header */
         protof = open_header(ir, "prototype");
 
+        for (idx = 0; idx < ir->entryc; idx++) {
+                output_class_declaration(protof, ir->entries + idx);
+        }
+
+        close_header(ir, protof, "prototype");
+
+        return 0;
+}
+
+/**
+ * generate inline initialisor and finaliser header
+ *
+ * The header is included by every class after the binding prologue and
+ *  holds the static inline initialisors and finalisers of the
+ *  interfaces which are inherited from. Parents are output before their
+ *  children so the calls up an inheritance chain may all be inlined.
+ */
+static int
+output_inline_header(struct ir *ir)
+{
+        int idx;
+        int res;
+        FILE *inlinef;
+
+        /* open header */
+        inlinef = open_header(ir, "inline");
+        if (inlinef == NULL) {
+                return -1;
+        }
+
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *entry;
 
                 entry = ir->entries + idx;
 
-                switch (entry->type) {
-                case IR_ENTRY_TYPE_INTERFACE:
-                        output_interface_declaration(protof, entry);
-                        break;
+                if ((entry->type != IR_ENTRY_TYPE_INTERFACE) ||
+                    (entry->u.interface.noobject)) {
+                        continue;
+                }
 
-                case IR_ENTRY_TYPE_DICTIONARY:
-                        output_dictionary_declaration(protof, entry);
-                        break;
+                res = output_interface_inline(inlinef, ir, entry);
+                if (res != 0) {
+                        close_header(ir, inlinef, "inline");
+                        return res;
                 }
         }
 
-        close_header(ir, protof, "prototype");
+        close_header(ir, inlinef, "inline");
 
         return 0;
 }
@@ -258,6 +489,37 @@ output_makefile(struct ir *ir)
 }
 
 
+/**
+ * check if any interface in the binding has indexed or named properties
+ */
+static bool binding_has_property_getters(struct ir *ir)
+{
+        int idx;
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                if (interface_property_getters(ir, ir->entries + idx,
+                                               NULL, NULL, NULL)) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/**
+ * check if any interface in the binding has iteration generated
+ */
+static bool binding_has_iterables(struct ir *ir)
+{
+        int idx;
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                if (interface_iterable(ir, ir->entries + idx, NULL)) {
+                        return true;
+                }
+        }
+        return false;
+}
+
 /**
  * generate binding header
  *
@@ -272,6 +534,7 @@ static int
 output_binding_header(struct ir *ir)
 {
         FILE *bindf;
+        int idx;
 
         /* open header */
         bindf = open_header(ir, "binding");
@@ -296,18 +559,55 @@ output_binding_header(struct ir *ir)
                 "extern const char *%s_error_fmt_argument;\n"
                 "extern const char *%s_error_fmt_bool_type;\n"
                 "extern const char *%s_error_fmt_number_type;\n"
+                "extern const char *%s_error_fmt_enum_type;\n"
+                "extern const char *%s_error_fmt_callback_type;\n"
                 "extern const char *%s_magic_string_private;\n"
                 "extern const char *%s_magic_string_prototypes;\n"
                 "\n",
-                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
+
+        /* enumerations */
+        for (idx = 0; idx < ir->enumerationc; idx++) {
+                output_enumeration_declaration(bindf, ir->enumerations + idx);
+        }
+
+        /* callbacks */
+        if ((ir->callbackc > 0) || (ir->event_handlers.valuec > 0)) {
+                output_callback_handle_declaration(bindf);
+        }
+        for (idx = 0; idx < ir->callbackc; idx++) {
+                output_callback_declaration(bindf, ir->callbacks + idx);
+        }
+
+        if (ir->event_handlers.valuec > 0) {
+                output_event_handler_declaration(bindf, ir);
+        }
 
         fprintf(bindf,
                 "duk_bool_t %s_instanceof(duk_context *ctx, duk_idx_t index, const char *klass);\n",
                 DLPFX);
 
+        output_wrapper_declaration(bindf);
+
+        if (binding_has_property_getters(ir)) {
+                output_proxy_declaration(bindf);
+        }
+
+        if (binding_has_iterables(ir)) {
+                output_iterator_declaration(bindf);
+        }
+
+        if (options->prunestub) {
+                output_pruned_declaration(bindf);
+        }
+
         fprintf(bindf,
                 "duk_ret_t %s_create_prototypes(duk_context *ctx);\n", DLPFX);
 
+        output_profile_declaration(bindf);
+
+        output_profile_placement_declaration(bindf);
+
         close_header(ir, bindf, "binding");
 
         return 0;
@@ -324,6 +624,7 @@ static int
 output_binding_src(struct ir *ir)
 {
         int idx;
+        int res;
         FILE *bindf;
         struct ir_entry *pglobale = NULL;
         char *proto_name;
@@ -343,7 +644,7 @@ output_binding_src(struct ir *ir)
                             GENBIND_METHOD_TYPE_PREFACE);
 
         /* tool prologue */
-        output_tool_prologue(bindf);
+        output_tool_prologue(bindf, NULL);
 
         /* binding prologue */
         output_method_cdata(bindf,
@@ -356,11 +657,31 @@ output_binding_src(struct ir *ir)
                 "/* Error format strings */\n"
                 "const char *%s_error_fmt_argument =\"%%d argument required, but ony %%d present.\";\n"
                 "const char *%s_error_fmt_bool_type =\"argument %%d (%%s) requires a bool\";\n"
-                "const char *%s_error_fmt_number_type =\"argument %%d (%%s) requires a number\";\n",
-                DLPFX, DLPFX, DLPFX);
+                "const char *%s_error_fmt_number_type =\"argument %%d (%%s) requires a number\";\n"
+                "const char *%s_error_fmt_enum_type =\"argument %%d (%%s) is not a valid %%s\";\n"
+                "const char *%s_error_fmt_callback_type =\"argument %%d (%%s) is not a %%s callback\";\n",
+                DLPFX, DLPFX, DLPFX, DLPFX, DLPFX);
 
         fprintf(bindf, "\n");
 
+        /* enumeration conversions */
+        if ((ir->enumerationc > 0) || (ir->event_handlers.valuec > 0)) {
+                fprintf(bindf,
+                        "struct %s_enum_value {\n"
+                        "\tconst char *str;\n"
+                        "\tsize_t len;\n"
+                        "};\n\n",
+                        DLPFX);
+        }
+        for (idx = 0; idx < ir->enumerationc; idx++) {
+                res = output_enumeration_definition(bindf,
+                                                    ir->enumerations + idx);
+                if (res != 0) {
+                        fclose(bindf);
+                        return res;
+                }
+        }
+
         fprintf(bindf,
                 "/* Magic identifiers */\n"
                 "const char *%s_magic_string_private =\"%sPRIVATE\";\n"
@@ -369,6 +690,44 @@ output_binding_src(struct ir *ir)
 
         fprintf(bindf, "\n");
 
+        /* profiling counters */
+        output_profile_definition(bindf);
+
+        /* wrapper cache */
+        output_wrapper_definition(bindf);
+
+        /* indexed and named property proxy traps */
+        if (binding_has_property_getters(ir)) {
+                output_proxy_definition(bindf);
+        }
+
+        /* iterators of iterable, maplike and setlike interfaces */
+        if (binding_has_iterables(ir)) {
+                output_iterator_definition(bindf);
+        }
+
+        /* shared stub for pruned members */
+        if (options->prunestub) {
+                output_pruned_definition(bindf);
+        }
+
+        /* callback handles and invocation */
+        if ((ir->callbackc > 0) || (ir->event_handlers.valuec > 0)) {
+                output_callback_handle_definition(bindf);
+        }
+        for (idx = 0; idx < ir->callbackc; idx++) {
+                output_callback_definition(bindf, ir->callbacks + idx);
+        }
+
+        /* event handler slots */
+        if (ir->event_handlers.valuec > 0) {
+                res = output_event_handler_definition(bindf, ir);
+                if (res != 0) {
+                        fclose(bindf);
+                        return res;
+                }
+        }
+
 
         /* instanceof helper */
         fprintf(bindf,
@@ -465,6 +824,12 @@ output_binding_src(struct ir *ir)
 
         fprintf(bindf, "{\n");
 
+        if (binding_has_iterables(ir)) {
+                fprintf(bindf,
+                        "\t%s_create_prototype(ctx, %s_iterator___proto, \"%sITERATOR_PROTOTYPE\", \"Iterator\");\n",
+                        DLPFX, DLPFX, MAGICPFX);
+        }
+
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *interfacee;
 
@@ -528,6 +893,53 @@ output_binding_src(struct ir *ir)
         return 0;
 }
 
+/**
+ * start the report on an entry with its inheritance depth and the
+ * number of members in its private structure
+ */
+static void report_ir_entry(struct ir *ir, struct ir_entry *entry)
+{
+        struct ir_entry *cure;
+        struct genbind_node *priv_node;
+        int depth = 0;
+        int privatec = 0;
+
+        if (!options->report) {
+                return;
+        }
+
+        for (cure = entry; cure != NULL; cure = ir_inherit_entry(ir, cure)) {
+                priv_node = genbind_node_find_type(
+                        genbind_node_getnode(cure->class),
+                        NULL,
+                        GENBIND_NODE_TYPE_PRIVATE);
+                while (priv_node != NULL) {
+                        privatec++;
+                        priv_node = genbind_node_find_type(
+                                genbind_node_getnode(cure->class),
+                                priv_node,
+                                GENBIND_NODE_TYPE_PRIVATE);
+                }
+
+                if (ir_inherit_entry(ir, cure) != NULL) {
+                        depth++;
+                } else if (cure->type == IR_ENTRY_TYPE_INTERFACE) {
+                        /* wrapper cache key and event handler slots */
+                        privatec++;
+                        if (ir->event_handlers.valuec > 0) {
+                                privatec++;
+                        }
+                }
+        }
+
+        report_entry(entry->name,
+                     (entry->type == IR_ENTRY_TYPE_INTERFACE) ?
+                     "interface" : "dictionary",
+                     entry->filename,
+                     depth,
+                     privatec);
+}
+
 static int output_interfaces_dictionaries(struct ir *ir)
 {
         int res;
@@ -536,15 +948,24 @@ static int output_interfaces_dictionaries(struct ir *ir)
         /* generate interfaces */
         for (idx = 0; idx < ir->entryc; idx++) {
                 struct ir_entry *irentry;
+                struct stats_mark start;
 
                 irentry = ir->entries + idx;
 
+                /* output generated from the same input is unchanged */
+                if (irentry->current) {
+                        continue;
+                }
+
+                stats_mark(&start);
+
                 switch (irentry->type) {
                 case IR_ENTRY_TYPE_INTERFACE:
                         /* do not generate class for interfaces marked no
                          * output
                          */
                         if (!irentry->u.interface.noobject) {
+                                report_ir_entry(ir, irentry);
                                 res = output_interface(ir, irentry);
                                 if (res != 0) {
                                         return res;
@@ -553,6 +974,7 @@ static int output_interfaces_dictionaries(struct ir *ir)
                         break;
 
                 case IR_ENTRY_TYPE_DICTIONARY:
+                        report_ir_entry(ir, irentry);
                         res = output_dictionary(ir, irentry);
                         if (res != 0) {
                                 return res;
@@ -561,6 +983,8 @@ static int output_interfaces_dictionaries(struct ir *ir)
                 default:
                         break;
                 }
+
+                stats_entry(irentry->name, &start);
         }
 
         return 0;
@@ -577,7 +1001,10 @@ int duk_libdom_output(struct ir *ir)
 
                 irentry = ir->entries + idx;
 
-                /* compute class name */
+                /* compute class name, replacing any from earlier output */
+                free(irentry->class_name);
+                free(irentry->filename);
+                irentry->filename = NULL;
                 irentry->class_name = gen_idl2c_name(irentry->name);
 
                 if (irentry->class_name != NULL) {
@@ -593,23 +1020,60 @@ int duk_libdom_output(struct ir *ir)
                 }
         }
 
-        res = output_interfaces_dictionaries(ir);
-        if (res != 0) {
-                goto output_err;
+        for (idx = 0; idx < ir->enumerationc; idx++) {
+                struct ir_enumeration_entry *enumeratione;
+
+                enumeratione = ir->enumerations + idx;
+                free(enumeratione->class_name);
+                enumeratione->class_name = gen_idl2c_name(enumeratione->name);
         }
 
-        /* generate private header */
-        res = output_private_header(ir);
+        for (idx = 0; idx < ir->callbackc; idx++) {
+                struct ir_callback_entry *callbacke;
+
+                callbacke = ir->callbacks + idx;
+                free(callbacke->class_name);
+                callbacke->class_name = gen_idl2c_name(callbacke->name);
+        }
+
+        res = event_handler_slots_new(ir);
         if (res != 0) {
                 goto output_err;
         }
 
-        /* generate prototype header */
-        res = output_prototype_header(ir);
+        res = output_interfaces_dictionaries(ir);
         if (res != 0) {
                 goto output_err;
         }
 
+        if (options->splitheaders) {
+                /* generate class headers */
+                res = output_split_headers(ir);
+                if (res != 0) {
+                        goto output_err;
+                }
+        } else {
+                /* generate private header */
+                res = output_private_header(ir);
+                if (res != 0) {
+                        goto output_err;
+                }
+
+                /* generate prototype header */
+                res = output_prototype_header(ir);
+                if (res != 0) {
+                        goto output_err;
+                }
+        }
+
+        /* generate inline initialisor header unless split by class */
+        if (options->inlineinit && !options->splitheaders) {
+                res = output_inline_header(ir);
+                if (res != 0) {
+                        goto output_err;
+                }
+        }
+
         /* generate binding header */
         res = output_binding_header(ir);
         if (res != 0) {
@@ -24,6 +24,23 @@ int output_interface(struct ir *ir, struct ir_entry *interfacee);
  */
 int output_interface_declaration(FILE* outf, struct ir_entry *interfacee);
 
+/**
+ * check if the initialisor and finaliser of an interface are inline.
+ *
+ * With inlining enabled the initialisors and finalisers of interfaces
+ *  which are inherited from are defined static inline in inline.h so
+ *  the chain of calls made when a wrapper is constructed or destroyed
+ *  may be inlined into each class. Interfaces whose class has preface,
+ *  prologue, epilogue or postface code keep their out of line
+ *  definitions as their code may depend on it.
+ */
+bool interface_init_inline(struct ir_entry *interfacee);
+
+/**
+ * generate inline initialisor and finaliser definitions for an interface.
+ */
+int output_interface_inline(FILE* outf, struct ir *ir, struct ir_entry *interfacee);
+
 /**
  * generate a source file to implement a dictionary using duk and libdom.
  */
@@ -34,15 +51,78 @@ int output_dictionary(struct ir *ir, struct ir_entry *dictionarye);
  */
 int output_dictionary_declaration(FILE* outf, struct ir_entry *dictionarye);
 
+/**
+ * generate the C enumeration and conversion function declarations for
+ * an enumeration.
+ */
+int output_enumeration_declaration(FILE* outf, struct ir_enumeration_entry *enumeratione);
+
+/**
+ * output the C identifier of an enumeration value.
+ *
+ * The value is uppercased with characters not valid in an identifier
+ *  replaced by underscores. The empty string becomes EMPTY and a value
+ *  which would clash with an earlier one has its index appended.
+ */
+int output_enumeration_value_name(FILE* outf, struct ir_enumeration_entry *enumeratione, int vidx);
+
+/**
+ * generate the conversion functions for an enumeration.
+ *
+ * Strings are converted to values through a perfect hash computed
+ *  when the binding is generated.
+ */
+int output_enumeration_definition(FILE* outf, struct ir_enumeration_entry *enumeratione);
+
+/**
+ * generate the callback handle declarations.
+ */
+int output_callback_handle_declaration(FILE* outf);
+
+/**
+ * generate the callback handle implementation.
+ *
+ * Handles pin their function in the global stash so it is invoked
+ *  through its heap pointer without a property lookup.
+ */
+int output_callback_handle_definition(FILE* outf);
+
+/**
+ * generate the invocation function declaration for a callback.
+ */
+int output_callback_declaration(FILE* outf, struct ir_callback_entry *callbacke);
+
+/**
+ * generate the invocation function for a callback.
+ *
+ * Arguments are converted from C values or duplicated from the value
+ *  stack and the function called directly. The result or error is
+ *  left on the stack.
+ */
+int output_callback_definition(FILE* outf, struct ir_callback_entry *callbacke);
+
 /**
  * generate preface block for nsgenbind
  */
 int output_tool_preface(FILE* outf);
 
 /**
- * generate preface block for nsgenbind
+ * generate prologue block for nsgenbind
+ *
+ * \param outf The file to output to.
+ * \param entry The class being output or NULL for the binding source.
+ */
+int output_tool_prologue(FILE* outf, struct ir_entry *entry);
+
+/**
+ * generate an include of the split header of a class
+ *
+ * \param outf The file to output to.
+ * \param entry The class whose header is included.
+ * \param inlineinit Include the header holding the inline initialisor
+ *                   and finaliser of the class instead.
  */
-int output_tool_prologue(FILE* outf);
+int output_class_include(FILE* outf, struct ir_entry *entry, bool inlineinit);
 
 /**
  * output character data of node of given type.
@@ -96,6 +176,18 @@ int output_method_cdata(FILE* outf, struct genbind_node *node, enum genbind_meth
  */
 int output_ctype(FILE *outf, struct genbind_node *node, bool identifier);
 
+/**
+ * output a string as a quoted C string literal.
+ *
+ * Quotes, backslashes and characters which are not printable ASCII are
+ * escaped so the literal has the same content as the string.
+ *
+ * \param outf The file handle to write output.
+ * \param str The string to output.
+ * \return 0 on success.
+ */
+int output_cstring(FILE* outf, const char *str);
+
 /**
  * Generate a C name from an IDL name.
  *
@@ -121,5 +213,161 @@ int output_generated_attribute_setter(FILE* outf, struct ir_entry *interfacee, s
  */
 int output_generated_attribute_getter(FILE* outf, struct ir_entry *interfacee, struct ir_attribute_entry *atributee);
 
+/**
+ * Find if an attribute is an onxxx event handler.
+ */
+bool attribute_is_event_handler(struct ir_attribute_entry *atributee);
+
+/**
+ * Assign the event handler slots of a binding.
+ *
+ * Each distinct event name of the onxxx event handler attributes on
+ *  all interfaces is given a dense slot index in name order so
+ *  handlers are stored and dispatched by array index.
+ *
+ * \param ir The intermediate representation to update.
+ * \return 0 on success or -1 on memory exhaustion.
+ */
+int event_handler_slots_new(struct ir *ir);
+
+/**
+ * Output event handler slot declarations.
+ */
+int output_event_handler_declaration(FILE* outf, struct ir *ir);
+
+/**
+ * Output event handler slot implementation.
+ *
+ * Must follow the callback handle implementation which holds the
+ *  handlers.
+ */
+int output_event_handler_definition(FILE* outf, struct ir *ir);
+
+/**
+ * Output profiling counter update at the start of a generated function.
+ *
+ * Each call allocates the next identifier in the profile table of the
+ *  binding. Nothing is output unless profiling is enabled.
+ *
+ * \param outf The file handle to write output.
+ * \param entry The interface the function is generated for.
+ * \param member The name of the member or NULL for the interface itself.
+ * \param kind The kind of function e.g. "getter" or NULL.
+ * \return 0 on success.
+ */
+int output_profile_counter(FILE* outf, struct ir_entry *entry, const char *member, const char *kind);
+
+/**
+ * Output profiling table declaration and accessor prototypes.
+ */
+int output_profile_declaration(FILE* outf);
+
+/**
+ * Output profiling table and accessor implementation.
+ *
+ * The table contains an entry for every counter output since the last call.
+ */
+int output_profile_definition(FILE* outf);
+
+/**
+ * Output placement of a generated function from the call frequency profile.
+ *
+ * The functions accounting for most calls in the profile are marked hot
+ *  and those never called are marked cold. Nothing is output unless a
+ *  profile is in use.
+ *
+ * \param outf The file handle to write output.
+ * \param ir The intermediate representation holding the profile.
+ * \param entry The interface the function is generated for.
+ * \param member The name of the member or NULL for the interface itself.
+ * \param kind The kind of function e.g. "getter" or NULL.
+ * \return 0 on success.
+ */
+int output_profile_placement(FILE* outf, struct ir *ir, struct ir_entry *entry, const char *member, const char *kind);
+
+/**
+ * Output hot and cold function placement macros.
+ */
+int output_profile_placement_declaration(FILE* outf);
+
+/**
+ * Output the prototype of the stub used for pruned members.
+ */
+int output_pruned_declaration(FILE* outf);
+
+/**
+ * Output the stub used for pruned members.
+ *
+ * Methods and attribute accessors pruned from the binding share a single
+ *  function which throws a TypeError when called.
+ */
+int output_pruned_definition(FILE* outf);
+
+/**
+ * Output wrapper cache accessor prototypes.
+ */
+int output_wrapper_declaration(FILE* outf);
+
+/**
+ * Output wrapper cache implementation.
+ *
+ * The cache maps native objects to the duktape objects wrapping them
+ *  through a hash table keyed by the native object pointer.
+ */
+int output_wrapper_definition(FILE* outf);
+
+/**
+ * Find the property getters of an interface.
+ *
+ * The nearest indexed and named property getters with a binding
+ *  implementation and length attribute along the inheritance chain
+ *  are found.
+ *
+ * \param ir The intermediate representation.
+ * \param interfacee The interface to examine.
+ * \param indexed_out Updated with the indexed getter or NULL.
+ * \param named_out Updated with the named getter or NULL.
+ * \param length_out Updated with the length attribute or NULL.
+ * \return true if the interface has indexed or named properties.
+ */
+bool interface_property_getters(struct ir *ir, struct ir_entry *interfacee, struct ir_operation_entry **indexed_out, struct ir_operation_entry **named_out, struct ir_attribute_entry **length_out);
+
+/**
+ * Output indexed and named property proxy trap declarations.
+ */
+int output_proxy_declaration(FILE* outf);
+
+/**
+ * Output indexed and named property proxy trap implementation.
+ *
+ * Must follow the wrapper cache implementation which holds the
+ *  cached collection lengths.
+ */
+int output_proxy_definition(FILE* outf);
+
+/**
+ * Find if iteration is generated for an interface.
+ *
+ * Iteration is generated for an iterable, maplike or setlike
+ *  declaration with a binding method implementing it. Value iterators
+ *  may instead use the indexed property getter and length attribute.
+ *
+ * \param ir The intermediate representation.
+ * \param interfacee The interface to examine.
+ * \param indexed_out Updated with the indexed getter used or NULL.
+ * \return true if iteration is generated for the interface.
+ */
+bool interface_iterable(struct ir *ir, struct ir_entry *interfacee, struct ir_operation_entry **indexed_out);
+
+/**
+ * Output iterator declarations.
+ */
+int output_iterator_declaration(FILE* outf);
+
+/**
+ * Output iterator implementation and prototype.
+ */
+int output_iterator_definition(FILE* outf);
+
 
 #endif
@@ -126,6 +126,183 @@ entry_topoligical_sort(struct ir_entry *srcinf, int infc)
         return dstinf;
 }
 
+/** a binding method in the method index */
+struct method_entry {
+        enum genbind_method_type type; /**< type of method */
+        const char *ident; /**< identifier of method */
+        struct genbind_node *node; /**< method node */
+        bool used; /**< the method has been matched to an IDL member */
+};
+
+/**
+ * index of the methods on a binding class
+ *
+ * Keyed by method type and identifier, open addressed with linear
+ * probing, size is a power of two. Where a class has no index (no
+ * binding class or the allocation failed) lookups search the class.
+ */
+struct method_index {
+        struct genbind_node *class; /**< class the index is of */
+        unsigned int size;
+        struct method_entry *entries;
+};
+
+static struct method_entry *
+method_index_slot(struct method_index *index,
+                  enum genbind_method_type type,
+                  const char *ident)
+{
+        unsigned int slot;
+
+        slot = genb_hash(genb_hash(GENB_HASH_INIT, &type, sizeof(type)),
+                         ident,
+                         strlen(ident)) & (index->size - 1);
+        while ((index->entries[slot].ident != NULL) &&
+               ((index->entries[slot].type != type) ||
+                (strcmp(index->entries[slot].ident, ident) != 0))) {
+                slot = (slot + 1) & (index->size - 1);
+        }
+        return &index->entries[slot];
+}
+
+static int method_index_add(struct genbind_node *method_node, void *ctx)
+{
+        struct method_index *index = ctx;
+        struct method_entry *entry;
+        enum genbind_method_type *type;
+        const char *ident;
+
+        type = (enum genbind_method_type *)genbind_node_getint(
+                genbind_node_find_type(
+                        genbind_node_getnode(method_node),
+                        NULL,
+                        GENBIND_NODE_TYPE_METHOD_TYPE));
+        ident = genbind_node_gettext(
+                genbind_node_find_type(
+                        genbind_node_getnode(method_node),
+                        NULL,
+                        GENBIND_NODE_TYPE_IDENT));
+        if ((type == NULL) || (ident == NULL)) {
+                return 0;
+        }
+
+        /* the first method of a type and identifier is used */
+        entry = method_index_slot(index, *type, ident);
+        if (entry->ident == NULL) {
+                entry->type = *type;
+                entry->ident = ident;
+                entry->node = method_node;
+        }
+
+        return 0;
+}
+
+/**
+ * build the index of methods on a binding class
+ */
+static int
+method_index_new(struct genbind_node *class, struct method_index *index)
+{
+        int methodc;
+
+        index->class = class;
+        index->size = 0;
+        index->entries = NULL;
+
+        if (class == NULL) {
+                return 0;
+        }
+
+        methodc = genbind_node_enumerate_type(genbind_node_getnode(class),
+                                              GENBIND_NODE_TYPE_METHOD);
+        index->size = 16;
+        while (index->size < (unsigned int)(methodc * 2)) {
+                index->size *= 2;
+        }
+        index->entries = calloc(index->size, sizeof(struct method_entry));
+        if (index->entries == NULL) {
+                index->size = 0;
+                return -1;
+        }
+
+        genbind_node_foreach_type(genbind_node_getnode(class),
+                                  GENBIND_NODE_TYPE_METHOD,
+                                  method_index_add,
+                                  index);
+
+        return 0;
+}
+
+/**
+ * find the binding method of a type and identifier for an IDL member
+ */
+static struct genbind_node *
+method_index_find(struct method_index *index,
+                  enum genbind_method_type type,
+                  const char *ident)
+{
+        struct method_entry *entry;
+
+        if ((index->entries == NULL) || (ident == NULL)) {
+                return genbind_node_find_method_ident(index->class,
+                                                      NULL,
+                                                      type,
+                                                      ident);
+        }
+
+        entry = method_index_slot(index, type, ident);
+        if (entry->ident == NULL) {
+                return NULL;
+        }
+        entry->used = true;
+
+        return entry->node;
+}
+
+/**
+ * report binding methods which matched no IDL member and free the index
+ */
+static void
+method_index_free(struct method_index *index, const char *name)
+{
+        unsigned int slot;
+        struct method_entry *entry;
+        const char *kind;
+
+        for (slot = 0; slot < index->size; slot++) {
+                entry = index->entries + slot;
+                if ((entry->ident == NULL) || entry->used) {
+                        continue;
+                }
+
+                switch (entry->type) {
+                case GENBIND_METHOD_TYPE_METHOD:
+                        kind = "method";
+                        break;
+
+                case GENBIND_METHOD_TYPE_GETTER:
+                        kind = "getter";
+                        break;
+
+                case GENBIND_METHOD_TYPE_SETTER:
+                        kind = "setter";
+                        break;
+
+                default:
+                        kind = NULL;
+                        break;
+                }
+
+                if (kind != NULL) {
+                        WARN(WARNING_UNUSED,
+                             "Binding %s %s::%s matches no IDL member",
+                             kind, name, entry->ident);
+                }
+        }
+
+        free(index->entries);
+}
+
 static struct ir_operation_entry *
 find_operation_name(struct ir_operation_entry *operationv,
                      int operationc,
@@ -152,6 +329,177 @@ find_operation_name(struct ir_operation_entry *operationv,
         return NULL;
 }
 
+/**
+ * Create IR entry for a type
+ */
+static int
+type_map_new(struct webidl_node *node,
+             int *typec_out,
+             struct ir_type_entry **typev_out)
+{
+        int typec;
+        struct webidl_node *type_node;
+        struct ir_type_entry *typev;
+        struct ir_type_entry *cure;
+
+        typec = webidl_node_enumerate_type(
+                            webidl_node_getnode(node),
+                            WEBIDL_NODE_TYPE_TYPE);
+        if (typec == 0) {
+                *typec_out = 0;
+                *typev_out = NULL;
+                return 0;
+        }
+
+        typev = calloc(typec, sizeof(*typev));
+        cure = typev;
+
+        type_node = webidl_node_find_type(webidl_node_getnode(node),
+                                          NULL,
+                                          WEBIDL_NODE_TYPE_TYPE);
+
+        while (type_node != NULL) {
+                enum webidl_type *base;
+                enum webidl_type_modifier *modifier;
+
+                /* type base */
+                base = (enum webidl_type *)webidl_node_getint(
+                        webidl_node_find_type(
+                                webidl_node_getnode(type_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_TYPE_BASE));
+                if (base != NULL) {
+                        cure->base = *base;
+                }
+
+                /* type modifier */
+                modifier = (enum webidl_type_modifier *)webidl_node_getint(
+                        webidl_node_find_type(
+                                webidl_node_getnode(type_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_MODIFIER));
+                if (modifier != NULL) {
+                        cure->modifier = *modifier;
+                } else {
+                        cure->modifier = WEBIDL_TYPE_MODIFIER_NONE;
+                }
+
+                /* type nullability */
+                cure->nullable = (webidl_node_find_type(
+                        webidl_node_getnode(type_node),
+                        NULL,
+                        WEBIDL_NODE_TYPE_TYPE_NULLABLE) != NULL);
+
+                /* type name */
+                cure->name = webidl_node_gettext(
+                        webidl_node_find_type(
+                                webidl_node_getnode(type_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_IDENT));
+
+                /* next entry */
+                cure++;
+
+                type_node = webidl_node_find_type(
+                        webidl_node_getnode(node),
+                        type_node,
+                        WEBIDL_NODE_TYPE_TYPE);
+        }
+
+        *typec_out = typec;
+        *typev_out = typev;
+
+        return 0;
+}
+
+/**
+ * Create IR entry for the default value of an optional argument
+ */
+static int
+default_map_new(struct webidl_node *node, struct ir_default_entry *defl)
+{
+        struct webidl_node *lit_node;
+        int *lit_int;
+        float *lit_flt;
+
+        defl->type = IR_DEFAULT_NONE;
+
+        lit_node = webidl_node_getnode(
+                webidl_node_find_type(
+                        webidl_node_getnode(node),
+                        NULL,
+                        WEBIDL_NODE_TYPE_OPTIONAL));
+        if (lit_node == NULL) {
+                return 0;
+        }
+
+        switch (webidl_node_gettype(lit_node)) {
+        case WEBIDL_NODE_TYPE_LITERAL_NULL:
+                defl->type = IR_DEFAULT_NULL;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_BOOL:
+                lit_int = webidl_node_getint(lit_node);
+                defl->type = IR_DEFAULT_BOOL;
+                defl->intval = *lit_int;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_INT:
+                lit_int = webidl_node_getint(lit_node);
+                defl->type = IR_DEFAULT_INT;
+                defl->intval = *lit_int;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_FLOAT:
+                lit_flt = webidl_node_getfloat(lit_node);
+                defl->type = IR_DEFAULT_FLOAT;
+                defl->fltval = *lit_flt;
+                break;
+
+        case WEBIDL_NODE_TYPE_LITERAL_STRING:
+                defl->type = IR_DEFAULT_STRING;
+                defl->text = webidl_node_gettext(lit_node);
+                break;
+
+        default:
+                break;
+        }
+
+        return 0;
+}
+
+/**
+ * fill an argument entry from an argument node
+ *
+ * Operation arguments and dictionary members share the argument node
+ * and entry so the generators can use the decoded type and default
+ * without walking the AST.
+ */
+static int
+argument_entry_new(struct webidl_node *argument,
+                   struct ir_operation_argument_entry *cure)
+{
+        cure->name = webidl_node_gettext(
+                webidl_node_find_type(
+                        webidl_node_getnode(argument),
+                        NULL,
+                        WEBIDL_NODE_TYPE_IDENT));
+
+        cure->node = argument;
+
+        cure->optionalc = webidl_node_enumerate_type(
+                webidl_node_getnode(argument),
+                WEBIDL_NODE_TYPE_OPTIONAL);
+
+        cure->elipsisc = webidl_node_enumerate_type(
+                webidl_node_getnode(argument),
+                WEBIDL_NODE_TYPE_ELLIPSIS);
+
+        type_map_new(argument, &cure->typec, &cure->typev);
+
+        return default_map_new(argument, &cure->defl);
+}
+
 static int
 argument_map_new(struct webidl_node *arg_list_node,
                  int *argumentc_out,
@@ -181,21 +529,7 @@ argument_map_new(struct webidl_node *arg_list_node,
 
         while (argument != NULL) {
 
-                cure->name = webidl_node_gettext(
-                                webidl_node_find_type(
-                                        webidl_node_getnode(argument),
-                                        NULL,
-                                        WEBIDL_NODE_TYPE_IDENT));
-
-                cure->node = argument;
-
-                cure->optionalc = webidl_node_enumerate_type(
-                        webidl_node_getnode(argument),
-                        WEBIDL_NODE_TYPE_OPTIONAL);
-
-                cure->elipsisc = webidl_node_enumerate_type(
-                        webidl_node_getnode(argument),
-                        WEBIDL_NODE_TYPE_ELLIPSIS);
+                argument_entry_new(argument, cure);
 
                 cure++;
 
@@ -211,6 +545,17 @@ argument_map_new(struct webidl_node *arg_list_node,
         return 0;
 }
 
+static void
+argument_map_free(int argumentc, struct ir_operation_argument_entry *argumentv)
+{
+        int idx;
+
+        for (idx = 0; idx < argumentc; idx++) {
+                free(argumentv[idx].typev);
+        }
+        free(argumentv);
+}
+
 /**
  * create a new overloaded parameter set on an operation
  *
@@ -270,17 +615,100 @@ overload_map_new(struct webidl_node *op_node,
         return 0;
 }
 
+static void
+overload_map_free(int overloadc, struct ir_operation_overload_entry *overloadv)
+{
+        int idx;
+
+        for (idx = 0; idx < overloadc; idx++) {
+                argument_map_free(overloadv[idx].argumentc,
+                                  overloadv[idx].argumentv);
+        }
+        free(overloadv);
+}
+
+/**
+ * check if an operation node has the getter special
+ */
+static bool operation_is_getter(struct webidl_node *op_node)
+{
+        struct webidl_node *special;
+        int *special_type;
+
+        special = webidl_node_find_type(webidl_node_getnode(op_node),
+                                        NULL,
+                                        WEBIDL_NODE_TYPE_SPECIAL);
+        while (special != NULL) {
+                special_type = webidl_node_getint(special);
+                if ((special_type != NULL) &&
+                    (*special_type == WEBIDL_TYPE_SPECIAL_GETTER)) {
+                        return true;
+                }
+                special = webidl_node_find_type(webidl_node_getnode(op_node),
+                                                special,
+                                                WEBIDL_NODE_TYPE_SPECIAL);
+        }
+        return false;
+}
+
+/**
+ * record an operation overload which is a property getter
+ *
+ * The type of the single argument selects between indexed and named
+ *  property getters. Getters without an identifier have no binding
+ *  method to call and are left unimplemented.
+ */
+static void
+special_getter_map(struct ir_operation_entry *operatione,
+                   struct ir_operation_overload_entry *overloade,
+                   struct ir_operation_entry **indexed_out,
+                   struct ir_operation_entry **named_out)
+{
+        if (operatione->name == NULL) {
+                return;
+        }
+
+        if ((overloade->argumentc != 1) ||
+            (overloade->argumentv[0].typec != 1)) {
+                WARN(WARNING_WEBIDL,
+                     "property getter %s must take a single argument",
+                     operatione->name);
+                return;
+        }
+
+        switch (overloade->argumentv[0].typev[0].base) {
+        case WEBIDL_TYPE_SHORT:
+        case WEBIDL_TYPE_LONG:
+        case WEBIDL_TYPE_LONGLONG:
+                *indexed_out = operatione;
+                break;
+
+        case WEBIDL_TYPE_STRING:
+                *named_out = operatione;
+                break;
+
+        default:
+                WARN(WARNING_WEBIDL,
+                     "property getter %s argument is not an index or name",
+                     operatione->name);
+                break;
+        }
+}
+
 static int
 operation_map_new(struct webidl_node *interface,
-                  struct genbind_node *class,
+                  struct method_index *methods,
                   int *operationc_out,
-                  struct ir_operation_entry **operationv_out)
+                  struct ir_operation_entry **operationv_out,
+                  struct ir_operation_entry **indexed_out,
+                  struct ir_operation_entry **named_out)
 {
         struct webidl_node *list_node;
         struct webidl_node *op_node; /* attribute node */
         struct ir_operation_entry *cure; /* current entry */
         struct ir_operation_entry *operationv;
         int operationc;
+        int entryc;
 
         /* enumerate operationss including overloaded members */
         operationc = enumerate_interface_type(interface,
@@ -299,6 +727,7 @@ operation_map_new(struct webidl_node *interface,
                 return -1;
         };
         cure = operationv;
+        entryc = operationc;
 
         /* iterate each list node within the interface */
         list_node = webidl_node_find_type(
@@ -336,15 +765,15 @@ operation_map_new(struct webidl_node *interface,
 
                                 cure->node = op_node;
 
-                                cure->method = genbind_node_find_method_ident(
-                                               class,
-                                               NULL,
+                                cure->method = method_index_find(
+                                               methods,
                                                GENBIND_METHOD_TYPE_METHOD,
                                                cure->name);
 
                                 overload_map_new(op_node,
                                                  &cure->overloadc,
                                                  &cure->overloadv);
+                                finde = cure;
 
                                 cure++; /* advance to next entry */
                         } else {
@@ -358,6 +787,15 @@ operation_map_new(struct webidl_node *interface,
                                 operationc--;
                         }
 
+                        /* property getters */
+                        if ((finde->overloadc > 0) &&
+                            operation_is_getter(op_node)) {
+                                special_getter_map(finde,
+                                        finde->overloadv + (finde->overloadc - 1),
+                                        indexed_out,
+                                        named_out);
+                        }
+
                         /* move to next operation */
                         op_node = webidl_node_find_type(
                                 webidl_node_getnode(list_node),
@@ -371,6 +809,13 @@ operation_map_new(struct webidl_node *interface,
                         WEBIDL_NODE_TYPE_LIST);
         }
 
+        /* unnamed operations match the first unused entry, any overloads
+         * left on it are beyond the end of the map
+         */
+        if ((cure - operationv) < entryc) {
+                overload_map_free(cure->overloadc, cure->overloadv);
+        }
+
         *operationc_out = operationc;
         *operationv_out = operationv; /* resulting operations map */
 
@@ -429,94 +874,57 @@ get_extended_value(struct webidl_node *node, const char *key)
 
 
 /**
- * Create IR entry for a type
+ * get the caching allowed for an attribute getter result
+ *
+ * [SameObject] and [Constant] attributes always return the same value
+ *  and [Pure] attributes the same value until the object changes.
+ *  Only readonly attributes are cached as a setter would change the
+ *  result.
  */
-static int
-type_map_new(struct webidl_node *node,
-             int *typec_out,
-             struct ir_type_entry **typev_out)
+static enum ir_attribute_cache
+attribute_cache_type(struct webidl_node *at_node,
+                     const char *name,
+                     enum webidl_type_modifier modifier)
 {
-        int typec;
-        struct webidl_node *type_node;
-        struct ir_type_entry *typev;
-        struct ir_type_entry *cure;
-
-        typec = webidl_node_enumerate_type(
-                            webidl_node_getnode(node),
-                            WEBIDL_NODE_TYPE_TYPE);
-        if (typec == 0) {
-                *typec_out = 0;
-                *typev_out = NULL;
-                return 0;
+        enum ir_attribute_cache cache = IR_ATTRIBUTE_CACHE_NONE;
+        const char *ext = NULL;
+
+        if (webidl_node_find_type_ident(webidl_node_getnode(at_node),
+                                        WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                                        "SameObject") != NULL) {
+                cache = IR_ATTRIBUTE_CACHE_INSTANCE;
+                ext = "SameObject";
+        } else if (webidl_node_find_type_ident(
+                           webidl_node_getnode(at_node),
+                           WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                           "Constant") != NULL) {
+                cache = IR_ATTRIBUTE_CACHE_INSTANCE;
+                ext = "Constant";
+        } else if (webidl_node_find_type_ident(
+                           webidl_node_getnode(at_node),
+                           WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
+                           "Pure") != NULL) {
+                cache = IR_ATTRIBUTE_CACHE_GENERATION;
+                ext = "Pure";
         }
 
-        typev = calloc(typec, sizeof(*typev));
-        cure = typev;
+        if ((cache != IR_ATTRIBUTE_CACHE_NONE) &&
+            (modifier != WEBIDL_TYPE_MODIFIER_READONLY)) {
+                WARN(WARNING_WEBIDL,
+                     "%s on a writable attribute (%s) is ignored",
+                     ext, name);
+                cache = IR_ATTRIBUTE_CACHE_NONE;
+        }
 
-        type_node = webidl_node_find_type(webidl_node_getnode(node),
-                                          NULL,
-                                          WEBIDL_NODE_TYPE_TYPE);
-
-        while (type_node != NULL) {
-                enum webidl_type *base;
-                enum webidl_type_modifier *modifier;
-
-                /* type base */
-                base = (enum webidl_type *)webidl_node_getint(
-                        webidl_node_find_type(
-                                webidl_node_getnode(type_node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_TYPE_BASE));
-                if (base != NULL) {
-                        cure->base = *base;
-                }
-
-                /* type modifier */
-                modifier = (enum webidl_type_modifier *)webidl_node_getint(
-                        webidl_node_find_type(
-                                webidl_node_getnode(type_node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_MODIFIER));
-                if (modifier != NULL) {
-                        cure->modifier = *modifier;
-                } else {
-                        cure->modifier = WEBIDL_TYPE_MODIFIER_NONE;
-                }
-
-                /* type nullability */
-                cure->nullable = (webidl_node_find_type(
-                        webidl_node_getnode(type_node),
-                        NULL,
-                        WEBIDL_NODE_TYPE_TYPE_NULLABLE) != NULL);
-
-                /* type name */
-                cure->name = webidl_node_gettext(
-                        webidl_node_find_type(
-                                webidl_node_getnode(type_node),
-                                NULL,
-                                WEBIDL_NODE_TYPE_IDENT));
-
-                /* next entry */
-                cure++;
-
-                type_node = webidl_node_find_type(
-                        webidl_node_getnode(node),
-                        type_node,
-                        WEBIDL_NODE_TYPE_TYPE);
-        }
-
-        *typec_out = typec;
-        *typev_out = typev;
-
-        return 0;
-}
+        return cache;
+}
 
 /**
  * Create a new ir entry for an attribute
  */
 static int
 attribute_map_new(struct webidl_node *interface,
-                  struct genbind_node *class,
+                  struct method_index *methods,
                   int *attributec_out,
                   struct ir_attribute_entry **attributev_out)
 {
@@ -568,9 +976,8 @@ attribute_map_new(struct webidl_node *interface,
                                         NULL,
                                         WEBIDL_NODE_TYPE_IDENT));
 
-                        cure->getter = genbind_node_find_method_ident(
-                                               class,
-                                               NULL,
+                        cure->getter = method_index_find(
+                                               methods,
                                                GENBIND_METHOD_TYPE_GETTER,
                                                cure->name);
 
@@ -589,9 +996,8 @@ attribute_map_new(struct webidl_node *interface,
                                 cure->modifier = WEBIDL_TYPE_MODIFIER_READONLY;
                         } else {
                                 cure->modifier = WEBIDL_TYPE_MODIFIER_NONE;
-                                cure->setter = genbind_node_find_method_ident(
-                                                     class,
-                                                     NULL,
+                                cure->setter = method_index_find(
+                                                     methods,
                                                      GENBIND_METHOD_TYPE_SETTER,
                                                      cure->name);
                         }
@@ -611,6 +1017,13 @@ attribute_map_new(struct webidl_node *interface,
                         cure->treatnullas = get_extended_value(at_node,
                                                                "TreatNullAs");
 
+                        /* check for extended attributes allowing the
+                         * getter result to be cached
+                         */
+                        cure->cache = attribute_cache_type(at_node,
+                                                           cure->name,
+                                                           cure->modifier);
+
                         /* move to next attribute */
                         cure++;
 
@@ -631,6 +1044,121 @@ attribute_map_new(struct webidl_node *interface,
         return 0;
 }
 
+/**
+ * Create IR entry for the iteration declaration of an interface
+ *
+ * The binding method implementing iteration is named after the kind of
+ * declaration e.g. iterable.
+ */
+static int
+iterable_map_new(struct webidl_node *interface,
+                 struct method_index *methods,
+                 struct ir_iterable_entry *iterablee)
+{
+        static const enum webidl_node_type decl_types[] = {
+                WEBIDL_NODE_TYPE_ITERABLE,
+                WEBIDL_NODE_TYPE_MAPLIKE,
+                WEBIDL_NODE_TYPE_SETLIKE,
+        };
+        struct webidl_node *list_node;
+        struct webidl_node *decl_node;
+        struct webidl_node *value_node;
+        struct webidl_node *key_node;
+        enum webidl_type_modifier *modifier;
+        unsigned int typeidx;
+
+        iterablee->type = IR_ITERABLE_NONE;
+
+        /* iterate each list node within the interface */
+        list_node = webidl_node_find_type(
+                webidl_node_getnode(interface),
+                NULL,
+                WEBIDL_NODE_TYPE_LIST);
+
+        while (list_node != NULL) {
+                for (typeidx = 0;
+                     typeidx < sizeof(decl_types) / sizeof(decl_types[0]);
+                     typeidx++) {
+                        decl_node = webidl_node_find_type(
+                                webidl_node_getnode(list_node),
+                                NULL,
+                                decl_types[typeidx]);
+                        if (decl_node == NULL) {
+                                continue;
+                        }
+
+                        if (iterablee->type != IR_ITERABLE_NONE) {
+                                WARN(WARNING_WEBIDL,
+                                     "interface has more than one iterable, maplike or setlike declaration");
+                                continue;
+                        }
+                        iterablee->node = decl_node;
+
+                        /* the value type is last and the key type (if
+                         * any) before it
+                         */
+                        value_node = webidl_node_find_type(
+                                webidl_node_getnode(decl_node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_LIST);
+                        key_node = webidl_node_find_type(
+                                webidl_node_getnode(decl_node),
+                                value_node,
+                                WEBIDL_NODE_TYPE_LIST);
+
+                        switch (decl_types[typeidx]) {
+                        case WEBIDL_NODE_TYPE_MAPLIKE:
+                                iterablee->type = IR_ITERABLE_MAPLIKE;
+                                iterablee->method_name = "maplike";
+                                break;
+
+                        case WEBIDL_NODE_TYPE_SETLIKE:
+                                iterablee->type = IR_ITERABLE_SETLIKE;
+                                iterablee->method_name = "setlike";
+                                break;
+
+                        default:
+                                if (key_node != NULL) {
+                                        iterablee->type = IR_ITERABLE_PAIR;
+                                } else {
+                                        iterablee->type = IR_ITERABLE_VALUE;
+                                }
+                                iterablee->method_name = "iterable";
+                                break;
+                        }
+
+                        modifier = (enum webidl_type_modifier *)webidl_node_getint(
+                                webidl_node_find_type(
+                                        webidl_node_getnode(decl_node),
+                                        NULL,
+                                        WEBIDL_NODE_TYPE_MODIFIER));
+                        iterablee->readonly = ((modifier != NULL) &&
+                                (*modifier == WEBIDL_TYPE_MODIFIER_READONLY));
+
+                        type_map_new(value_node,
+                                     &iterablee->valuetypec,
+                                     &iterablee->valuetypev);
+                        if (key_node != NULL) {
+                                type_map_new(key_node,
+                                             &iterablee->keytypec,
+                                             &iterablee->keytypev);
+                        }
+
+                        iterablee->method = method_index_find(
+                                methods,
+                                GENBIND_METHOD_TYPE_METHOD,
+                                iterablee->method_name);
+                }
+
+                list_node = webidl_node_find_type(
+                        webidl_node_getnode(interface),
+                        list_node,
+                        WEBIDL_NODE_TYPE_LIST);
+        }
+
+        return 0;
+}
+
 static int
 constant_map_new(struct webidl_node *interface,
                  int *constantc_out,
@@ -745,21 +1273,7 @@ member_map_new(struct webidl_node *dictionary,
                         WEBIDL_NODE_TYPE_ARGUMENT);
 
                 while (member_node != NULL) {
-                        cure->node = member_node;
-
-                        cure->name = webidl_node_gettext(
-                                webidl_node_find_type(
-                                        webidl_node_getnode(member_node),
-                                        NULL,
-                                        WEBIDL_NODE_TYPE_IDENT));
-
-                        cure->optionalc = webidl_node_enumerate_type(
-                                webidl_node_getnode(member_node),
-                                WEBIDL_NODE_TYPE_OPTIONAL);
-
-                        cure->elipsisc = webidl_node_enumerate_type(
-                                webidl_node_getnode(member_node),
-                                WEBIDL_NODE_TYPE_ELLIPSIS);
+                        argument_entry_new(member_node, cure);
 
                         cure++;
 
@@ -796,6 +1310,7 @@ entry_map_new(struct genbind_node *genbind,
         struct ir_entry *sorted_entries;
         struct ir_entry *cure;
         struct webidl_node *node;
+        struct method_index methods;
 
         interfacec = webidl_node_enumerate_type(interface,
                                             WEBIDL_NODE_TYPE_INTERFACE);
@@ -871,18 +1386,31 @@ entry_map_new(struct genbind_node *genbind,
                         cure->u.interface.primary_global = true;
                 }
 
+                /* index the methods of the binding class */
+                method_index_new(cure->class, &methods);
+
                 /* enumerate and map the interface operations */
                 operation_map_new(node,
-                                  cure->class,
+                                  &methods,
                                   &cure->u.interface.operationc,
-                                  &cure->u.interface.operationv);
+                                  &cure->u.interface.operationv,
+                                  &cure->u.interface.indexed_getter,
+                                  &cure->u.interface.named_getter);
 
                 /* enumerate and map the interface attributes */
                 attribute_map_new(node,
-                                  cure->class,
+                                  &methods,
                                   &cure->u.interface.attributec,
                                   &cure->u.interface.attributev);
 
+                /* map the iterable, maplike or setlike declaration */
+                iterable_map_new(node,
+                                 &methods,
+                                 &cure->u.interface.iterable);
+
+                /* report binding methods that matched nothing */
+                method_index_free(&methods, cure->name);
+
                 /* enumerate and map the interface constants */
                 constant_map_new(node,
                                  &cure->u.interface.constantc,
@@ -960,110 +1488,1489 @@ entry_map_new(struct genbind_node *genbind,
 }
 
 
-int ir_new(struct genbind_node *genbind,
-           struct webidl_node *webidl,
-           struct ir **map_out)
+static int compare_enumeration(const void *a, const void *b)
 {
-        struct ir *map;
-        int ret;
+        const struct ir_enumeration_entry *ea = a;
+        const struct ir_enumeration_entry *eb = b;
 
-        map = malloc(sizeof(struct ir));
-        if (map == NULL) {
-            return -1;
+        return strcmp(ea->name, eb->name);
+}
+
+/**
+ * create the enumeration map
+ *
+ * The map is sorted by name so types may be resolved to their
+ * enumeration with a binary search.
+ */
+static int
+enumeration_map_new(struct webidl_node *webidl,
+                    int *enumerationc_out,
+                    struct ir_enumeration_entry **enumerationv_out)
+{
+        struct webidl_node *node;
+        struct webidl_node *list_node;
+        struct webidl_node *value_node;
+        struct ir_enumeration_entry *enumerationv;
+        struct ir_enumeration_entry *cure;
+        int enumerationc;
+        int idx;
+
+        enumerationc = webidl_node_enumerate_type(webidl,
+                                                  WEBIDL_NODE_TYPE_ENUM);
+        if (enumerationc < 1) {
+                *enumerationc_out = 0;
+                *enumerationv_out = NULL;
+                return 0;
         }
 
-        map->webidl = webidl;
-        map->binding_node = genbind_node_find_type(genbind, NULL,
-                                                   GENBIND_NODE_TYPE_BINDING);
+        if (options->verbose) {
+                printf("Mapping %d enumerations\n", enumerationc);
+        }
 
-        /* interfaces */
-        ret = entry_map_new(genbind,
-                            webidl,
-                            &map->entryc,
-                            &map->entries);
-        if (ret != 0) {
-                free(map);
-                return ret;
+        enumerationv = calloc(enumerationc, sizeof(*enumerationv));
+        if (enumerationv == NULL) {
+                return -1;
         }
+        cure = enumerationv;
 
-        *map_out = map;
+        node = webidl_node_find_type(webidl, NULL, WEBIDL_NODE_TYPE_ENUM);
+        while (node != NULL) {
+                cure->node = node;
 
-        return 0;
-}
+                cure->name = webidl_node_gettext(
+                        webidl_node_find_type(
+                                webidl_node_getnode(node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_IDENT));
 
-static int ir_dump_dictionary(FILE *dumpf, struct ir_entry *ecur)
-{
-        if (ecur->u.dictionary.memberc > 0) {
-                int argc;
+                list_node = webidl_node_find_type(
+                        webidl_node_getnode(node),
+                        NULL,
+                        WEBIDL_NODE_TYPE_LIST);
 
-                fprintf(dumpf, "\t%d members\n", ecur->u.dictionary.memberc);
+                cure->valuec = webidl_node_enumerate_type(
+                        webidl_node_getnode(list_node),
+                        WEBIDL_NODE_TYPE_LITERAL_STRING);
+                cure->valuev = calloc(cure->valuec + 1, sizeof(char *));
+                if (cure->valuev == NULL) {
+                        while (cure > enumerationv) {
+                                cure--;
+                                free(cure->valuev);
+                        }
+                        free(enumerationv);
+                        return -1;
+                }
 
-                for (argc = 0; argc < ecur->u.dictionary.memberc; argc++) {
-                        struct ir_operation_argument_entry *arge;
+                idx = 0;
+                value_node = webidl_node_find_type(
+                        webidl_node_getnode(list_node),
+                        NULL,
+                        WEBIDL_NODE_TYPE_LITERAL_STRING);
+                while (value_node != NULL) {
+                        cure->valuev[idx++] = webidl_node_gettext(value_node);
 
-                        arge = ecur->u.dictionary.memberv + argc;
+                        value_node = webidl_node_find_type(
+                                webidl_node_getnode(list_node),
+                                value_node,
+                                WEBIDL_NODE_TYPE_LITERAL_STRING);
+                }
 
-                        fprintf(dumpf, "\t\t%s\n", arge->name);
+                cure++;
 
-                        if (arge->optionalc != 0) {
-                                fprintf(dumpf,
-                                        "\t\t\toptional:%d\n",
-                                        arge->optionalc);
-                        }
+                node = webidl_node_find_type(webidl,
+                                             node,
+                                             WEBIDL_NODE_TYPE_ENUM);
+        }
 
-                        if (arge->elipsisc != 0) {
-                                fprintf(dumpf,
-                                        "\t\t\telipsis:%d\n",
-                                        arge->elipsisc);
-                        }
+        qsort(enumerationv, enumerationc, sizeof(*enumerationv),
+              compare_enumeration);
+
+        /* an enumeration may only be defined once */
+        for (idx = 1; idx < enumerationc; idx++) {
+                if (strcmp(enumerationv[idx - 1].name,
+                           enumerationv[idx].name) == 0) {
+                        WARN(WARNING_WEBIDL,
+                             "enumeration %s is defined more than once",
+                             enumerationv[idx].name);
+                        free(enumerationv[idx].valuev);
+                        memmove(enumerationv + idx,
+                                enumerationv + idx + 1,
+                                (enumerationc - idx - 1) *
+                                sizeof(*enumerationv));
+                        enumerationc--;
+                        idx--;
                 }
         }
+
+        *enumerationc_out = enumerationc;
+        *enumerationv_out = enumerationv;
+
         return 0;
 }
 
-static int ir_dump_interface(FILE *dumpf, struct ir_entry *ecur)
+static int compare_callback(const void *a, const void *b)
 {
-        if (ecur->u.interface.operationc > 0) {
-                int opc;
+        const struct ir_callback_entry *ca = a;
+        const struct ir_callback_entry *cb = b;
 
-                fprintf(dumpf, "\t%d operations\n",
-                        ecur->u.interface.operationc);
+        return strcmp(ca->name, cb->name);
+}
 
-                for (opc = 0; opc < ecur->u.interface.operationc; opc++) {
-                        int ovlc;
-                        struct ir_operation_entry *ope;
+/**
+ * check if an interface was declared as a callback interface
+ */
+static bool interface_is_callback(struct ir_entry *entry)
+{
+        if (entry->type != IR_ENTRY_TYPE_INTERFACE) {
+                return false;
+        }
+        return webidl_node_find_type(webidl_node_getnode(entry->node),
+                                     NULL,
+                                     WEBIDL_NODE_TYPE_CALLBACK) != NULL;
+}
 
-                        ope = ecur->u.interface.operationv + opc;
+/**
+ * create the callback map
+ *
+ * Callback functions take their arguments from the declaration and
+ * callback interfaces from their single operation. The map is sorted
+ * by name so types may be resolved to their callback with a binary
+ * search.
+ */
+static int
+callback_map_new(struct webidl_node *webidl,
+                 int entryc,
+                 struct ir_entry *entries,
+                 int *callbackc_out,
+                 struct ir_callback_entry **callbackv_out)
+{
+        struct webidl_node *node;
+        struct ir_callback_entry *callbackv;
+        struct ir_callback_entry *cure;
+        struct ir_operation_entry *ope;
+        int callbackc;
+        int idx;
 
-                        fprintf(dumpf,
-                                "\t\t%s\n",
-                                ope->name);
-                        fprintf(dumpf,
-                                "\t\t\tmethod:%p\n",
-                                ope->method);
-                        for(ovlc = 0; ovlc < ope->overloadc;ovlc++) {
-                                int argc;
-                                struct ir_operation_overload_entry *ovle;
-                                ovle = ope->overloadv + ovlc;
+        callbackc = webidl_node_enumerate_type(webidl,
+                                               WEBIDL_NODE_TYPE_CALLBACK);
+        for (idx = 0; idx < entryc; idx++) {
+                if (interface_is_callback(entries + idx)) {
+                        callbackc++;
+                }
+        }
+        if (callbackc < 1) {
+                *callbackc_out = 0;
+                *callbackv_out = NULL;
+                return 0;
+        }
 
-                                fprintf(dumpf,
-                                        "\t\t\toverload:%d\n", ovlc);
+        if (options->verbose) {
+                printf("Mapping %d callbacks\n", callbackc);
+        }
 
-                                fprintf(dumpf,
-                                        "\t\t\t\treturn type:%p\n",
-                                        ovle->type);
+        callbackv = calloc(callbackc, sizeof(*callbackv));
+        if (callbackv == NULL) {
+                return -1;
+        }
+        cure = callbackv;
 
-                                fprintf(dumpf,
-                                        "\t\t\t\targuments:%d\n",
-                                        ovle->argumentc);
+        /* callback functions */
+        node = webidl_node_find_type(webidl, NULL, WEBIDL_NODE_TYPE_CALLBACK);
+        while (node != NULL) {
+                cure->node = node;
 
-                                fprintf(dumpf,
-                                        "\t\t\t\toptionals:%d\n",
-                                        ovle->optionalc);
+                cure->name = webidl_node_gettext(
+                        webidl_node_find_type(
+                                webidl_node_getnode(node),
+                                NULL,
+                                WEBIDL_NODE_TYPE_IDENT));
 
-                                fprintf(dumpf,
-                                        "\t\t\t\telipsis:%d\n",
-                                        ovle->elipsisc);
+                argument_map_new(webidl_node_find_type(
+                                         webidl_node_getnode(node),
+                                         NULL,
+                                         WEBIDL_NODE_TYPE_LIST),
+                                 &cure->argumentc,
+                                 &cure->argumentv);
+
+                cure++;
+
+                node = webidl_node_find_type(webidl,
+                                             node,
+                                             WEBIDL_NODE_TYPE_CALLBACK);
+        }
+
+        /* callback interfaces */
+        for (idx = 0; idx < entryc; idx++) {
+                if (!interface_is_callback(entries + idx)) {
+                        continue;
+                }
+
+                if (entries[idx].u.interface.operationc != 1) {
+                        WARN(WARNING_WEBIDL,
+                             "callback interface %s must have a single operation",
+                             entries[idx].name);
+                        callbackc--;
+                        continue;
+                }
+                ope = entries[idx].u.interface.operationv;
+
+                cure->node = entries[idx].node;
+                cure->name = entries[idx].name;
+                cure->interface = entries + idx;
+                cure->operation_name = ope->name;
+                if (ope->overloadc > 0) {
+                        cure->argumentc = ope->overloadv[0].argumentc;
+                        cure->argumentv = ope->overloadv[0].argumentv;
+                }
+
+                cure++;
+        }
+
+        qsort(callbackv, callbackc, sizeof(*callbackv), compare_callback);
+
+        /* a callback may only be defined once */
+        for (idx = 1; idx < callbackc; idx++) {
+                if (strcmp(callbackv[idx - 1].name,
+                           callbackv[idx].name) == 0) {
+                        WARN(WARNING_WEBIDL,
+                             "callback %s is defined more than once",
+                             callbackv[idx].name);
+                        if (callbackv[idx].interface == NULL) {
+                                argument_map_free(callbackv[idx].argumentc,
+                                                  callbackv[idx].argumentv);
+                        }
+                        memmove(callbackv + idx,
+                                callbackv + idx + 1,
+                                (callbackc - idx - 1) * sizeof(*callbackv));
+                        callbackc--;
+                        idx--;
+                }
+        }
+
+        *callbackc_out = callbackc;
+        *callbackv_out = callbackv;
+
+        return 0;
+}
+
+/**
+ * resolve the enumeration or callback named by each user type in a
+ * type vector
+ */
+static void
+type_resolve(struct ir *ir, int typec, struct ir_type_entry *typev)
+{
+        struct ir_enumeration_entry key;
+        struct ir_callback_entry cbkey;
+        int idx;
+
+        for (idx = 0; idx < typec; idx++) {
+                if ((typev[idx].base != WEBIDL_TYPE_USER) ||
+                    (typev[idx].name == NULL)) {
+                        continue;
+                }
+                if (ir->enumerationc > 0) {
+                        key.name = typev[idx].name;
+                        typev[idx].enumeration = bsearch(&key,
+                                                         ir->enumerations,
+                                                         ir->enumerationc,
+                                                         sizeof(key),
+                                                         compare_enumeration);
+                }
+                if (ir->callbackc > 0) {
+                        cbkey.name = typev[idx].name;
+                        typev[idx].callback = bsearch(&cbkey,
+                                                      ir->callbacks,
+                                                      ir->callbackc,
+                                                      sizeof(cbkey),
+                                                      compare_callback);
+                }
+        }
+}
+
+/**
+ * resolve the enumerations used by attributes, arguments and members
+ */
+static void
+entry_resolve_types(struct ir *ir, struct ir_entry *entry)
+{
+        struct ir_operation_entry *ope;
+        struct ir_operation_overload_entry *ovle;
+        struct ir_operation_argument_entry *arge;
+        int idx;
+        int ovlc;
+        int argc;
+
+        if (entry->type == IR_ENTRY_TYPE_DICTIONARY) {
+                for (idx = 0; idx < entry->u.dictionary.memberc; idx++) {
+                        arge = entry->u.dictionary.memberv + idx;
+                        type_resolve(ir, arge->typec, arge->typev);
+                }
+                return;
+        }
+
+        for (idx = 0; idx < entry->u.interface.attributec; idx++) {
+                type_resolve(ir,
+                             entry->u.interface.attributev[idx].typec,
+                             entry->u.interface.attributev[idx].typev);
+        }
+
+        for (idx = 0; idx < entry->u.interface.operationc; idx++) {
+                ope = entry->u.interface.operationv + idx;
+                for (ovlc = 0; ovlc < ope->overloadc; ovlc++) {
+                        ovle = ope->overloadv + ovlc;
+                        for (argc = 0; argc < ovle->argumentc; argc++) {
+                                arge = ovle->argumentv + argc;
+                                type_resolve(ir, arge->typec, arge->typev);
+                        }
+                }
+        }
+
+        type_resolve(ir,
+                     entry->u.interface.iterable.keytypec,
+                     entry->u.interface.iterable.keytypev);
+        type_resolve(ir,
+                     entry->u.interface.iterable.valuetypec,
+                     entry->u.interface.iterable.valuetypev);
+}
+
+static void operation_free(struct ir_operation_entry *ope)
+{
+        overload_map_free(ope->overloadc, ope->overloadv);
+}
+
+static void attribute_free(struct ir_attribute_entry *attre)
+{
+        free(attre->typev);
+        free(attre->property_name);
+}
+
+/**
+ * free the maps of an interface or dictionary entry
+ */
+static void entry_free(struct ir_entry *entry)
+{
+        struct ir_interface_entry *interfacee;
+        int idx;
+
+        switch (entry->type) {
+        case IR_ENTRY_TYPE_INTERFACE:
+                interfacee = &entry->u.interface;
+                for (idx = 0; idx < interfacee->operationc; idx++) {
+                        operation_free(interfacee->operationv + idx);
+                }
+                free(interfacee->operationv);
+                for (idx = 0; idx < interfacee->attributec; idx++) {
+                        attribute_free(interfacee->attributev + idx);
+                }
+                free(interfacee->attributev);
+                free(interfacee->constantv);
+                free(interfacee->iterable.keytypev);
+                free(interfacee->iterable.valuetypev);
+                break;
+
+        case IR_ENTRY_TYPE_DICTIONARY:
+                argument_map_free(entry->u.dictionary.memberc,
+                                  entry->u.dictionary.memberv);
+                break;
+        }
+
+        free(entry->filename);
+        free(entry->class_name);
+}
+
+/** longest line read from a pruning manifest */
+#define PRUNE_LINE_MAX 1024
+
+/**
+ * name listed in a pruning manifest
+ */
+struct prune_name {
+        char *name; /**< Interface or Interface::member */
+        bool used; /**< the name matched something in the IR */
+};
+
+/**
+ * names allowed and denied by a pruning manifest, each sorted by name
+ */
+struct prune_manifest {
+        int allowc;
+        struct prune_name *allowv;
+        int denyc;
+        struct prune_name *denyv;
+};
+
+static int compare_prune_name(const void *a, const void *b)
+{
+        const struct prune_name *na = a;
+        const struct prune_name *nb = b;
+
+        return strcmp(na->name, nb->name);
+}
+
+static int
+prune_name_add(int *namec, struct prune_name **namev, const char *name)
+{
+        struct prune_name *newv;
+
+        newv = realloc(*namev, (*namec + 1) * sizeof(struct prune_name));
+        if (newv == NULL) {
+                return -1;
+        }
+        *namev = newv;
+        newv[*namec].name = strdup(name);
+        newv[*namec].used = false;
+        if (newv[*namec].name == NULL) {
+                return -1;
+        }
+        (*namec)++;
+
+        return 0;
+}
+
+static void
+prune_names_free(int namec, struct prune_name *namev, const char *what)
+{
+        int idx;
+
+        for (idx = 0; idx < namec; idx++) {
+                if (!namev[idx].used) {
+                        WARN(WARNING_UNUSED,
+                             "%s %s in pruning manifest matches nothing",
+                             what, namev[idx].name);
+                }
+                free(namev[idx].name);
+        }
+        free(namev);
+}
+
+/**
+ * read a pruning manifest
+ *
+ * Each line names an interface or Interface::member to keep, or to
+ * prune when prefixed with !. Lines starting with # are ignored.
+ */
+static int
+prune_manifest_new(const char *filename, struct prune_manifest *manifest)
+{
+        FILE *infile;
+        char line[PRUNE_LINE_MAX];
+        char *saveptr;
+        char *name;
+        int res = 0;
+
+        memset(manifest, 0, sizeof(struct prune_manifest));
+
+        infile = fopen(filename, "r");
+        if (infile == NULL) {
+                fprintf(stderr,
+                        "Error: unable to open pruning manifest %s: %s\n",
+                        filename, strerror(errno));
+                return -1;
+        }
+
+        while ((res == 0) && (fgets(line, sizeof(line), infile) != NULL)) {
+                name = strtok_r(line, " \t\r\n", &saveptr);
+                if ((name == NULL) || (*name == '#')) {
+                        continue;
+                }
+                if (*name == '!') {
+                        res = prune_name_add(&manifest->denyc,
+                                             &manifest->denyv,
+                                             name + 1);
+                } else {
+                        res = prune_name_add(&manifest->allowc,
+                                             &manifest->allowv,
+                                             name);
+                }
+        }
+        fclose(infile);
+
+        qsort(manifest->allowv, manifest->allowc,
+              sizeof(struct prune_name), compare_prune_name);
+        qsort(manifest->denyv, manifest->denyc,
+              sizeof(struct prune_name), compare_prune_name);
+
+        return res;
+}
+
+/**
+ * find a name in a sorted manifest list marking it used
+ */
+static bool
+prune_name_find(int namec, struct prune_name *namev, const char *name)
+{
+        struct prune_name key;
+        struct prune_name *found;
+
+        if (namec == 0) {
+                return false;
+        }
+        key.name = (char *)name;
+        found = bsearch(&key, namev, namec,
+                        sizeof(struct prune_name), compare_prune_name);
+        if (found == NULL) {
+                return false;
+        }
+        found->used = true;
+        return true;
+}
+
+/**
+ * check if a sorted manifest list names any member of an interface
+ */
+static bool
+prune_name_has_members(int namec, struct prune_name *namev, const char *name)
+{
+        size_t namel = strlen(name);
+        int lo = 0;
+        int hi = namec;
+        int mid;
+
+        /* lower bound of the names starting with Interface:: */
+        while (lo < hi) {
+                mid = (lo + hi) / 2;
+                if (strcmp(namev[mid].name, name) <= 0) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+        for (; lo < namec; lo++) {
+                if (strncmp(namev[lo].name, name, namel) != 0) {
+                        break;
+                }
+                if (strncmp(namev[lo].name + namel, "::", 2) == 0) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/**
+ * check if a member of an interface is pruned
+ *
+ * \param manifest The pruning manifest.
+ * \param entry The interface of the member.
+ * \param member The member name.
+ * \param allowmembers Only members allowed by name are kept.
+ */
+static bool
+prune_member(struct prune_manifest *manifest,
+             struct ir_entry *entry,
+             const char *member,
+             bool allowmembers)
+{
+        char name[PRUNE_LINE_MAX];
+        bool allowed;
+
+        if (member == NULL) {
+                /* special operations have no name */
+                return false;
+        }
+
+        snprintf(name, sizeof(name), "%s::%s", entry->name, member);
+
+        allowed = prune_name_find(manifest->allowc, manifest->allowv, name);
+        if (prune_name_find(manifest->denyc, manifest->denyv, name)) {
+                return true;
+        }
+        return allowmembers && !allowed;
+}
+
+/**
+ * prune the members of an interface
+ *
+ * Pruned members are removed or, with stubs, marked to be generated as
+ * a shared stub which throws.
+ */
+static void
+prune_interface_members(struct prune_manifest *manifest,
+                        struct ir_entry *entry,
+                        bool allowmembers)
+{
+        struct ir_interface_entry *interfacee = &entry->u.interface;
+        struct ir_operation_entry *indexed_getter = NULL;
+        struct ir_operation_entry *named_getter = NULL;
+        bool pruned;
+        int keep;
+        int idx;
+
+        keep = 0;
+        for (idx = 0; idx < interfacee->operationc; idx++) {
+                struct ir_operation_entry *ope;
+
+                ope = interfacee->operationv + idx;
+                pruned = prune_member(manifest, entry, ope->name,
+                                      allowmembers);
+                if (pruned &&
+                    ((ope == interfacee->indexed_getter) ||
+                     (ope == interfacee->named_getter))) {
+                        WARN(WARNING_UNUSED,
+                             "%s::%s is a property getter and is not pruned",
+                             entry->name, ope->name);
+                        pruned = false;
+                }
+                if (pruned && options->prunestub) {
+                        ope->pruned = true;
+                        pruned = false;
+                }
+                if (pruned) {
+                        operation_free(ope);
+                        continue;
+                }
+                if (ope == interfacee->indexed_getter) {
+                        indexed_getter = interfacee->operationv + keep;
+                }
+                if (ope == interfacee->named_getter) {
+                        named_getter = interfacee->operationv + keep;
+                }
+                interfacee->operationv[keep++] = *ope;
+        }
+        interfacee->operationc = keep;
+        interfacee->indexed_getter = indexed_getter;
+        interfacee->named_getter = named_getter;
+
+        keep = 0;
+        for (idx = 0; idx < interfacee->attributec; idx++) {
+                struct ir_attribute_entry *attre;
+
+                attre = interfacee->attributev + idx;
+                pruned = prune_member(manifest, entry, attre->name,
+                                      allowmembers);
+                if (pruned && options->prunestub) {
+                        attre->pruned = true;
+                        pruned = false;
+                }
+                if (pruned) {
+                        attribute_free(attre);
+                } else {
+                        interfacee->attributev[keep++] = *attre;
+                }
+        }
+        interfacee->attributec = keep;
+
+        keep = 0;
+        for (idx = 0; idx < interfacee->constantc; idx++) {
+                struct ir_constant_entry *conste;
+
+                conste = interfacee->constantv + idx;
+                if (!prune_member(manifest, entry, conste->name,
+                                  allowmembers)) {
+                        interfacee->constantv[keep++] = *conste;
+                }
+        }
+        interfacee->constantc = keep;
+}
+
+/**
+ * warn about members of a callback interface the manifest prunes
+ *
+ * The callback shares the arguments of the interface operations so no
+ * member is removed.
+ */
+static void
+prune_callback_members(struct prune_manifest *manifest, struct ir_entry *entry)
+{
+        struct ir_interface_entry *interfacee = &entry->u.interface;
+        char name[PRUNE_LINE_MAX];
+        int idx;
+
+        for (idx = 0; idx < interfacee->operationc; idx++) {
+                if (interfacee->operationv[idx].name == NULL) {
+                        continue;
+                }
+                snprintf(name, sizeof(name), "%s::%s",
+                         entry->name, interfacee->operationv[idx].name);
+                prune_name_find(manifest->allowc, manifest->allowv, name);
+                if (prune_name_find(manifest->denyc, manifest->denyv, name)) {
+                        WARN(WARNING_UNUSED,
+                             "%s is a callback interface member and is not pruned",
+                             name);
+                }
+        }
+}
+
+/* exported interface documented in ir.h */
+int ir_prune(struct ir *ir, const char *filename)
+{
+        struct prune_manifest manifest;
+        bool *keepv;
+        bool *allowmembersv;
+        struct ir_entry *entry;
+        bool callback;
+        int keep;
+        int idx;
+        int res;
+
+        res = prune_manifest_new(filename, &manifest);
+        if (res != 0) {
+                prune_names_free(manifest.allowc, manifest.allowv, "Allowed");
+                prune_names_free(manifest.denyc, manifest.denyv, "Denied");
+                return res;
+        }
+
+        keepv = calloc(ir->entryc, sizeof(bool));
+        allowmembersv = calloc(ir->entryc, sizeof(bool));
+        if ((keepv == NULL) || (allowmembersv == NULL)) {
+                free(keepv);
+                free(allowmembersv);
+                prune_names_free(manifest.allowc, manifest.allowv, "Allowed");
+                prune_names_free(manifest.denyc, manifest.denyv, "Denied");
+                return -1;
+        }
+
+        /* select the interfaces named by the manifest */
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+
+                if ((entry->type != IR_ENTRY_TYPE_INTERFACE) ||
+                    entry->u.interface.primary_global ||
+                    interface_is_callback(entry)) {
+                        /* dictionaries, the global and callback
+                         * interfaces are always kept
+                         */
+                        keepv[idx] = true;
+                } else if (manifest.allowc == 0) {
+                        keepv[idx] = true;
+                } else if (prune_name_find(manifest.allowc,
+                                           manifest.allowv,
+                                           entry->name)) {
+                        keepv[idx] = true;
+                } else if (prune_name_has_members(manifest.allowc,
+                                                  manifest.allowv,
+                                                  entry->name)) {
+                        keepv[idx] = true;
+                        allowmembersv[idx] = true;
+                }
+
+                if (prune_name_find(manifest.denyc,
+                                    manifest.denyv,
+                                    entry->name)) {
+                        keepv[idx] = false;
+                }
+        }
+
+        /* interfaces inherited from are kept, children follow parents */
+        for (idx = ir->entryc - 1; idx >= 0; idx--) {
+                entry = ir->entries + idx;
+                if (keepv[idx] &&
+                    (entry->inherit_idx != -1) &&
+                    !keepv[entry->inherit_idx]) {
+                        if (prune_name_find(manifest.denyc,
+                                            manifest.denyv,
+                                            ir->entries[entry->inherit_idx].name)) {
+                                WARN(WARNING_UNUSED,
+                                     "%s is inherited by %s and is not pruned",
+                                     ir->entries[entry->inherit_idx].name,
+                                     entry->name);
+                        }
+                        keepv[entry->inherit_idx] = true;
+                }
+        }
+
+        /* remove pruned interfaces and members */
+        keep = 0;
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+                if (!keepv[idx]) {
+                        if (options->verbose) {
+                                printf("Pruning interface %s\n", entry->name);
+                        }
+                        entry_free(entry);
+                        continue;
+                }
+
+                /* callback interfaces move with their entry and keep
+                 * all members as the callback shares their arguments
+                 */
+                callback = false;
+                for (res = 0; res < ir->callbackc; res++) {
+                        if (ir->callbacks[res].interface == entry) {
+                                ir->callbacks[res].interface =
+                                        ir->entries + keep;
+                                callback = true;
+                        }
+                }
+
+                if (callback) {
+                        prune_callback_members(&manifest, entry);
+                } else if (entry->type == IR_ENTRY_TYPE_INTERFACE) {
+                        prune_interface_members(&manifest,
+                                                entry,
+                                                allowmembersv[idx]);
+                }
+
+                ir->entries[keep] = *entry;
+                ir->entries[keep].refcount = 0;
+                keep++;
+        }
+        ir->entryc = keep;
+
+        compute_inherit_refcount(ir->entries, ir->entryc);
+
+        free(keepv);
+        free(allowmembersv);
+        prune_names_free(manifest.allowc, manifest.allowv, "Allowed");
+        prune_names_free(manifest.denyc, manifest.denyv, "Denied");
+
+        return 0;
+}
+
+/**
+ * check if an entry has an attribute cached until the object changes
+ */
+static bool entry_generation_cache(struct ir_entry *entry)
+{
+        int idx;
+
+        if (entry->type != IR_ENTRY_TYPE_INTERFACE) {
+                return false;
+        }
+
+        for (idx = 0; idx < entry->u.interface.attributec; idx++) {
+                if (entry->u.interface.attributev[idx].cache ==
+                    IR_ATTRIBUTE_CACHE_GENERATION) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/** percentage of the profiled calls made to functions marked hot */
+#define PROFILE_HOT_PERCENT 90
+
+/** longest line read from a call frequency profile */
+#define PROFILE_LINE_MAX 1024
+
+static int compare_profile(const void *a, const void *b)
+{
+        const struct ir_profile_entry *ea = a;
+        const struct ir_profile_entry *eb = b;
+        int res;
+
+        res = strcmp(ea->name, eb->name);
+        if (res != 0) {
+                return res;
+        }
+        if (ea->kind == NULL) {
+                return (eb->kind == NULL) ? 0 : -1;
+        }
+        if (eb->kind == NULL) {
+                return 1;
+        }
+        return strcmp(ea->kind, eb->kind);
+}
+
+static int compare_profile_name(const void *key, const void *elem)
+{
+        const struct ir_profile_entry *e = elem;
+
+        return strcmp(key, e->name);
+}
+
+static int compare_count_descending(const void *a, const void *b)
+{
+        unsigned long ca = *(const unsigned long *)a;
+        unsigned long cb = *(const unsigned long *)b;
+
+        if (ca == cb) {
+                return 0;
+        }
+        return (ca > cb) ? -1 : 1;
+}
+
+/**
+ * parse a call count which may be in the form output by the profile dump
+ */
+static bool parse_profile_count(const char *str, unsigned long *count_out)
+{
+        char *end;
+
+        if (strncmp(str, "calls:", 6) == 0) {
+                str += 6;
+        }
+        if (!isdigit((unsigned char)*str)) {
+                return false;
+        }
+        *count_out = strtoul(str, &end, 10);
+        return *end == 0;
+}
+
+/**
+ * find the least call count of the functions which together account
+ * for the hot percentage of all profiled calls
+ */
+static unsigned long
+profile_hot_threshold(int profilec, struct ir_profile_entry *profilev)
+{
+        unsigned long *countv;
+        unsigned long long total = 0;
+        unsigned long long sum = 0;
+        unsigned long hot = 0;
+        int idx;
+
+        countv = malloc(profilec * sizeof(unsigned long));
+        if (countv == NULL) {
+                return 0;
+        }
+        for (idx = 0; idx < profilec; idx++) {
+                countv[idx] = profilev[idx].count;
+                total += countv[idx];
+        }
+        qsort(countv, profilec, sizeof(unsigned long),
+              compare_count_descending);
+
+        for (idx = 0; idx < profilec; idx++) {
+                if ((countv[idx] == 0) ||
+                    ((sum * 100) >= (total * PROFILE_HOT_PERCENT))) {
+                        break;
+                }
+                sum += countv[idx];
+                hot = countv[idx];
+        }
+        free(countv);
+
+        return hot;
+}
+
+/**
+ * free a call frequency profile
+ *
+ * Entries which matched no generated function are warned about unless
+ * the output of some entries was current and not generated again.
+ */
+static void
+profile_map_free(struct ir *map, const char *filename, bool complete)
+{
+        int idx;
+
+        for (idx = 0; idx < map->profilec; idx++) {
+                if (complete && !map->profilev[idx].used) {
+                        WARN(WARNING_UNUSED,
+                             "Profile %s entry %s%s%s matches no generated function",
+                             filename,
+                             map->profilev[idx].name,
+                             (map->profilev[idx].kind != NULL) ? " " : "",
+                             (map->profilev[idx].kind != NULL) ?
+                             map->profilev[idx].kind : "");
+                }
+                free(map->profilev[idx].name);
+                free(map->profilev[idx].kind);
+        }
+        free(map->profilev);
+
+        map->profilev = NULL;
+        map->profilec = 0;
+        map->profile_hot = 0;
+}
+
+/**
+ * read a call frequency profile
+ *
+ * Each line holds a function name, an optional kind and a call count
+ * separated by white space. Any further fields, such as the time
+ * written by the profile dump, are ignored.
+ */
+static int profile_map_new(const char *filename, struct ir *map)
+{
+        FILE *infile;
+        char line[PROFILE_LINE_MAX];
+        struct ir_profile_entry *profilev;
+        struct ir_profile_entry *entry;
+        char *saveptr;
+        char *name;
+        char *kind;
+        char *count;
+        unsigned long calls;
+        int linenum = 0;
+        int idx;
+
+        infile = fopen(filename, "r");
+        if (infile == NULL) {
+                fprintf(stderr, "Error: unable to open profile %s: %s\n",
+                        filename, strerror(errno));
+                return -1;
+        }
+
+        while (fgets(line, sizeof(line), infile) != NULL) {
+                linenum++;
+
+                /* lines are: name [kind] count */
+                name = strtok_r(line, " \t\r\n", &saveptr);
+                if ((name == NULL) || (*name == '#')) {
+                        continue;
+                }
+                kind = strtok_r(NULL, " \t\r\n", &saveptr);
+                if ((kind != NULL) && !parse_profile_count(kind, &calls)) {
+                        count = strtok_r(NULL, " \t\r\n", &saveptr);
+                } else {
+                        count = kind;
+                        kind = NULL;
+                }
+                if ((count == NULL) || !parse_profile_count(count, &calls)) {
+                        fprintf(stderr,
+                                "Error: %s:%d: expected name, optional kind and call count\n",
+                                filename, linenum);
+                        fclose(infile);
+                        profile_map_free(map, filename, false);
+                        return -1;
+                }
+
+                profilev = realloc(map->profilev,
+                                   (map->profilec + 1) *
+                                   sizeof(struct ir_profile_entry));
+                if (profilev == NULL) {
+                        fclose(infile);
+                        profile_map_free(map, filename, false);
+                        return -1;
+                }
+                map->profilev = profilev;
+                entry = map->profilev + map->profilec++;
+                entry->name = strdup(name);
+                entry->kind = (kind != NULL) ? strdup(kind) : NULL;
+                entry->count = calls;
+                entry->used = false;
+                if ((entry->name == NULL) ||
+                    ((kind != NULL) && (entry->kind == NULL))) {
+                        fclose(infile);
+                        profile_map_free(map, filename, false);
+                        return -1;
+                }
+        }
+        fclose(infile);
+
+        if (map->profilec == 0) {
+                return 0;
+        }
+
+        qsort(map->profilev,
+              map->profilec,
+              sizeof(struct ir_profile_entry),
+              compare_profile);
+
+        /* merge entries for the same function */
+        entry = map->profilev;
+        for (idx = 1; idx < map->profilec; idx++) {
+                if (compare_profile(entry, map->profilev + idx) == 0) {
+                        entry->count += map->profilev[idx].count;
+                        free(map->profilev[idx].name);
+                        free(map->profilev[idx].kind);
+                } else {
+                        *(++entry) = map->profilev[idx];
+                }
+        }
+        map->profilec = (entry - map->profilev) + 1;
+
+        map->profile_hot = profile_hot_threshold(map->profilec,
+                                                 map->profilev);
+
+        return 0;
+}
+
+/* exported interface documented in ir.h */
+unsigned long
+ir_profile_count(struct ir *ir,
+                 struct ir_entry *entry,
+                 const char *member,
+                 const char *kind)
+{
+        struct ir_profile_entry *profilee;
+        struct ir_profile_entry *last;
+        unsigned long count = 0;
+        char *name;
+        int namel;
+
+        if (ir->profilec == 0) {
+                return 0;
+        }
+
+        namel = strlen(entry->name) + 1;
+        if (member != NULL) {
+                namel += strlen(member) + 2;
+        }
+        name = malloc(namel);
+        if (name == NULL) {
+                return 0;
+        }
+        snprintf(name, namel, "%s%s%s",
+                 entry->name,
+                 (member != NULL) ? "::" : "",
+                 (member != NULL) ? member : "");
+
+        profilee = bsearch(name,
+                           ir->profilev,
+                           ir->profilec,
+                           sizeof(struct ir_profile_entry),
+                           compare_profile_name);
+        if (profilee != NULL) {
+                /* entries for the name are adjacent, match any without
+                 * a kind
+                 */
+                while ((profilee > ir->profilev) &&
+                       (strcmp((profilee - 1)->name, name) == 0)) {
+                        profilee--;
+                }
+                last = ir->profilev + ir->profilec;
+                for (; (profilee < last) &&
+                             (strcmp(profilee->name, name) == 0);
+                     profilee++) {
+                        if ((profilee->kind == NULL) ||
+                            ((kind != NULL) &&
+                             (strcmp(profilee->kind, kind) == 0))) {
+                                profilee->used = true;
+                                count += profilee->count;
+                        }
+                }
+        }
+        free(name);
+
+        return count;
+}
+
+/* exported interface documented in ir.h */
+int ir_new(struct genbind_node *genbind,
+           struct webidl_node *webidl,
+           struct ir **map_out)
+{
+        struct ir *map;
+        int ret;
+        int idx;
+
+        map = calloc(1, sizeof(struct ir));
+        if (map == NULL) {
+            return -1;
+        }
+
+        map->webidl = webidl;
+        map->binding_node = genbind_node_find_type(genbind, NULL,
+                                                   GENBIND_NODE_TYPE_BINDING);
+
+        /* interfaces */
+        ret = entry_map_new(genbind,
+                            webidl,
+                            &map->entryc,
+                            &map->entries);
+        if (ret != 0) {
+                ir_free(map);
+                return ret;
+        }
+
+        /* enumerations */
+        ret = enumeration_map_new(webidl,
+                                  &map->enumerationc,
+                                  &map->enumerations);
+        if (ret != 0) {
+                ir_free(map);
+                return ret;
+        }
+
+        /* callbacks */
+        ret = callback_map_new(webidl,
+                               map->entryc,
+                               map->entries,
+                               &map->callbackc,
+                               &map->callbacks);
+        if (ret != 0) {
+                ir_free(map);
+                return ret;
+        }
+
+        /* event handler slots are assigned by the output generation */
+        memset(&map->event_handlers, 0, sizeof(map->event_handlers));
+
+        map->profilec = 0;
+        map->profilev = NULL;
+        map->profile_hot = 0;
+
+        map->generation_cache = false;
+        for (idx = 0; idx < map->entryc; idx++) {
+                entry_resolve_types(map, map->entries + idx);
+                if (entry_generation_cache(map->entries + idx)) {
+                        map->generation_cache = true;
+                }
+        }
+
+        /* callback interface arguments were resolved with their entry */
+        for (idx = 0; idx < map->callbackc; idx++) {
+                struct ir_callback_entry *callbacke;
+                int argc;
+
+                callbacke = map->callbacks + idx;
+                if (callbacke->interface != NULL) {
+                        continue;
+                }
+                for (argc = 0; argc < callbacke->argumentc; argc++) {
+                        type_resolve(map,
+                                     callbacke->argumentv[argc].typec,
+                                     callbacke->argumentv[argc].typev);
+                }
+        }
+
+        /* call frequency profile placing the generated functions */
+        if (options->profileuse != NULL) {
+                ret = profile_map_new(options->profileuse, map);
+                if (ret != 0) {
+                        ir_free(map);
+                        return ret;
+                }
+        }
+
+        *map_out = map;
+
+        return 0;
+}
+
+/* exported interface documented in ir.h */
+int ir_free(struct ir *ir)
+{
+        int idx;
+
+        if (ir == NULL) {
+                return 0;
+        }
+
+        /* entries output earlier did not look up their functions */
+        for (idx = 0; idx < ir->entryc; idx++) {
+                if (ir->entries[idx].current) {
+                        break;
+                }
+        }
+        profile_map_free(ir, options->profileuse, idx == ir->entryc);
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry_free(ir->entries + idx);
+        }
+        free(ir->entries);
+
+        for (idx = 0; idx < ir->enumerationc; idx++) {
+                free(ir->enumerations[idx].valuev);
+                free(ir->enumerations[idx].class_name);
+        }
+        free(ir->enumerations);
+
+        /* callback interfaces share the arguments of their entry */
+        for (idx = 0; idx < ir->callbackc; idx++) {
+                if (ir->callbacks[idx].interface == NULL) {
+                        argument_map_free(ir->callbacks[idx].argumentc,
+                                          ir->callbacks[idx].argumentv);
+                }
+                free(ir->callbacks[idx].class_name);
+        }
+        free(ir->callbacks);
+
+        /* the slot names belong to the attributes */
+        free(ir->event_handlers.valuev);
+        free(ir->event_handlers.class_name);
+
+        free(ir);
+
+        return 0;
+}
+
+/**
+ * hash the members of an interface left by pruning and whether each is
+ * generated as a stub
+ */
+static uint64_t
+interface_members_hash(struct ir_interface_entry *interfacee, uint64_t hash)
+{
+        int idx;
+
+        for (idx = 0; idx < interfacee->operationc; idx++) {
+                if (interfacee->operationv[idx].name != NULL) {
+                        hash = genb_hash(hash,
+                                         interfacee->operationv[idx].name,
+                                         strlen(interfacee->operationv[idx].name) + 1);
+                }
+                hash = genb_hash(hash,
+                                 &interfacee->operationv[idx].pruned,
+                                 sizeof(bool));
+        }
+        for (idx = 0; idx < interfacee->attributec; idx++) {
+                hash = genb_hash(hash,
+                                 interfacee->attributev[idx].name,
+                                 strlen(interfacee->attributev[idx].name) + 1);
+                hash = genb_hash(hash,
+                                 &interfacee->attributev[idx].pruned,
+                                 sizeof(bool));
+        }
+        for (idx = 0; idx < interfacee->constantc; idx++) {
+                hash = genb_hash(hash,
+                                 interfacee->constantv[idx].name,
+                                 strlen(interfacee->constantv[idx].name) + 1);
+        }
+
+        return hash;
+}
+
+/* exported interface documented in ir.h */
+int ir_fingerprint(struct ir *ir)
+{
+        struct ir_entry *entry;
+        uint64_t global;
+        uint64_t entries;
+        int idx;
+
+        /* the binding preface, prologue and so on are output with every
+         * entry
+         */
+        global = GENB_HASH_INIT;
+        if (ir->binding_node != NULL) {
+                global = genbind_node_hash(ir->binding_node, global);
+        }
+
+        /* any entry may refer to an enumeration */
+        for (idx = 0; idx < ir->enumerationc; idx++) {
+                global = webidl_node_hash(ir->enumerations[idx].node, global);
+        }
+
+        /* or to a callback function */
+        for (idx = 0; idx < ir->callbackc; idx++) {
+                if (ir->callbacks[idx].interface == NULL) {
+                        global = webidl_node_hash(ir->callbacks[idx].node,
+                                                  global);
+                }
+        }
+
+        /* the call profile places the functions of every entry */
+        for (idx = 0; idx < ir->profilec; idx++) {
+                global = genb_hash(global,
+                                   ir->profilev[idx].name,
+                                   strlen(ir->profilev[idx].name) + 1);
+                if (ir->profilev[idx].kind != NULL) {
+                        global = genb_hash(global,
+                                           ir->profilev[idx].kind,
+                                           strlen(ir->profilev[idx].kind) + 1);
+                }
+                global = genb_hash(global,
+                                   &ir->profilev[idx].count,
+                                   sizeof(unsigned long));
+        }
+
+        /* setters of every entry invalidate when any result is cached */
+        global = genb_hash(global, &ir->generation_cache, sizeof(bool));
+
+        /* the primary global creates the interface objects of all entries */
+        entries = GENB_HASH_INIT;
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+                entries = genb_hash(entries,
+                                    entry->name,
+                                    strlen(entry->name) + 1);
+                if (entry->type == IR_ENTRY_TYPE_INTERFACE) {
+                        entries = genb_hash(entries,
+                                            &entry->u.interface.noobject,
+                                            sizeof(bool));
+                }
+        }
+
+        /* entries are sorted so an inherited entry is fingerprinted first */
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+
+                entry->fingerprint = webidl_node_hash(entry->node, global);
+                if (entry->class != NULL) {
+                        entry->fingerprint = genbind_node_hash(
+                                entry->class, entry->fingerprint);
+                }
+                if (entry->type == IR_ENTRY_TYPE_INTERFACE) {
+                        entry->fingerprint = interface_members_hash(
+                                &entry->u.interface, entry->fingerprint);
+                }
+                entry->fingerprint = genb_hash(entry->fingerprint,
+                                               &entry->refcount,
+                                               sizeof(int));
+                if (entry->inherit_idx != -1) {
+                        entry->fingerprint = genb_hash(
+                                entry->fingerprint,
+                                &ir->entries[entry->inherit_idx].fingerprint,
+                                sizeof(uint64_t));
+                }
+                if ((entry->type == IR_ENTRY_TYPE_INTERFACE) &&
+                    (entry->u.interface.primary_global)) {
+                        entry->fingerprint = genb_hash(entry->fingerprint,
+                                                       &entries,
+                                                       sizeof(uint64_t));
+                }
+        }
+
+        return 0;
+}
+
+static int ir_dump_dictionary(FILE *dumpf, struct ir_entry *ecur)
+{
+        if (ecur->u.dictionary.memberc > 0) {
+                int argc;
+
+                fprintf(dumpf, "\t%d members\n", ecur->u.dictionary.memberc);
+
+                for (argc = 0; argc < ecur->u.dictionary.memberc; argc++) {
+                        struct ir_operation_argument_entry *arge;
+
+                        arge = ecur->u.dictionary.memberv + argc;
+
+                        fprintf(dumpf, "\t\t%s\n", arge->name);
+
+                        if (arge->optionalc != 0) {
+                                fprintf(dumpf,
+                                        "\t\t\toptional:%d\n",
+                                        arge->optionalc);
+                        }
+
+                        if (arge->elipsisc != 0) {
+                                fprintf(dumpf,
+                                        "\t\t\telipsis:%d\n",
+                                        arge->elipsisc);
+                        }
+                }
+        }
+        return 0;
+}
+
+static int ir_dump_interface(FILE *dumpf, struct ir_entry *ecur)
+{
+        if (ecur->u.interface.operationc > 0) {
+                int opc;
+
+                fprintf(dumpf, "\t%d operations\n",
+                        ecur->u.interface.operationc);
+
+                for (opc = 0; opc < ecur->u.interface.operationc; opc++) {
+                        int ovlc;
+                        struct ir_operation_entry *ope;
+
+                        ope = ecur->u.interface.operationv + opc;
+
+                        fprintf(dumpf,
+                                "\t\t%s\n",
+                                ope->name);
+                        fprintf(dumpf,
+                                "\t\t\tmethod:%p\n",
+                                ope->method);
+                        for(ovlc = 0; ovlc < ope->overloadc;ovlc++) {
+                                int argc;
+                                struct ir_operation_overload_entry *ovle;
+                                ovle = ope->overloadv + ovlc;
+
+                                fprintf(dumpf,
+                                        "\t\t\toverload:%d\n", ovlc);
+
+                                fprintf(dumpf,
+                                        "\t\t\t\treturn type:%p\n",
+                                        ovle->type);
+
+                                fprintf(dumpf,
+                                        "\t\t\t\targuments:%d\n",
+                                        ovle->argumentc);
+
+                                fprintf(dumpf,
+                                        "\t\t\t\toptionals:%d\n",
+                                        ovle->optionalc);
+
+                                fprintf(dumpf,
+                                        "\t\t\t\telipsis:%d\n",
+                                        ovle->elipsisc);
 
                                 for (argc = 0; argc < ovle->argumentc; argc++) {
                                         struct ir_operation_argument_entry *arge;
@@ -1125,6 +3032,28 @@ static int ir_dump_interface(FILE *dumpf, struct ir_entry *ecur)
                         fprintf(dumpf, "\t\t%s\n", cone->name);
                 }
         }
+        if (ecur->u.interface.iterable.type != IR_ITERABLE_NONE) {
+                struct ir_iterable_entry *itere;
+                int typec;
+
+                itere = &ecur->u.interface.iterable;
+
+                fprintf(dumpf, "\t%s %p\n",
+                        itere->method_name,
+                        itere->method);
+                for (typec = 0; typec < itere->keytypec; typec++) {
+                        fprintf(dumpf, "\t\tkey type:%s\n",
+                                webidl_type_to_str(
+                                        itere->keytypev[typec].modifier,
+                                        itere->keytypev[typec].base));
+                }
+                for (typec = 0; typec < itere->valuetypec; typec++) {
+                        fprintf(dumpf, "\t\tvalue type:%s\n",
+                                webidl_type_to_str(
+                                        itere->valuetypev[typec].modifier,
+                                        itere->valuetypev[typec].base));
+                }
+        }
         return 0;
 }
 
@@ -1167,6 +3096,36 @@ int ir_dump(struct ir *ir)
                 ecur++;
         }
 
+        for (eidx = 0; eidx < ir->enumerationc; eidx++) {
+                struct ir_enumeration_entry *enume;
+                int vidx;
+
+                enume = ir->enumerations + eidx;
+                fprintf(dumpf, "enum %s\n", enume->name);
+                for (vidx = 0; vidx < enume->valuec; vidx++) {
+                        fprintf(dumpf, "\t\"%s\"\n", enume->valuev[vidx]);
+                }
+        }
+
+        for (eidx = 0; eidx < ir->callbackc; eidx++) {
+                struct ir_callback_entry *callbacke;
+                int argc;
+
+                callbacke = ir->callbacks + eidx;
+                if (callbacke->interface != NULL) {
+                        fprintf(dumpf, "callback interface %s\n",
+                                callbacke->name);
+                        fprintf(dumpf, "\toperation:%s\n",
+                                callbacke->operation_name);
+                } else {
+                        fprintf(dumpf, "callback %s\n", callbacke->name);
+                }
+                for (argc = 0; argc < callbacke->argumentc; argc++) {
+                        fprintf(dumpf, "\t\t%s\n",
+                                callbacke->argumentv[argc].name);
+                }
+        }
+
         fclose(dumpf);
 
         return 0;
@@ -9,8 +9,52 @@
 #ifndef nsgenbind_ir_h
 #define nsgenbind_ir_h
 
+#include <stdbool.h>
+#include <stdint.h>
+
 struct genbind_node;
 struct webidl_node;
+struct ir_enumeration_entry;
+struct ir_callback_entry;
+
+/**
+ * ir entry for type of attributes or arguments.
+ */
+struct ir_type_entry {
+        enum webidl_type base; /**< base of the type (long, short, user etc.) */
+        enum webidl_type_modifier modifier; /**< modifier for the type */
+        bool nullable; /**< the type is nullable */
+        const char *name; /**< name of type for user types */
+        struct ir_enumeration_entry *enumeration; /**< enumeration a user
+                                                   * type names (if any)
+                                                   */
+        struct ir_callback_entry *callback; /**< callback function or
+                                             * interface a user type names
+                                             * (if any)
+                                             */
+};
+
+/**
+ * kind of default value on an optional argument or dictionary member
+ */
+enum ir_default_type {
+        IR_DEFAULT_NONE, /**< no default value was given */
+        IR_DEFAULT_NULL, /**< the default is null */
+        IR_DEFAULT_BOOL, /**< the default is a boolean in intval */
+        IR_DEFAULT_INT, /**< the default is an integer in intval */
+        IR_DEFAULT_FLOAT, /**< the default is a number in fltval */
+        IR_DEFAULT_STRING, /**< the default is a string in text */
+};
+
+/**
+ * ir entry for the default value of an argument
+ */
+struct ir_default_entry {
+        enum ir_default_type type; /**< kind of default */
+        int intval; /**< value of integer and boolean defaults */
+        float fltval; /**< value of floating point defaults */
+        const char *text; /**< value of string defaults */
+};
 
 /**
  * map entry for each argument of an overload on an operation
@@ -21,6 +65,11 @@ struct ir_operation_argument_entry {
         int optionalc; /**< 1 if the argument is optional */
         int elipsisc; /**< 1 if the argument is an elipsis */
 
+        int typec; /**< number of types for argument */
+        struct ir_type_entry *typev; /**< types on argument */
+
+        struct ir_default_entry defl; /**< default value if optional */
+
         struct webidl_node *node;
 };
 
@@ -45,16 +94,21 @@ struct ir_operation_entry {
 
         int overloadc; /**< Number of overloads of this operation */
         struct ir_operation_overload_entry *overloadv;
+
+        bool pruned; /**< operation is pruned and generated as a stub */
 };
 
 /**
- * ir entry for type of attributes or arguments.
+ * caching of attribute getter results
  */
-struct ir_type_entry {
-        enum webidl_type base; /**< base of the type (long, short, user etc.) */
-        enum webidl_type_modifier modifier; /**< modifier for the type */
-        bool nullable; /**< the type is nullable */
-        const char *name; /**< name of type for user types */
+enum ir_attribute_cache {
+        IR_ATTRIBUTE_CACHE_NONE, /**< getter called on every read */
+        IR_ATTRIBUTE_CACHE_INSTANCE, /**< [SameObject] or [Constant] result
+                                      * kept for the life of the instance
+                                      */
+        IR_ATTRIBUTE_CACHE_GENERATION, /**< [Pure] result kept until the
+                                        * native object is invalidated
+                                        */
 };
 
 /**
@@ -70,6 +124,8 @@ struct ir_attribute_entry {
         enum webidl_type_modifier modifier; /**< modifier for the attribute intself */
         const char *putforwards; /**< putforwards attribute */
         const char *treatnullas; /**< treatnullas attribute */
+        enum ir_attribute_cache cache; /**< caching of the getter result */
+        bool pruned; /**< attribute is pruned and generated as a stub */
 
         struct genbind_node *getter; /**< getter from binding */
         struct genbind_node *setter; /**< getter from binding */
@@ -90,6 +146,35 @@ struct ir_constant_entry {
 };
 
 
+/**
+ * kind of iteration declared on an interface
+ */
+enum ir_iterable_type {
+        IR_ITERABLE_NONE, /**< the interface is not iterable */
+        IR_ITERABLE_VALUE, /**< iterable<V> keyed by index */
+        IR_ITERABLE_PAIR, /**< iterable<K, V> */
+        IR_ITERABLE_MAPLIKE, /**< maplike<K, V> */
+        IR_ITERABLE_SETLIKE, /**< setlike<V> */
+};
+
+/**
+ * ir entry for an iterable, maplike or setlike declaration
+ */
+struct ir_iterable_entry {
+        enum ir_iterable_type type; /**< kind of declaration */
+        struct webidl_node *node; /**< AST declaration node */
+        bool readonly; /**< maplike or setlike is readonly */
+
+        int keytypec; /**< number of key types */
+        struct ir_type_entry *keytypev; /**< key types or NULL */
+
+        int valuetypec; /**< number of value types */
+        struct ir_type_entry *valuetypev; /**< value types */
+
+        const char *method_name; /**< name of binding iteration method */
+        struct genbind_node *method; /**< iteration method from binding */
+};
+
 /** map entry for an interface */
 struct ir_interface_entry {
         bool noobject; /**< flag indicating if no interface object should eb
@@ -103,11 +188,22 @@ struct ir_interface_entry {
         int operationc; /**< number of operations on interface */
         struct ir_operation_entry *operationv;
 
+        struct ir_operation_entry *indexed_getter; /**< operation which is the
+                                                    * indexed property getter
+                                                    * or NULL
+                                                    */
+        struct ir_operation_entry *named_getter; /**< operation which is the
+                                                  * named property getter or
+                                                  * NULL
+                                                  */
+
         int attributec; /**< number of attributes on interface */
         struct ir_attribute_entry *attributev;
 
         int constantc; /**< number of constants on interface */
         struct ir_constant_entry *constantv;
+
+        struct ir_iterable_entry iterable; /**< iteration declaration */
 };
 
 /**
@@ -118,6 +214,56 @@ struct ir_dictionary_entry {
         struct ir_operation_argument_entry *memberv;
 };
 
+/**
+ * map entry for an enumeration
+ */
+struct ir_enumeration_entry {
+        const char *name; /**< IDL name */
+        struct webidl_node *node; /**< AST node */
+
+        int valuec; /**< number of values */
+        const char **valuev; /**< values in declaration order */
+
+        char *class_name; /**< the enumeration name converted to output
+                           * appropriate value.
+                           */
+};
+
+/**
+ * map entry for a callback function or callback interface
+ */
+struct ir_callback_entry {
+        const char *name; /**< IDL name */
+        struct webidl_node *node; /**< AST callback or interface node */
+
+        struct ir_entry *interface; /**< callback interface entry or NULL
+                                     * for a callback function
+                                     */
+        const char *operation_name; /**< operation invoked on callback
+                                     * interface objects which are not
+                                     * callable
+                                     */
+
+        int argumentc; /**< the number of arguments */
+        struct ir_operation_argument_entry *argumentv; /**< arguments in
+                                                        * declaration order
+                                                        */
+
+        char *class_name; /**< the callback name converted to output
+                           * appropriate value.
+                           */
+};
+
+/**
+ * number of calls to a binding function from a call frequency profile
+ */
+struct ir_profile_entry {
+        char *name; /**< interface and member e.g. Node::firstChild */
+        char *kind; /**< kind of function or NULL to match any */
+        unsigned long count; /**< number of calls */
+        bool used; /**< a generated function matched the entry */
+};
+
 enum ir_entry_type {
         IR_ENTRY_TYPE_INTERFACE,
         IR_ENTRY_TYPE_DICTIONARY,
@@ -158,6 +304,13 @@ struct ir_entry {
         int class_init_argc; /**< The number of parameters on the class
                               * initializer.
                               */
+
+        uint64_t fingerprint; /**< hash of the input the output of the entry
+                               * is generated from, set by ir_fingerprint()
+                               */
+        bool current; /**< the output of the entry is already up to date
+                       * and is not generated again
+                       */
 };
 
 /** intermediate representation of WebIDL and binding data */
@@ -165,6 +318,35 @@ struct ir {
         int entryc; /**< count of entries */
         struct ir_entry *entries; /**< interface entries */
 
+        int enumerationc; /**< count of enumerations */
+        struct ir_enumeration_entry *enumerations; /**< enumerations sorted
+                                                    * by name
+                                                    */
+
+        int callbackc; /**< count of callbacks */
+        struct ir_callback_entry *callbacks; /**< callback functions and
+                                              * interfaces sorted by name
+                                              */
+
+        /** Some attribute result is kept until the object changes so
+         * setters must invalidate the native object.
+         */
+        bool generation_cache;
+
+        /** event handler slots created and used by the output generation
+         * with a value for each event name, valuec is zero when there
+         * are no event handler attributes
+         */
+        struct ir_enumeration_entry event_handlers;
+
+        int profilec; /**< count of call frequency profile entries */
+        struct ir_profile_entry *profilev; /**< call frequency profile
+                                            * entries sorted by name
+                                            */
+        unsigned long profile_hot; /**< least number of calls made to a
+                                    * function marked hot
+                                    */
+
         /** The AST node of the binding information */
         struct genbind_node *binding_node;
 
@@ -179,6 +361,57 @@ int ir_new(struct genbind_node *genbind,
                       struct webidl_node *webidl,
                       struct ir **map_out);
 
+/**
+ * Free an intermediate representation
+ *
+ * The ASTs the representation was created from are not freed.
+ *
+ * \param ir The intermediate representation to free or NULL.
+ * \return 0 on success.
+ */
+int ir_free(struct ir *ir);
+
+/**
+ * Compute the fingerprint of each entry
+ *
+ * An entry whose fingerprint is unchanged since its output was generated
+ * would generate the same output again.
+ *
+ * \param ir The intermediate representation to fingerprint.
+ * \return 0 on success.
+ */
+int ir_fingerprint(struct ir *ir);
+
+/**
+ * Find the number of calls made to a function in the call profile
+ *
+ * The profile given with --profile-use is read when the intermediate
+ * representation is created. Profile entries the function matches are
+ * marked as used.
+ *
+ * \param ir The intermediate representation holding the profile.
+ * \param entry The interface the function is generated for.
+ * \param member The name of the member or NULL for the interface itself.
+ * \param kind The kind of function e.g. "getter" or NULL.
+ * \return The number of calls which is zero for functions not profiled.
+ */
+unsigned long ir_profile_count(struct ir *ir, struct ir_entry *entry, const char *member, const char *kind);
+
+/**
+ * Prune the interfaces and members of an intermediate representation
+ *
+ * The manifest lists an interface or Interface::member on each line to
+ * keep, or to prune when prefixed with !. When anything is listed to be
+ * kept other interfaces are pruned and an interface only listed by its
+ * members keeps just those members. Inherited interfaces, the primary
+ * global, callback interfaces and dictionaries are always kept.
+ *
+ * \param ir The intermediate representation to prune.
+ * \param filename The manifest file.
+ * \return 0 on success.
+ */
+int ir_prune(struct ir *ir, const char *filename);
+
 int ir_dump(struct ir *map);
 
 int ir_dumpdot(struct ir *map);
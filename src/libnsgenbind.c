@@ -0,0 +1,596 @@
+/* embeddable binding generator implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "options.h"
+#include "utils.h"
+#include "nsgenbind-ast.h"
+#include "webidl-ast.h"
+#include "ir.h"
+#include "duk-libdom.h"
+#include "stats.h"
+#include "libnsgenbind.h"
+
+/** options of the context in use */
+struct options *options;
+
+enum bindingtype_e {
+    BINDINGTYPE_UNKNOWN,
+    BINDINGTYPE_JSAPI_LIBDOM,
+    BINDINGTYPE_DUK_LIBDOM,
+};
+
+/**
+ * parsed IDL held by a context
+ */
+struct nsgenbind_idl {
+        struct nsgenbind_idl *next; /**< next IDL in the context */
+        int filec; /**< number of IDL files */
+        char **filev; /**< names of the IDL files */
+        struct webidl_node *webidl_root; /**< IDL AST */
+        int refcount; /**< number of bindings using the IDL */
+        bool invalid; /**< the IDL is not to be reused */
+};
+
+struct nsgenbind_ctx {
+        struct options options; /**< options used for generation */
+        struct nsgenbind_idl *idl; /**< parsed IDL */
+};
+
+struct nsgenbind_binding {
+        struct nsgenbind_ctx *ctx; /**< context the binding was parsed in */
+        char *infilename; /**< binding source */
+        char *outdirname; /**< output directory */
+        struct genbind_node *genbind_root; /**< binding AST */
+        enum bindingtype_e bindingtype; /**< type of binding */
+        int idlfilec; /**< number of IDL files the binding uses */
+        char **idlfilev; /**< names of IDL files the binding uses */
+        struct nsgenbind_idl *idl; /**< IDL loaded by the context */
+        struct webidl_node *webidl_root; /**< IDL AST the binding uses */
+        bool hasidl; /**< the IDL AST has been loaded or set */
+};
+
+/**
+ * make the options of a context the global options
+ *
+ * The generator modules read the global options so they are swapped for
+ * the duration of each call, which is why the library is neither thread
+ * safe nor reentrant.
+ *
+ * \return The previous global options to be restored after the call.
+ */
+static struct options *
+ctx_select(struct nsgenbind_ctx *ctx, char *infilename, char *outdirname)
+{
+        struct options *prev = options;
+
+        options = &ctx->options;
+        options->infilename = infilename;
+        options->outdirname = outdirname;
+
+        return prev;
+}
+
+static void idl_free(struct nsgenbind_idl *idl)
+{
+        int fidx;
+
+        webidl_node_free(idl->webidl_root);
+        for (fidx = 0; fidx < idl->filec; fidx++) {
+                free(idl->filev[fidx]);
+        }
+        free(idl->filev);
+        free(idl);
+}
+
+/**
+ * release a bindings use of IDL
+ *
+ * Invalid IDL is freed once it is no longer used.
+ */
+static void idl_unref(struct nsgenbind_ctx *ctx, struct nsgenbind_idl *idl)
+{
+        struct nsgenbind_idl **prev;
+
+        idl->refcount--;
+        if ((idl->refcount > 0) || (!idl->invalid)) {
+                return;
+        }
+
+        for (prev = &ctx->idl; *prev != NULL; prev = &(*prev)->next) {
+                if (*prev == idl) {
+                        *prev = idl->next;
+                        break;
+                }
+        }
+        idl_free(idl);
+}
+
+static int webidl_file_cb(struct genbind_node *node, void *ctx)
+{
+	struct webidl_node **webidl_ast = ctx;
+	char *filename;
+        struct stats_mark start;
+        int res;
+
+	filename = genbind_node_gettext(node);
+
+        if (options->verbose) {
+                printf("Opening IDL file \"%s\"\n", filename);
+        }
+
+        stats_mark(&start);
+	res = webidl_parsefile(filename, webidl_ast);
+        stats_idlfile(filename, &start);
+
+        return res;
+}
+
+static int genbind_load_idl(struct genbind_node *genbind,
+                            struct webidl_node **webidl_out)
+{
+        int res;
+        struct genbind_node *binding_node;
+        struct stats_mark start;
+
+        stats_mark(&start);
+
+        binding_node = genbind_node_find_type(genbind, NULL,
+                                              GENBIND_NODE_TYPE_BINDING);
+
+	/* walk AST and load any web IDL files required */
+	res = genbind_node_foreach_type(
+                genbind_node_getnode(binding_node),
+                GENBIND_NODE_TYPE_WEBIDL,
+                webidl_file_cb,
+                webidl_out);
+	if (res != 0) {
+		fprintf(stderr, "Error: failed reading Web IDL\n");
+		return -1;
+	}
+        stats_phase(STATS_PHASE_IDL, &start);
+
+        /* implements are implemented as mixins so intercalate them */
+        stats_mark(&start);
+        res = webidl_intercalate_implements(*webidl_out);
+        stats_phase(STATS_PHASE_INTERCALATE, &start);
+	if (res != 0) {
+		fprintf(stderr, "Error: Failed to intercalate implements\n");
+		return -1;
+	}
+
+        return 0;
+}
+
+/**
+ * get the type of binding
+ */
+static enum bindingtype_e genbind_get_type(struct genbind_node *node)
+{
+        struct genbind_node *binding_node;
+        const char *binding_type;
+
+        binding_node = genbind_node_find_type(node,
+                                              NULL,
+                                              GENBIND_NODE_TYPE_BINDING);
+        if (binding_node == NULL) {
+            /* binding entry is missing which is invalid */
+            return BINDINGTYPE_UNKNOWN;
+        }
+
+        binding_type = genbind_node_gettext(
+                genbind_node_find_type(
+                        genbind_node_getnode(binding_node),
+                        NULL,
+                        GENBIND_NODE_TYPE_NAME));
+        if (binding_type == NULL) {
+                fprintf(stderr, "Error: missing binding type\n");
+                return BINDINGTYPE_UNKNOWN;
+        }
+
+        if (strcmp(binding_type, "jsapi_libdom") == 0) {
+                return BINDINGTYPE_JSAPI_LIBDOM;
+        }
+
+        if (strcmp(binding_type, "duk_libdom") == 0) {
+                return BINDINGTYPE_DUK_LIBDOM;
+        }
+
+        fprintf(stderr, "Error: unsupported binding type \"%s\"\n", binding_type);
+
+        return BINDINGTYPE_UNKNOWN;
+}
+
+static int idl_list_cb(struct genbind_node *node, void *ctx)
+{
+        struct nsgenbind_binding *binding = ctx;
+        char **idlfilev;
+
+        idlfilev = realloc(binding->idlfilev,
+                           (binding->idlfilec + 1) * sizeof(char *));
+        if (idlfilev == NULL) {
+                return -1;
+        }
+        idlfilev[binding->idlfilec++] = genbind_node_gettext(node);
+        binding->idlfilev = idlfilev;
+
+        return 0;
+}
+
+/**
+ * check if parsed IDL is of exactly the IDL files a binding uses
+ */
+static bool idl_match(struct nsgenbind_idl *idl, struct nsgenbind_binding *binding)
+{
+        int fidx;
+
+        if (idl->filec != binding->idlfilec) {
+                return false;
+        }
+        for (fidx = 0; fidx < idl->filec; fidx++) {
+                if (strcmp(idl->filev[fidx], binding->idlfilev[fidx]) != 0) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+/**
+ * parse a binding file and establish which IDL files it requires
+ */
+static int binding_parse(struct nsgenbind_binding *binding)
+{
+        int res;
+        struct genbind_node *binding_node;
+        struct stats_mark start;
+
+        /* parse binding */
+        stats_mark(&start);
+        res = genbind_parsefile(binding->infilename, &binding->genbind_root);
+        if (res != 0) {
+                fprintf(stderr, "Error: parse failed with code %d\n", res);
+                return res;
+        }
+        stats_phase(STATS_PHASE_BINDING, &start);
+
+        /* dump the binding AST */
+        stats_mark(&start);
+        genbind_dump_ast(binding->genbind_root);
+        stats_phase(STATS_PHASE_DUMP, &start);
+
+        /* get type of binding */
+        binding->bindingtype = genbind_get_type(binding->genbind_root);
+        if (binding->bindingtype == BINDINGTYPE_UNKNOWN) {
+                return 3;
+        }
+
+        binding_node = genbind_node_find_type(binding->genbind_root,
+                                              NULL,
+                                              GENBIND_NODE_TYPE_BINDING);
+        res = genbind_node_foreach_type(genbind_node_getnode(binding_node),
+                                        GENBIND_NODE_TYPE_WEBIDL,
+                                        idl_list_cb,
+                                        binding);
+        if (res > 0) {
+                return -1;
+        }
+
+        return 0;
+}
+
+/**
+ * load the IDL for a binding
+ *
+ * The IDL AST is not altered once implements have been intercalated
+ * so a binding using exactly the same IDL files as an earlier one
+ * shares its AST instead of parsing them again.
+ */
+static int binding_load_idl(struct nsgenbind_binding *binding)
+{
+        struct nsgenbind_ctx *ctx = binding->ctx;
+        struct nsgenbind_idl *idl;
+        int fidx;
+        int res;
+
+        for (idl = ctx->idl; idl != NULL; idl = idl->next) {
+                if ((!idl->invalid) && idl_match(idl, binding)) {
+                        if (options->verbose) {
+                                printf("Sharing IDL with %s\n",
+                                       binding->infilename);
+                        }
+                        idl->refcount++;
+                        binding->idl = idl;
+                        binding->webidl_root = idl->webidl_root;
+                        binding->hasidl = true;
+                        return 0;
+                }
+        }
+
+        idl = calloc(1, sizeof(*idl));
+        if (idl == NULL) {
+                return -1;
+        }
+        if (binding->idlfilec > 0) {
+                idl->filev = calloc(binding->idlfilec, sizeof(char *));
+                if (idl->filev == NULL) {
+                        free(idl);
+                        return -1;
+                }
+        }
+        for (fidx = 0; fidx < binding->idlfilec; fidx++) {
+                idl->filev[fidx] = strdup(binding->idlfilev[fidx]);
+                idl->filec++;
+        }
+
+        /* load the IDL files specified in the binding */
+        res = genbind_load_idl(binding->genbind_root, &idl->webidl_root);
+        if (res != 0) {
+                idl_free(idl);
+                return 4;
+        }
+
+        idl->refcount = 1;
+        idl->next = ctx->idl;
+        ctx->idl = idl;
+        binding->idl = idl;
+        binding->webidl_root = idl->webidl_root;
+        binding->hasidl = true;
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_ctx_new(const struct options *opts, struct nsgenbind_ctx **ctx_out)
+{
+        struct nsgenbind_ctx *ctx;
+
+        ctx = calloc(1, sizeof(struct nsgenbind_ctx));
+        if (ctx == NULL) {
+                return -1;
+        }
+        ctx->options = *opts;
+
+        *ctx_out = ctx;
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_ctx_free(struct nsgenbind_ctx *ctx)
+{
+        struct nsgenbind_idl *idl;
+        struct options *prev;
+
+        prev = ctx_select(ctx, NULL, NULL);
+        while (ctx->idl != NULL) {
+                idl = ctx->idl;
+                ctx->idl = idl->next;
+                idl_free(idl);
+        }
+        options = prev;
+
+        free(ctx);
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_binding_new(struct nsgenbind_ctx *ctx,
+                          const char *filename,
+                          const char *outdirname,
+                          struct nsgenbind_binding **binding_out)
+{
+        struct nsgenbind_binding *binding;
+        struct options *prev;
+        int res;
+
+        binding = calloc(1, sizeof(struct nsgenbind_binding));
+        if (binding == NULL) {
+                return -1;
+        }
+        binding->ctx = ctx;
+        binding->infilename = strdup(filename);
+        binding->outdirname = strdup(outdirname);
+        if ((binding->infilename == NULL) || (binding->outdirname == NULL)) {
+                nsgenbind_binding_free(binding);
+                return -1;
+        }
+
+        prev = ctx_select(ctx, binding->infilename, binding->outdirname);
+
+        res = binding_parse(binding);
+
+        options = prev;
+
+        if (res != 0) {
+                nsgenbind_binding_free(binding);
+                return res;
+        }
+
+        *binding_out = binding;
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_binding_load_idl(struct nsgenbind_binding *binding)
+{
+        struct options *prev;
+        int res;
+
+        if (binding->hasidl) {
+                return 0;
+        }
+
+        prev = ctx_select(binding->ctx,
+                          binding->infilename,
+                          binding->outdirname);
+
+        res = binding_load_idl(binding);
+
+        options = prev;
+
+        return res;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_binding_set_idl(struct nsgenbind_binding *binding,
+                              struct webidl_node *webidl_root)
+{
+        if (binding->idl != NULL) {
+                idl_unref(binding->ctx, binding->idl);
+                binding->idl = NULL;
+        }
+        binding->webidl_root = webidl_root;
+        binding->hasidl = true;
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_binding_free(struct nsgenbind_binding *binding)
+{
+        if (binding->idl != NULL) {
+                idl_unref(binding->ctx, binding->idl);
+        }
+        genbind_node_free(binding->genbind_root);
+        free(binding->idlfilev);
+        free(binding->infilename);
+        free(binding->outdirname);
+        free(binding);
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+const char *
+nsgenbind_binding_idlfile(const struct nsgenbind_binding *binding, int idx)
+{
+        if ((idx < 0) || (idx >= binding->idlfilec)) {
+                return NULL;
+        }
+        return binding->idlfilev[idx];
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_idl_invalidate(struct nsgenbind_binding *binding)
+{
+        if (binding->idl != NULL) {
+                binding->idl->invalid = true;
+        }
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_ir_new(struct nsgenbind_binding *binding, struct ir **ir_out)
+{
+        struct options *prev;
+        struct ir *ir = NULL;
+        struct stats_mark start;
+        int res;
+
+        if (!binding->hasidl) {
+                fprintf(stderr, "Error: IDL for %s is not loaded\n",
+                        binding->infilename);
+                return 4;
+        }
+
+        prev = ctx_select(binding->ctx,
+                          binding->infilename,
+                          binding->outdirname);
+
+	/* debug dump of web idl AST */
+        stats_mark(&start);
+        webidl_dump_ast(binding->webidl_root);
+        stats_phase(STATS_PHASE_DUMP, &start);
+
+        /* generate intermediate representation */
+        stats_mark(&start);
+        res = ir_new(binding->genbind_root, binding->webidl_root, &ir);
+        if ((res == 0) && (options->prunefilename != NULL)) {
+                res = ir_prune(ir, options->prunefilename);
+                if (res != 0) {
+                        ir_free(ir);
+                }
+        }
+        stats_phase(STATS_PHASE_IR, &start);
+        if (res != 0) {
+                options = prev;
+                return 5;
+        }
+
+        /* dump the intermediate representation */
+        stats_mark(&start);
+        ir_dump(ir);
+        ir_dumpdot(ir);
+        stats_phase(STATS_PHASE_DUMP, &start);
+
+        options = prev;
+
+        *ir_out = ir;
+
+        return 0;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_ir_free(struct nsgenbind_binding *binding, struct ir *ir)
+{
+        struct options *prev;
+        int res;
+
+        prev = ctx_select(binding->ctx,
+                          binding->infilename,
+                          binding->outdirname);
+
+        res = ir_free(ir);
+
+        options = prev;
+
+        return res;
+}
+
+/* exported interface documented in libnsgenbind.h */
+int nsgenbind_output(struct nsgenbind_binding *binding,
+                     struct ir *ir,
+                     nsgenbind_output_cb *cb,
+                     void *pw)
+{
+        struct options *prev;
+        struct stats_mark start;
+        int res;
+
+        prev = ctx_select(binding->ctx,
+                          binding->infilename,
+                          binding->outdirname);
+        options->output = cb;
+        options->outputpw = pw;
+
+        /* generate binding */
+        stats_mark(&start);
+        switch (binding->bindingtype) {
+        case BINDINGTYPE_DUK_LIBDOM:
+                res = duk_libdom_output(ir);
+                break;
+
+        default:
+                fprintf(stderr, "Unable to generate binding of this type\n");
+                res = 7;
+        }
+        stats_phase(STATS_PHASE_OUTPUT, &start);
+
+        options->output = NULL;
+        options->outputpw = NULL;
+        options = prev;
+
+        return res;
+}
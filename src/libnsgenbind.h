@@ -0,0 +1,172 @@
+/* embeddable binding generator interface
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+/*
+ * The library is single threaded and not reentrant. The generator
+ * modules keep process global state (the options, statistics, report
+ * and parser state) so calls must not be made from more than one thread
+ * at a time, and an output callback must not call back into the
+ * library.
+ */
+
+#ifndef nsgenbind_libnsgenbind_h
+#define nsgenbind_libnsgenbind_h
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "options.h"
+
+struct ir;
+struct webidl_node;
+
+/**
+ * generator context
+ *
+ * A context holds the options used for generation and the parsed IDL
+ * so bindings using the same IDL files do not parse them again.
+ */
+struct nsgenbind_ctx;
+
+/**
+ * a parsed binding and the IDL it uses
+ */
+struct nsgenbind_binding;
+
+/**
+ * Create a generator context
+ *
+ * Each call made with a context makes its options the global options
+ * for the duration of the call so several contexts may be used in turn
+ * from one thread.
+ *
+ * \param opts The options to generate with, they are copied but the
+ *             strings they refer to must remain valid for the life of
+ *             the context. The input and output names, binding lists,
+ *             jobs and watch options are not used.
+ * \param ctx_out Updated with the new context.
+ * \return 0 on success or -1 on memory exhaustion.
+ */
+int nsgenbind_ctx_new(const struct options *opts, struct nsgenbind_ctx **ctx_out);
+
+/**
+ * Free a generator context and the IDL it holds
+ *
+ * All the bindings parsed with the context must have been freed.
+ */
+int nsgenbind_ctx_free(struct nsgenbind_ctx *ctx);
+
+/**
+ * Parse a binding
+ *
+ * The IDL the binding uses is not loaded, see
+ * nsgenbind_binding_load_idl() and nsgenbind_binding_set_idl().
+ *
+ * \param ctx The generator context.
+ * \param filename The binding file to parse.
+ * \param outdirname The directory the binding is generated into, debug
+ *                   output is written there and generated sources
+ *                   include headers by their path within it.
+ * \param binding_out Updated with the parsed binding.
+ * \return 0 on success or the non zero code the command line tool
+ *         exits with on the same failure.
+ */
+int nsgenbind_binding_new(struct nsgenbind_ctx *ctx, const char *filename, const char *outdirname, struct nsgenbind_binding **binding_out);
+
+/**
+ * Load the IDL a binding uses
+ *
+ * IDL already parsed by the context for a binding naming exactly the
+ * same IDL files is used rather than parsing it again.
+ *
+ * \param binding The parsed binding.
+ * \return 0 on success or the non zero code the command line tool
+ *         exits with on the same failure.
+ */
+int nsgenbind_binding_load_idl(struct nsgenbind_binding *binding);
+
+/**
+ * Use a caller supplied IDL AST for a binding
+ *
+ * Any IDL loaded by the context for the binding is released. The AST
+ * must have had its implements intercalated and remains owned by the
+ * caller, it must stay valid until the binding is freed or given
+ * another AST.
+ *
+ * \param binding The parsed binding.
+ * \param webidl_root The IDL AST.
+ */
+int nsgenbind_binding_set_idl(struct nsgenbind_binding *binding, struct webidl_node *webidl_root);
+
+/**
+ * Free a parsed binding
+ *
+ * IDL no longer used by any binding is kept by the context for reuse
+ * unless it has been invalidated.
+ */
+int nsgenbind_binding_free(struct nsgenbind_binding *binding);
+
+/**
+ * Get the name of an IDL file a binding uses
+ *
+ * \param binding The binding.
+ * \param idx The index of the IDL file.
+ * \return The IDL file name as given in the binding or NULL if there is
+ *         no file at the index.
+ */
+const char *nsgenbind_binding_idlfile(const struct nsgenbind_binding *binding, int idx);
+
+/**
+ * Stop reusing the IDL a binding uses
+ *
+ * Bindings parsed afterwards parse their IDL files again, the IDL is
+ * freed once the bindings already using it are freed.
+ */
+int nsgenbind_idl_invalidate(struct nsgenbind_binding *binding);
+
+/**
+ * Create the intermediate representation of a binding
+ *
+ * The manifest in the options is applied if one was given.
+ *
+ * \param binding The parsed binding with its IDL.
+ * \param ir_out Updated with the intermediate representation which
+ *               must be freed before the binding.
+ * \return 0 on success or the non zero code the command line tool
+ *         exits with on the same failure.
+ */
+int nsgenbind_ir_new(struct nsgenbind_binding *binding, struct ir **ir_out);
+
+/**
+ * Free an intermediate representation
+ *
+ * Call frequency profile entries which matched no generated function
+ * are warned about when the intermediate representation is freed.
+ *
+ * \param binding The binding the intermediate representation was
+ *                created from.
+ * \param ir The intermediate representation.
+ */
+int nsgenbind_ir_free(struct nsgenbind_binding *binding, struct ir *ir);
+
+/**
+ * Generate the output of a binding
+ *
+ * The intermediate representation may be output any number of times.
+ *
+ * \param binding The parsed binding.
+ * \param ir The intermediate representation of the binding.
+ * \param cb Callback passed each generated file or NULL to write the
+ *           files into the output directory of the binding.
+ * \param pw Context passed to the callback.
+ * \return 0 on success or the non zero code the command line tool
+ *         exits with on the same failure.
+ */
+int nsgenbind_output(struct nsgenbind_binding *binding, struct ir *ir, nsgenbind_output_cb *cb, void *pw);
+
+#endif
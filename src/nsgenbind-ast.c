@@ -29,6 +29,9 @@ static FILE *genbind_parsetracef;
 extern int nsgenbind_debug;
 extern int nsgenbind__flex_debug;
 extern void nsgenbind_restart(FILE*);
+extern struct yy_buffer_state *nsgenbind__scan_buffer(char *base, size_t size);
+extern int nsgenbind_lex_destroy(void);
+extern int nsgenbind_lex_release(void);
 extern int nsgenbind_parse(char *filename, struct genbind_node **genbind_ast);
 
 /* terminal nodes have a value only */
@@ -104,12 +107,21 @@ genbind_node_add(struct genbind_node *node, struct genbind_node *list)
 char *genbind_strapp(char *a, char *b)
 {
         char *fullstr;
-        int fulllen;
-        fulllen = strlen(a) + strlen(b) + 1;
-        fullstr = malloc(fulllen);
-        snprintf(fullstr, fulllen, "%s%s", a, b);
-        free(a);
+        size_t alen;
+        size_t blen;
+
+        alen = strlen(a);
+        blen = strlen(b);
+
+        /* extend in place where possible rather than copying a */
+        fullstr = realloc(a, alen + blen + 1);
+        if (fullstr == NULL) {
+                free(b);
+                return a;
+        }
+        memcpy(fullstr + alen, b, blen + 1);
         free(b);
+
         return fullstr;
 }
 
@@ -145,6 +157,50 @@ genbind_new_number_node(enum genbind_node_type type,
         return nn;
 }
 
+/* exported interface defined in nsgenbind-ast.h */
+void genbind_node_free(struct genbind_node *node)
+{
+        struct genbind_node *next;
+
+        while (node != NULL) {
+                next = node->l;
+
+                free(genbind_node_gettext(node));
+                genbind_node_free(genbind_node_getnode(node));
+                free(node);
+
+                node = next;
+        }
+}
+
+/* exported interface defined in nsgenbind-ast.h */
+uint64_t genbind_node_hash(struct genbind_node *node, uint64_t hash)
+{
+        struct genbind_node *child;
+        char *text;
+        int *number;
+
+        hash = genb_hash(hash, &node->type, sizeof(node->type));
+
+        text = genbind_node_gettext(node);
+        number = genbind_node_getint(node);
+        if (text != NULL) {
+                hash = genb_hash(hash, text, strlen(text) + 1);
+        } else if (number != NULL) {
+                hash = genb_hash(hash, number, sizeof(int));
+        } else {
+                for (child = genbind_node_getnode(node);
+                     child != NULL;
+                     child = child->l) {
+                        hash = genbind_node_hash(child, hash);
+                }
+                /* mark the end of the children */
+                hash = genb_hash(hash, "", 1);
+        }
+
+        return hash;
+}
+
 
 /* exported interface defined in nsgenbind-ast.h */
 int
@@ -514,12 +570,16 @@ int genbind_dump_ast(struct genbind_node *node)
         return 0;
 }
 
+/**
+ * directory of the binding file being parsed, used to locate includes
+ */
+static char *prevfilepath = NULL;
+
 FILE *genbindopen(const char *filename)
 {
         FILE *genfile;
         char *fullname;
         int fulllen;
-        static char *prevfilepath = NULL;
 
         /* try filename raw */
         genfile = fopen(filename, "r");
@@ -584,8 +644,14 @@ FILE *genbindopen(const char *filename)
 int genbind_parsefile(char *infilename, struct genbind_node **ast)
 {
         FILE *infile;
+        char *inmap;
+        size_t inmapsize;
         int ret;
 
+        /* includes are relative to this binding not any previous one */
+        free(prevfilepath);
+        prevfilepath = NULL;
+
         /* open input file */
         infile = genbindopen(infilename);
         if (!infile) {
@@ -604,12 +670,31 @@ int genbind_parsefile(char *infilename, struct genbind_node **ast)
                 genbind_parsetracef = NULL;
         }
 
-        /* set flex to read from file */
-        nsgenbind_restart(infile);
+        /* map the top level file if possible otherwise read from it */
+        inmap = genb_mapfile(infile, &inmapsize);
+        if (inmap != NULL) {
+                fclose(infile);
+                nsgenbind__scan_buffer(inmap, inmapsize);
+        } else {
+                nsgenbind_restart(infile);
+        }
 
         /* process binding */
         ret = nsgenbind_parse(infilename, ast);
 
+        /* release lexer buffers before the mapping they may refer to */
+        if (nsgenbind_lex_release() != 0) {
+                ret = 3;
+        }
+        nsgenbind_lex_destroy();
+        free(prevfilepath);
+        prevfilepath = NULL;
+        if (inmap != NULL) {
+                genb_unmapfile(inmap, inmapsize);
+        } else {
+                fclose(infile);
+        }
+
         /* close tracefile if open */
         if (genbind_parsetracef != NULL) {
                 fclose(genbind_parsetracef);
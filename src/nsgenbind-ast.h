@@ -9,6 +9,8 @@
 #ifndef nsgenbind_nsgenbind_ast_h
 #define nsgenbind_nsgenbind_ast_h
 
+#include <stdint.h>
+
 enum genbind_node_type {
         GENBIND_NODE_TYPE_ROOT = 0,
         GENBIND_NODE_TYPE_IDENT, /**< generic identifier string */
@@ -89,6 +91,26 @@ struct genbind_node *genbind_node_prepend(struct genbind_node *list, struct genb
 
 struct genbind_node *genbind_node_add(struct genbind_node *node, struct genbind_node *list);
 
+/**
+ * free a binding AST
+ *
+ * The node, the nodes which follow it and all their children are freed.
+ *
+ * \param node The node to free from (usually tree root) or NULL.
+ */
+void genbind_node_free(struct genbind_node *node);
+
+/**
+ * add a node and its children to a hash
+ *
+ * The nodes which follow the node are not included.
+ *
+ * \param node The node to hash.
+ * \param hash The hash to add to, GENB_HASH_INIT for a new hash.
+ * \return The updated hash.
+ */
+uint64_t genbind_node_hash(struct genbind_node *node, uint64_t hash);
+
 /**
  * Dump the binding AST to file
  *
@@ -13,20 +13,40 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "options.h"
-#include "nsgenbind-ast.h"
 #include "webidl-ast.h"
 #include "ir.h"
-#include "jsapi-libdom.h"
-#include "duk-libdom.h"
+#include "stats.h"
+#include "report.h"
+#include "watch.h"
+#include "libnsgenbind.h"
 
-struct options *options;
+/** long only option identifiers */
+enum longopt_e {
+        LONGOPT_STATS = 256,
+        LONGOPT_WATCH,
+        LONGOPT_PROFILE_USE,
+        LONGOPT_PRUNE,
+        LONGOPT_PRUNE_STUB,
+        LONGOPT_REPORT,
+        LONGOPT_INLINE_INIT,
+        LONGOPT_SPLIT_HEADERS,
+};
 
-enum bindingtype_e {
-    BINDINGTYPE_UNKNOWN,
-    BINDINGTYPE_JSAPI_LIBDOM,
-    BINDINGTYPE_DUK_LIBDOM,
+static const struct option longopts[] = {
+        { "stats", optional_argument, NULL, LONGOPT_STATS },
+        { "watch", no_argument, NULL, LONGOPT_WATCH },
+        { "profile-use", required_argument, NULL, LONGOPT_PROFILE_USE },
+        { "prune", required_argument, NULL, LONGOPT_PRUNE },
+        { "prune-stub", no_argument, NULL, LONGOPT_PRUNE_STUB },
+        { "report", optional_argument, NULL, LONGOPT_REPORT },
+        { "inline-init", no_argument, NULL, LONGOPT_INLINE_INIT },
+        { "split-headers", no_argument, NULL, LONGOPT_SPLIT_HEADERS },
+        { NULL, 0, NULL, 0 },
 };
 
 static struct options* process_cmdline(int argc, char **argv)
@@ -39,7 +59,8 @@ static struct options* process_cmdline(int argc, char **argv)
                 return NULL;
         }
 
-        while ((opt = getopt(argc, argv, "vngDW::I:")) != -1) {
+        while ((opt = getopt_long(argc, argv, "vngDW::I:p::j:",
+                                  longopts, NULL)) != -1) {
                 switch (opt) {
                 case 'I':
                         options->idlpath = strdup(optarg);
@@ -72,10 +93,12 @@ static struct options* process_cmdline(int argc, char **argv)
                                 options->warnings |= WARNING_DUPLICATED;
                         } else if (strcmp(optarg, "generated") == 0) {
                                 options->warnings |= WARNING_GENERATED;
+                        } else if (strcmp(optarg, "unused") == 0) {
+                                options->warnings |= WARNING_UNUSED;
                         } else {
                                 fprintf(stderr,
                                         "Unknown warning option \"%s\" valid options are: all, unimplemented,\n"
-                                        "                                                 duplicated, generated\n",
+                                        "                                                 duplicated, generated, unused\n",
                                         optarg);
                                 free(options);
                                 return NULL;
@@ -83,170 +106,929 @@ static struct options* process_cmdline(int argc, char **argv)
                         }
                         break;
 
+                case 'j':
+                        options->jobs = atoi(optarg);
+                        if (options->jobs < 1) {
+                                fprintf(stderr,
+                                        "Error: jobs must be at least one\n");
+                                free(options);
+                                return NULL;
+                        }
+                        break;
+
+                case 'p':
+                        options->profile = true;
+                        if (optarg == NULL) {
+                                /* call counts only */
+                        } else if (strcmp(optarg, "time") == 0) {
+                                options->profiletime = true;
+                        } else {
+                                fprintf(stderr,
+                                        "Unknown profile option \"%s\" valid options are: time\n",
+                                        optarg);
+                                free(options);
+                                return NULL;
+                        }
+                        break;
+
+                case LONGOPT_STATS:
+                        options->stats = true;
+                        if (optarg != NULL) {
+                                options->statsfilename = strdup(optarg);
+                        }
+                        break;
+
+                case LONGOPT_WATCH:
+                        options->watch = true;
+                        break;
+
+                case LONGOPT_PROFILE_USE:
+                        options->profileuse = strdup(optarg);
+                        break;
+
+                case LONGOPT_PRUNE:
+                        options->prunefilename = strdup(optarg);
+                        break;
+
+                case LONGOPT_PRUNE_STUB:
+                        options->prunestub = true;
+                        break;
+
+                case LONGOPT_REPORT:
+                        options->report = true;
+                        if (optarg != NULL) {
+                                options->reportfilename = strdup(optarg);
+                        }
+                        break;
+
+                case LONGOPT_INLINE_INIT:
+                        options->inlineinit = true;
+                        break;
+
+                case LONGOPT_SPLIT_HEADERS:
+                        options->splitheaders = true;
+                        break;
+
                 default: /* '?' */
                         fprintf(stderr,
-                             "Usage: %s [-v] [-g] [-D] [-W] [-I idlpath] inputfile outputdir\n",
+                             "Usage: %s [-v] [-g] [-D] [-W] [-I idlpath] [-p[time]] [-j jobs] [--stats[=file]] [--watch] [--profile-use=file] [--prune=file [--prune-stub]] [--report[=file]] [--inline-init] [--split-headers] inputfile outputdir [inputfile outputdir...]\n",
                                 argv[0]);
                         free(options);
                         return NULL;
                 }
         }
 
-        if (optind > (argc - 2)) {
+        if ((optind > (argc - 2)) || (((argc - optind) % 2) != 0)) {
                 fprintf(stderr,
                        "Error: expected input filename and output directory\n");
                 free(options);
                 return NULL;
         }
 
-        options->infilename = strdup(argv[optind]);
+        /* remaining arguments are pairs of binding and output directory */
+        options->bindingc = (argc - optind) / 2;
+        options->infilenamev = calloc(options->bindingc, sizeof(char *));
+        options->outdirnamev = calloc(options->bindingc, sizeof(char *));
+        if ((options->infilenamev == NULL) ||
+            (options->outdirnamev == NULL)) {
+                fprintf(stderr, "Allocation error\n");
+                free(options);
+                return NULL;
+        }
+
+        for (opt = 0; opt < options->bindingc; opt++) {
+                options->infilenamev[opt] = strdup(argv[optind++]);
+                options->outdirnamev[opt] = strdup(argv[optind++]);
+        }
 
-        options->outdirname = strdup(argv[optind + 1]);
+        options->infilename = options->infilenamev[0];
+
+        options->outdirname = options->outdirnamev[0];
+
+        if (options->prunestub && (options->prunefilename == NULL)) {
+                fprintf(stderr,
+                        "Error: --prune-stub requires a pruning manifest\n");
+                free(options);
+                return NULL;
+        }
+
+        /* statistics and reports are gathered in a single process */
+        if (options->stats || options->report) {
+                options->jobs = 1;
+        }
 
         return options;
 
 }
 
-static int webidl_file_cb(struct genbind_node *node, void *ctx)
+/**
+ * fingerprint of the input an entry was output from
+ */
+struct binding_output {
+        char *name; /**< name of the entry */
+        uint64_t fingerprint; /**< fingerprint of the entry when output */
+};
+
+/**
+ * a binding to be generated
+ */
+struct binding_job {
+        char *infilename; /**< binding source */
+        char *outdirname; /**< output directory */
+        struct nsgenbind_binding *binding; /**< parsed binding */
+        struct webidl_node *webidl_root; /**< IDL AST built when watching */
+        int outputc; /**< number of entries last generated when watching */
+        struct binding_output *outputv; /**< entries last generated */
+        int generatedc; /**< number of entries output by last generation */
+};
+
+/**
+ * check if two bindings use exactly the same IDL files
+ */
+static bool
+binding_same_idl(struct nsgenbind_binding *a, struct nsgenbind_binding *b)
+{
+        const char *afile;
+        const char *bfile;
+        int fidx = 0;
+
+        do {
+                afile = nsgenbind_binding_idlfile(a, fidx);
+                bfile = nsgenbind_binding_idlfile(b, fidx);
+                if ((afile == NULL) || (bfile == NULL)) {
+                        return afile == bfile;
+                }
+                fidx++;
+        } while (strcmp(afile, bfile) == 0);
+
+        return false;
+}
+
+/**
+ * free the fingerprints of the entries a binding last output
+ */
+static void binding_outputs_free(struct binding_job *binding)
+{
+        int idx;
+
+        for (idx = 0; idx < binding->outputc; idx++) {
+                free(binding->outputv[idx].name);
+        }
+        free(binding->outputv);
+        binding->outputc = 0;
+        binding->outputv = NULL;
+}
+
+/**
+ * mark entries whose fingerprint is unchanged since they were output
+ */
+static void binding_outputs_current(struct binding_job *binding, struct ir *ir)
+{
+        struct binding_output *output;
+        struct ir_entry *entry;
+        int idx;
+        int oidx;
+
+        binding->generatedc = 0;
+        for (idx = 0; idx < ir->entryc; idx++) {
+                entry = ir->entries + idx;
+
+                /* entries are usually in the same order as before */
+                output = NULL;
+                if ((idx < binding->outputc) &&
+                    (strcmp(binding->outputv[idx].name, entry->name) == 0)) {
+                        output = &binding->outputv[idx];
+                } else {
+                        for (oidx = 0; oidx < binding->outputc; oidx++) {
+                                if (strcmp(binding->outputv[oidx].name,
+                                           entry->name) == 0) {
+                                        output = &binding->outputv[oidx];
+                                        break;
+                                }
+                        }
+                }
+
+                if ((output != NULL) &&
+                    (output->fingerprint == entry->fingerprint)) {
+                        entry->current = true;
+                } else {
+                        binding->generatedc++;
+                }
+        }
+}
+
+/**
+ * record the fingerprints of the entries output
+ *
+ * If they cannot be recorded every entry is output next time.
+ */
+static void binding_outputs_record(struct binding_job *binding, struct ir *ir)
 {
-	struct webidl_node **webidl_ast = ctx;
-	char *filename;
+        int idx;
+
+        binding_outputs_free(binding);
 
-	filename = genbind_node_gettext(node);
+        binding->outputv = calloc(ir->entryc, sizeof(struct binding_output));
+        if (binding->outputv == NULL) {
+                return;
+        }
+
+        for (idx = 0; idx < ir->entryc; idx++) {
+                binding->outputv[idx].name = strdup(ir->entries[idx].name);
+                if (binding->outputv[idx].name == NULL) {
+                        binding_outputs_free(binding);
+                        return;
+                }
+                binding->outputv[idx].fingerprint = ir->entries[idx].fingerprint;
+                binding->outputc++;
+        }
+}
+
+/**
+ * generate the output for a binding
+ *
+ * When watching, entries generated from the same input as when they
+ * were last output are not output again.
+ */
+static int binding_generate(struct binding_job *job)
+{
+        int res;
+        struct ir *ir = NULL;
 
         if (options->verbose) {
-                printf("Opening IDL file \"%s\"\n", filename);
+                printf("Generating %s into %s\n",
+                       job->infilename, job->outdirname);
+        }
+
+        res = nsgenbind_ir_new(job->binding, &ir);
+        if (res != 0) {
+                return res;
+        }
+
+        if (options->watch) {
+                ir_fingerprint(ir);
+                binding_outputs_current(job, ir);
+        }
+
+        res = nsgenbind_output(job->binding, ir, NULL, NULL);
+
+        if (options->watch) {
+                if (res == 0) {
+                        binding_outputs_record(job, ir);
+                } else {
+                        binding_outputs_free(job);
+                }
+        }
+
+        nsgenbind_ir_free(job->binding, ir);
+
+        return res;
+}
+
+/**
+ * generate the output for all bindings
+ *
+ * When more than one job is permitted each binding is generated in a
+ * child process. The children inherit the parsed ASTs so nothing is
+ * parsed again.
+ *
+ * \return 0 on success or the result of the first binding to fail.
+ */
+static int generate_bindings(struct binding_job *bindingv, int bindingc)
+{
+        int idx;
+        int res = 0;
+        int running = 0;
+        int status;
+        pid_t pid;
+
+        if ((options->jobs <= 1) || (bindingc == 1)) {
+                for (idx = 0; idx < bindingc; idx++) {
+                        res = binding_generate(&bindingv[idx]);
+                        if (res != 0) {
+                                break;
+                        }
+                }
+                return res;
+        }
+
+        /* avoid children repeating buffered output */
+        fflush(stdout);
+        fflush(stderr);
+
+        for (idx = 0; idx < bindingc; idx++) {
+                if (running == options->jobs) {
+                        if ((wait(&status) > 0) && (res == 0)) {
+                                res = WIFEXITED(status) ? WEXITSTATUS(status) : 7;
+                        }
+                        running--;
+                }
+
+                pid = fork();
+                if (pid == 0) {
+                        exit(binding_generate(&bindingv[idx]));
+                }
+                if (pid < 0) {
+                        fprintf(stderr, "Error: unable to start job: %s\n",
+                                strerror(errno));
+                        if (res == 0) {
+                                res = 7;
+                        }
+                        break;
+                }
+                running++;
+        }
+
+        while (running > 0) {
+                if ((wait(&status) > 0) && (res == 0)) {
+                        res = WIFEXITED(status) ? WEXITSTATUS(status) : 7;
+                }
+                running--;
+        }
+
+        return res;
+}
+
+/**
+ * monotonic time in milliseconds
+ */
+static double watch_time(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (ts.tv_sec * 1000.0) + (ts.tv_nsec / 1000000.0);
+}
+
+/**
+ * an IDL file parsed on its own
+ */
+struct watch_idl {
+        char *filename; /**< name of the file as given in bindings */
+        struct webidl_node *definitions; /**< AST of the file alone */
+};
+
+/**
+ * bindings being regenerated as their input changes
+ *
+ * Binding files are watched with their binding index as identifier,
+ * the call frequency profile and pruning manifest with the identifiers
+ * following them and IDL files with their index in the IDL table offset
+ * by idlbase.
+ */
+struct watcher {
+        struct watch *watch;
+        struct nsgenbind_ctx *ctx; /**< context bindings are parsed in */
+        int bindingc; /**< number of bindings */
+        int profileid; /**< identifier of the call frequency profile */
+        int pruneid; /**< identifier of the pruning manifest */
+        int idlbase; /**< identifier of the first IDL table entry */
+        struct binding_job *bindingv; /**< bindings */
+        int idlc; /**< number of entries in IDL table */
+        struct watch_idl *idlv; /**< IDL table, unused entries have no name */
+        bool *changedv; /**< changed flags indexed by watch identifier */
+        bool *rebuildv; /**< bindings whose IDL AST must be rebuilt */
+        bool *generatev; /**< bindings to regenerate */
+};
+
+/**
+ * find an IDL file in the table
+ *
+ * \return index of the file or -1 if it is not present
+ */
+static int watch_idl_find(struct watcher *w, const char *filename)
+{
+        int idx;
+
+        for (idx = 0; idx < w->idlc; idx++) {
+                if ((w->idlv[idx].filename != NULL) &&
+                    (strcmp(w->idlv[idx].filename, filename) == 0)) {
+                        return idx;
+                }
         }
+        return -1;
+}
 
-	return webidl_parsefile(filename, webidl_ast);
+/**
+ * parse an IDL file in the table on its own
+ *
+ * If the file fails to parse any previous AST is kept.
+ */
+static int watch_idl_parse(struct watcher *w, int idx)
+{
+        struct webidl_node *definitions = NULL;
+
+        if (webidl_parsefile(w->idlv[idx].filename, &definitions) != 0) {
+                webidl_node_free(definitions);
+                return -1;
+        }
+
+        webidl_node_free(w->idlv[idx].definitions);
+        w->idlv[idx].definitions = definitions;
+
+        return 0;
 }
 
-static int genbind_load_idl(struct genbind_node *genbind,
-                            struct webidl_node **webidl_out)
+/**
+ * add an IDL file to the table and watch it
+ *
+ * The file is added even if it fails to parse so it is parsed again
+ * when it is corrected.
+ */
+static int watch_idl_add(struct watcher *w, const char *filename)
 {
+        struct watch_idl *idlv;
+        bool *changedv;
+        char *fullname;
+        int fulllen;
+        int idx;
         int res;
-        struct genbind_node *binding_node;
-
-        binding_node = genbind_node_find_type(genbind, NULL,
-                                              GENBIND_NODE_TYPE_BINDING);
-
-	/* walk AST and load any web IDL files required */
-	res = genbind_node_foreach_type(
-                genbind_node_getnode(binding_node),
-                GENBIND_NODE_TYPE_WEBIDL,
-                webidl_file_cb,
-                webidl_out);
-	if (res != 0) {
-		fprintf(stderr, "Error: failed reading Web IDL\n");
-		return -1;
-	}
-
-        /* implements are implemented as mixins so intercalate them */
-        res = webidl_intercalate_implements(*webidl_out);
-	if (res != 0) {
-		fprintf(stderr, "Error: Failed to intercalate implements\n");
-		return -1;
-	}
+
+        idlv = realloc(w->idlv, (w->idlc + 1) * sizeof(struct watch_idl));
+        if (idlv == NULL) {
+                return -1;
+        }
+        w->idlv = idlv;
+
+        changedv = realloc(w->changedv,
+                           (w->idlbase + w->idlc + 1) * sizeof(bool));
+        if (changedv == NULL) {
+                return -1;
+        }
+        w->changedv = changedv;
+
+        idx = w->idlc;
+        idlv[idx].filename = strdup(filename);
+        idlv[idx].definitions = NULL;
+        if (idlv[idx].filename == NULL) {
+                return -1;
+        }
+        changedv[w->idlbase + idx] = false;
+        w->idlc++;
+
+        /* IDL files are located in the same way as idlopen() */
+        if (options->idlpath == NULL) {
+                res = watch_add(w->watch, filename, w->idlbase + idx);
+        } else {
+                fulllen = strlen(options->idlpath) + strlen(filename) + 2;
+                fullname = malloc(fulllen);
+                if (fullname == NULL) {
+                        return -1;
+                }
+                snprintf(fullname, fulllen, "%s/%s", options->idlpath, filename);
+                res = watch_add(w->watch, fullname, w->idlbase + idx);
+                free(fullname);
+        }
+        if (res != 0) {
+                return -1;
+        }
+
+        if (watch_idl_parse(w, idx) != 0) {
+                fprintf(stderr, "Error: unable to parse %s\n", filename);
+        }
+
+        return 0;
+}
+
+/**
+ * ensure the IDL files a binding uses are in the table
+ */
+static int
+watch_binding_idl(struct watcher *w, struct nsgenbind_binding *binding)
+{
+        const char *filename;
+        int fidx;
+
+        for (fidx = 0;
+             (filename = nsgenbind_binding_idlfile(binding, fidx)) != NULL;
+             fidx++) {
+                if ((watch_idl_find(w, filename) < 0) &&
+                    (watch_idl_add(w, filename) != 0)) {
+                        return -1;
+                }
+        }
+        return 0;
+}
+
+/**
+ * check if a binding uses an IDL file
+ */
+static bool
+binding_uses_idl(struct nsgenbind_binding *binding, const char *filename)
+{
+        const char *idlfile;
+        int fidx;
+
+        for (fidx = 0;
+             (idlfile = nsgenbind_binding_idlfile(binding, fidx)) != NULL;
+             fidx++) {
+                if (strcmp(idlfile, filename) == 0) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/**
+ * stop watching and free IDL files no binding uses
+ */
+static void watch_idl_prune(struct watcher *w)
+{
+        int idx;
+        int bidx;
+
+        for (idx = 0; idx < w->idlc; idx++) {
+                if (w->idlv[idx].filename == NULL) {
+                        continue;
+                }
+                for (bidx = 0; bidx < w->bindingc; bidx++) {
+                        if (binding_uses_idl(w->bindingv[bidx].binding,
+                                             w->idlv[idx].filename)) {
+                                break;
+                        }
+                }
+                if (bidx == w->bindingc) {
+                        watch_remove(w->watch, w->idlbase + idx);
+                        webidl_node_free(w->idlv[idx].definitions);
+                        free(w->idlv[idx].filename);
+                        w->idlv[idx].filename = NULL;
+                        w->idlv[idx].definitions = NULL;
+                }
+        }
+}
+
+/**
+ * free the IDL AST of a binding unless another binding shares it
+ */
+static void
+watch_release_idl(struct watcher *w, struct webidl_node *webidl_root)
+{
+        int idx;
+
+        for (idx = 0; idx < w->bindingc; idx++) {
+                if (w->bindingv[idx].webidl_root == webidl_root) {
+                        return;
+                }
+        }
+        webidl_node_free(webidl_root);
+}
+
+/**
+ * build the IDL AST of a binding from the separately parsed files
+ *
+ * The AST is shared with an earlier binding using the same IDL files
+ * whose AST has been rebuilt already.
+ */
+static int watch_rebuild_idl(struct watcher *w, int idx)
+{
+        struct binding_job *binding = &w->bindingv[idx];
+        struct webidl_node *webidl_root = NULL;
+        struct webidl_node *webidl_prev;
+        const char *filename;
+        int prev;
+        int fidx;
+        int iidx;
+
+        for (prev = 0; prev < idx; prev++) {
+                if (w->rebuildv[prev] &&
+                    (w->bindingv[prev].webidl_root != NULL) &&
+                    binding_same_idl(w->bindingv[prev].binding,
+                                     binding->binding)) {
+                        webidl_root = w->bindingv[prev].webidl_root;
+                        break;
+                }
+        }
+
+        if (webidl_root == NULL) {
+                for (fidx = 0;
+                     (filename = nsgenbind_binding_idlfile(binding->binding,
+                                                           fidx)) != NULL;
+                     fidx++) {
+                        iidx = watch_idl_find(w, filename);
+                        if ((iidx < 0) ||
+                            (w->idlv[iidx].definitions == NULL) ||
+                            (webidl_node_merge(&webidl_root,
+                                               w->idlv[iidx].definitions) != 0)) {
+                                webidl_node_free(webidl_root);
+                                return -1;
+                        }
+                }
+
+                /* implements are implemented as mixins so intercalate them */
+                if (webidl_intercalate_implements(webidl_root) != 0) {
+                        webidl_node_free(webidl_root);
+                        return -1;
+                }
+        }
+
+        webidl_prev = binding->webidl_root;
+        binding->webidl_root = webidl_root;
+        nsgenbind_binding_set_idl(binding->binding, webidl_root);
+        watch_release_idl(w, webidl_prev);
 
         return 0;
 }
 
 /**
- * get the type of binding
+ * parse a changed binding file
+ *
+ * The binding keeps its IDL AST until it is rebuilt. If the file fails
+ * to parse the previous binding is kept.
  */
-static enum bindingtype_e genbind_get_type(struct genbind_node *node)
+static int watch_binding_parse(struct watcher *w, int idx)
 {
-        struct genbind_node *binding_node;
-        const char *binding_type;
+        struct nsgenbind_binding *update;
+        struct binding_job *job = &w->bindingv[idx];
 
-        binding_node = genbind_node_find_type(node,
-                                              NULL,
-                                              GENBIND_NODE_TYPE_BINDING);
-        if (binding_node == NULL) {
-            /* binding entry is missing which is invalid */
-            return BINDINGTYPE_UNKNOWN;
+        if (nsgenbind_binding_new(w->ctx,
+                                  job->infilename,
+                                  job->outdirname,
+                                  &update) != 0) {
+                return -1;
+        }
+        if (watch_binding_idl(w, update) != 0) {
+                nsgenbind_binding_free(update);
+                return -1;
         }
 
-        binding_type = genbind_node_gettext(
-                genbind_node_find_type(
-                        genbind_node_getnode(binding_node),
-                        NULL,
-                        GENBIND_NODE_TYPE_NAME));
-        if (binding_type == NULL) {
-                fprintf(stderr, "Error: missing binding type\n");
-                return BINDINGTYPE_UNKNOWN;
+        if (!binding_same_idl(update, job->binding)) {
+                w->rebuildv[idx] = true;
         }
+        nsgenbind_binding_set_idl(update, job->webidl_root);
+
+        nsgenbind_binding_free(job->binding);
+        job->binding = update;
 
-        if (strcmp(binding_type, "jsapi_libdom") == 0) {
-                return BINDINGTYPE_JSAPI_LIBDOM;
+        return 0;
+}
+
+/**
+ * free a watcher and the ASTs of its bindings
+ */
+static void watcher_free(struct watcher *w)
+{
+        struct webidl_node *webidl_root;
+        int idx;
+
+        for (idx = 0; idx < w->bindingc; idx++) {
+                nsgenbind_binding_free(w->bindingv[idx].binding);
+                w->bindingv[idx].binding = NULL;
+
+                webidl_root = w->bindingv[idx].webidl_root;
+                w->bindingv[idx].webidl_root = NULL;
+                watch_release_idl(w, webidl_root);
+
+                binding_outputs_free(&w->bindingv[idx]);
         }
 
-        if (strcmp(binding_type, "duk_libdom") == 0) {
-                return BINDINGTYPE_DUK_LIBDOM;
+        for (idx = 0; idx < w->idlc; idx++) {
+                webidl_node_free(w->idlv[idx].definitions);
+                free(w->idlv[idx].filename);
         }
+        free(w->idlv);
+        free(w->changedv);
+        free(w->rebuildv);
+        free(w->generatev);
+        if (w->watch != NULL) {
+                watch_free(w->watch);
+        }
+}
 
-        fprintf(stderr, "Error: unsupported binding type \"%s\"\n", binding_type);
+/**
+ * regenerate bindings as their input files change
+ *
+ * Each IDL file is parsed on its own and the IDL of a binding is built
+ * from copies of the files it uses, so a change only parses the changed
+ * file again. The intermediate representation of an affected binding is
+ * built again and only entries generated from changed input are output.
+ * Output files are only replaced when their content changes.
+ *
+ * If a changed file fails to parse the previous AST is kept.
+ */
+static int
+watch_bindings(struct nsgenbind_ctx *ctx,
+               struct binding_job *bindingv,
+               int bindingc)
+{
+        struct watcher w;
+        bool watching = false;
+        double start;
+        int idx;
+        int res;
+
+        memset(&w, 0, sizeof(w));
+        w.ctx = ctx;
+        w.bindingc = bindingc;
+        w.bindingv = bindingv;
+        w.profileid = bindingc;
+        w.pruneid = bindingc + 1;
+        w.idlbase = bindingc + 2;
+
+        if (watch_new(&w.watch) != 0) {
+                w.watch = NULL;
+                goto watch_err;
+        }
+
+        w.changedv = calloc(w.idlbase, sizeof(bool));
+        w.rebuildv = calloc(bindingc, sizeof(bool));
+        w.generatev = calloc(bindingc, sizeof(bool));
+        if ((w.changedv == NULL) ||
+            (w.rebuildv == NULL) ||
+            (w.generatev == NULL)) {
+                goto watch_err;
+        }
+
+        /* load and watch the initial input */
+        for (idx = 0; idx < bindingc; idx++) {
+                if ((watch_add(w.watch, bindingv[idx].infilename, idx) != 0) ||
+                    (watch_binding_idl(&w, bindingv[idx].binding) != 0)) {
+                        goto watch_err;
+                }
+                w.rebuildv[idx] = true;
+                w.generatev[idx] = true;
+        }
+
+        /* the profile is read with each intermediate representation */
+        if ((options->profileuse != NULL) &&
+            (watch_add(w.watch, options->profileuse, w.profileid) != 0)) {
+                goto watch_err;
+        }
+
+        /* the manifest is applied to each intermediate representation */
+        if ((options->prunefilename != NULL) &&
+            (watch_add(w.watch, options->prunefilename, w.pruneid) != 0)) {
+                goto watch_err;
+        }
+
+        start = watch_time();
+
+        do {
+                /* parse changed binding files */
+                for (idx = 0; idx < bindingc; idx++) {
+                        if (!w.changedv[idx]) {
+                                continue;
+                        }
+                        if (watch_binding_parse(&w, idx) != 0) {
+                                fprintf(stderr, "Error: keeping previous %s\n",
+                                        bindingv[idx].infilename);
+                                continue;
+                        }
+                        w.generatev[idx] = true;
+                }
 
-        return BINDINGTYPE_UNKNOWN;
+                /* parse changed IDL files on their own */
+                for (idx = 0; idx < w.idlc; idx++) {
+                        int bidx;
+
+                        if ((!w.changedv[w.idlbase + idx]) ||
+                            (w.idlv[idx].filename == NULL)) {
+                                continue;
+                        }
+                        if (watch_idl_parse(&w, idx) != 0) {
+                                fprintf(stderr, "Error: keeping previous %s\n",
+                                        w.idlv[idx].filename);
+                                continue;
+                        }
+                        for (bidx = 0; bidx < bindingc; bidx++) {
+                                if (binding_uses_idl(bindingv[bidx].binding,
+                                                     w.idlv[idx].filename)) {
+                                        w.rebuildv[bidx] = true;
+                                }
+                        }
+                }
+
+                /* rebuild the IDL of affected bindings */
+                for (idx = 0; idx < bindingc; idx++) {
+                        if (!w.rebuildv[idx]) {
+                                continue;
+                        }
+                        if (watch_rebuild_idl(&w, idx) != 0) {
+                                fprintf(stderr,
+                                        "Error: unable to build IDL for %s\n",
+                                        bindingv[idx].infilename);
+                                w.rebuildv[idx] = false;
+                                w.generatev[idx] = false;
+                                continue;
+                        }
+                        w.generatev[idx] = true;
+                }
+
+                watch_idl_prune(&w);
+
+                /* a changed profile or manifest may affect any binding */
+                if (w.changedv[w.profileid] || w.changedv[w.pruneid]) {
+                        for (idx = 0; idx < bindingc; idx++) {
+                                w.generatev[idx] = true;
+                        }
+                }
+
+                /* regenerate affected bindings */
+                for (idx = 0; idx < bindingc; idx++) {
+                        if ((!w.generatev[idx]) ||
+                            (bindingv[idx].webidl_root == NULL)) {
+                                continue;
+                        }
+                        res = binding_generate(&bindingv[idx]);
+                        if (res == 0) {
+                                printf("Regenerated %d of %d entries of %s in %.1fms\n",
+                                       bindingv[idx].generatedc,
+                                       bindingv[idx].outputc,
+                                       bindingv[idx].infilename,
+                                       watch_time() - start);
+                        } else {
+                                fprintf(stderr,
+                                        "Error: regenerating %s failed with code %d\n",
+                                        bindingv[idx].infilename,
+                                        res);
+                        }
+                }
+                fflush(stdout);
+
+                memset(w.changedv, 0, (w.idlbase + w.idlc) * sizeof(bool));
+                memset(w.rebuildv, 0, bindingc * sizeof(bool));
+                memset(w.generatev, 0, bindingc * sizeof(bool));
+
+                if (!watching) {
+                        printf("Watching for changes\n");
+                        fflush(stdout);
+                        watching = true;
+                }
+
+                if (watch_wait(w.watch, w.changedv) < 0) {
+                        break;
+                }
+                start = watch_time();
+        } while (true);
+
+watch_err:
+        watcher_free(&w);
+
+        return 9;
 }
 
 int main(int argc, char **argv)
 {
         int res;
-        struct genbind_node *genbind_root = NULL;
-        struct webidl_node *webidl_root = NULL;
-        struct ir *ir = NULL;
-        enum bindingtype_e bindingtype;
+        int idx;
+        struct nsgenbind_ctx *ctx;
+        struct binding_job *bindingv;
 
         options = process_cmdline(argc, argv);
         if (options == NULL) {
                 return 1; /* bad commandline */
         }
 
-        /* parse binding */
-        res = genbind_parsefile(options->infilename, &genbind_root);
-        if (res != 0) {
-                fprintf(stderr, "Error: parse failed with code %d\n", res);
-                return res;
+        bindingv = calloc(options->bindingc, sizeof(struct binding_job));
+        if ((bindingv == NULL) || (nsgenbind_ctx_new(options, &ctx) != 0)) {
+                fprintf(stderr, "Allocation error\n");
+                return 1;
         }
 
-        /* dump the binding AST */
-        genbind_dump_ast(genbind_root);
+        for (idx = 0; idx < options->bindingc; idx++) {
+                bindingv[idx].infilename = options->infilenamev[idx];
+                bindingv[idx].outdirname = options->outdirnamev[idx];
 
-        /* get type of binding */
-        bindingtype = genbind_get_type(genbind_root);
-        if (bindingtype == BINDINGTYPE_UNKNOWN) {
-                return 3;
+                res = nsgenbind_binding_new(ctx,
+                                            bindingv[idx].infilename,
+                                            bindingv[idx].outdirname,
+                                            &bindingv[idx].binding);
+                if (res != 0) {
+                        return res;
+                }
         }
 
-        /* load the IDL files specified in the binding */
-        res = genbind_load_idl(genbind_root, &webidl_root);
-        if (res != 0) {
-                return 4;
+        if (options->watch) {
+                /* IDL is loaded a file at a time so a change to one is
+                 * parsed alone
+                 */
+                res = watch_bindings(ctx, bindingv, options->bindingc);
+                free(bindingv);
+                nsgenbind_ctx_free(ctx);
+                return res;
         }
 
-	/* debug dump of web idl AST */
-        webidl_dump_ast(webidl_root);
-
-        /* generate intermediate representation */
-        res = ir_new(genbind_root, webidl_root, &ir);
-        if (res != 0) {
-                return 5;
+        for (idx = 0; idx < options->bindingc; idx++) {
+                res = nsgenbind_binding_load_idl(bindingv[idx].binding);
+                if (res != 0) {
+                        return res;
+                }
         }
 
-        /* dump the intermediate representation */
-        ir_dump(ir);
-        ir_dumpdot(ir);
+        res = generate_bindings(bindingv, options->bindingc);
 
-        /* generate binding */
-        switch (bindingtype) {
-        case BINDINGTYPE_DUK_LIBDOM:
-                res = duk_libdom_output(ir);
-                break;
+        for (idx = 0; idx < options->bindingc; idx++) {
+                nsgenbind_binding_free(bindingv[idx].binding);
+        }
+        free(bindingv);
+        nsgenbind_ctx_free(ctx);
+
+        if ((res == 0) && (stats_report() != 0)) {
+                res = 8;
+        }
 
-        default:
-                fprintf(stderr, "Unable to generate binding of this type\n");
-                res = 7;
+        if ((res == 0) && (report_write() != 0)) {
+                res = 8;
         }
 
         return res;
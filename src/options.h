@@ -9,16 +9,47 @@
 #ifndef nsgenbind_options_h
 #define nsgenbind_options_h
 
+/**
+ * receive a generated file in place of the output directory
+ *
+ * \param fname The leaf name of the file.
+ * \param data The content of the file which is nul terminated.
+ * \param size The size of the content.
+ * \param pw The context given with the callback.
+ * \return 0 on success.
+ */
+typedef int (nsgenbind_output_cb)(const char *fname, const char *data, size_t size, void *pw);
+
 /** global options */
 struct options {
 	char *infilename; /**< binding source */
 	char *outdirname; /**< output directory */
 	char *idlpath; /**< path to IDL files */
+	char *statsfilename; /**< file to write JSON statistics to */
+	char *profileuse; /**< call frequency profile placing functions */
+	char *prunefilename; /**< manifest of interfaces and members kept */
+	char *reportfilename; /**< file to write the code size report to */
+	char **infilenamev; /**< binding sources to generate */
+	char **outdirnamev; /**< output directory for each binding */
+	int bindingc; /**< number of bindings to generate */
+	int jobs; /**< number of bindings generated at once */
+	nsgenbind_output_cb *output; /**< receives generated files in place
+				      * of the output directory
+				      */
+	void *outputpw; /**< context for the output callback */
 
 	bool verbose; /**< verbose processing */
 	bool debug; /**< debug enabled */
 	bool dbglog; /**< embed debug logging in output */
         bool dryrun; /**< output is not generated */
+        bool stats; /**< report generator performance statistics */
+        bool watch; /**< regenerate output when inputs change */
+        bool profile; /**< embed call counters in output */
+        bool profiletime; /**< embed call timing in output */
+        bool prunestub; /**< pruned members throw rather than being absent */
+        bool report; /**< report generated code size and cost */
+        bool inlineinit; /**< inline initialisor and finaliser chains */
+        bool splitheaders; /**< output a header for each class */
 
 	unsigned int warnings; /**< warning flags */
 };
@@ -30,9 +61,10 @@ enum opt_warnings {
 	WARNING_DUPLICATED = 2,
 	WARNING_WEBIDL = 4,
 	WARNING_GENERATED = 8,
+	WARNING_UNUSED = 16,
 };
 
-#define WARNING_ALL (WARNING_UNIMPLEMENTED | WARNING_DUPLICATED | WARNING_WEBIDL)
+#define WARNING_ALL (WARNING_UNIMPLEMENTED | WARNING_DUPLICATED | WARNING_WEBIDL | WARNING_UNUSED)
 
 #define WARN(flags, msg, args...) do {			\
 		if ((options->warnings & flags) != 0) {			\
@@ -0,0 +1,389 @@
+/* generated code size and cost report
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+
+#include "options.h"
+#include "report.h"
+
+/** start of the prototype function in a generated class file */
+#define PROTO_START "___proto(duk_context *ctx, void *udata)\n{"
+
+/**
+ * size and cost of the output for an ir entry
+ */
+struct report_record {
+        char *binding; /**< binding the entry was generated for */
+        char *name; /**< name of the entry */
+        const char *type; /**< type of the entry */
+        char *filename; /**< file generated for the entry */
+        unsigned long bytes; /**< bytes of output */
+        unsigned long lines; /**< lines of output */
+        int proto_calls; /**< duktape API calls in the prototype function */
+        int memberc[3]; /**< member functions of each kind */
+        int implc[3]; /**< member functions from each source */
+        int depth; /**< inheritance depth */
+        int privatec; /**< members of the private structure */
+};
+
+static int recordc;
+static struct report_record *recordv;
+
+/* exported interface documented in report.h */
+void
+report_entry(const char *name,
+             const char *type,
+             const char *filename,
+             int depth,
+             int privatec)
+{
+        struct report_record *newv;
+        struct report_record *record;
+
+        if (!options->report) {
+                return;
+        }
+
+        newv = realloc(recordv, (recordc + 1) * sizeof(struct report_record));
+        if (newv == NULL) {
+                return;
+        }
+        recordv = newv;
+
+        record = recordv + recordc++;
+        memset(record, 0, sizeof(struct report_record));
+        record->binding = strdup(options->infilename);
+        record->name = strdup(name);
+        record->type = type;
+        if (filename != NULL) {
+                record->filename = strdup(filename);
+        }
+        record->depth = depth;
+        record->privatec = privatec;
+}
+
+/* exported interface documented in report.h */
+void report_member(enum report_member member, enum report_impl impl)
+{
+        if ((!options->report) || (recordc == 0)) {
+                return;
+        }
+        recordv[recordc - 1].memberc[member]++;
+        recordv[recordc - 1].implc[impl]++;
+}
+
+/**
+ * count the duktape API calls in the prototype function
+ */
+static int count_proto_calls(const char *text)
+{
+        const char *start;
+        const char *end;
+        const char *cur;
+        int count = 0;
+
+        start = strstr(text, PROTO_START);
+        if (start == NULL) {
+                return 0;
+        }
+        end = strstr(start, "\n}\n");
+        if (end == NULL) {
+                end = start + strlen(start);
+        }
+
+        for (cur = start + 1; cur < end; cur++) {
+                if ((strncmp(cur, "duk_", 4) != 0) ||
+                    isalnum((unsigned char)cur[-1]) ||
+                    (cur[-1] == '_')) {
+                        continue;
+                }
+                cur += 4;
+                while (isalnum((unsigned char)*cur) || (*cur == '_')) {
+                        cur++;
+                }
+                if (*cur == '(') {
+                        count++;
+                }
+        }
+
+        return count;
+}
+
+/* exported interface documented in report.h */
+void report_output(const char *fname, FILE *filef)
+{
+        struct report_record *record;
+        char *text;
+        long size;
+        long idx;
+
+        if ((!options->report) || (recordc == 0)) {
+                return;
+        }
+        record = recordv + recordc - 1;
+        if ((record->filename == NULL) ||
+            (strcmp(record->filename, fname) != 0)) {
+                return;
+        }
+
+        size = ftell(filef);
+        if (size <= 0) {
+                return;
+        }
+        text = malloc(size + 1);
+        if (text == NULL) {
+                return;
+        }
+        rewind(filef);
+        size = fread(text, 1, size, filef);
+        text[size] = 0;
+
+        record->bytes = size;
+        for (idx = 0; idx < size; idx++) {
+                if (text[idx] == '\n') {
+                        record->lines++;
+                }
+        }
+        record->proto_calls = count_proto_calls(text);
+
+        free(text);
+}
+
+static int compare_bytes(const void *a, const void *b)
+{
+        const struct report_record *ra = a;
+        const struct report_record *rb = b;
+
+        if (ra->bytes != rb->bytes) {
+                return (ra->bytes > rb->bytes) ? -1 : 1;
+        }
+        return strcmp(ra->name, rb->name);
+}
+
+static void report_text(FILE *outf)
+{
+        struct report_record total;
+        struct report_record *record;
+        int idx;
+
+        memset(&total, 0, sizeof(total));
+
+        fprintf(outf, "%-32s %10s %7s %6s %7s %7s %7s %7s %9s %6s %5s %7s\n",
+                "Entry", "bytes", "lines", "proto", "methods", "getters",
+                "setters", "binding", "generated", "unimpl", "depth",
+                "private");
+        for (idx = 0; idx < recordc; idx++) {
+                record = recordv + idx;
+                fprintf(outf,
+                        "%-32s %10lu %7lu %6d %7d %7d %7d %7d %9d %6d %5d %7d\n",
+                        record->name,
+                        record->bytes,
+                        record->lines,
+                        record->proto_calls,
+                        record->memberc[REPORT_MEMBER_METHOD],
+                        record->memberc[REPORT_MEMBER_GETTER],
+                        record->memberc[REPORT_MEMBER_SETTER],
+                        record->implc[REPORT_IMPL_HANDWRITTEN],
+                        record->implc[REPORT_IMPL_GENERATED],
+                        record->implc[REPORT_IMPL_UNIMPLEMENTED],
+                        record->depth,
+                        record->privatec);
+
+                total.bytes += record->bytes;
+                total.lines += record->lines;
+                total.proto_calls += record->proto_calls;
+                total.memberc[REPORT_MEMBER_METHOD] += record->memberc[REPORT_MEMBER_METHOD];
+                total.memberc[REPORT_MEMBER_GETTER] += record->memberc[REPORT_MEMBER_GETTER];
+                total.memberc[REPORT_MEMBER_SETTER] += record->memberc[REPORT_MEMBER_SETTER];
+                total.implc[REPORT_IMPL_HANDWRITTEN] += record->implc[REPORT_IMPL_HANDWRITTEN];
+                total.implc[REPORT_IMPL_GENERATED] += record->implc[REPORT_IMPL_GENERATED];
+                total.implc[REPORT_IMPL_UNIMPLEMENTED] += record->implc[REPORT_IMPL_UNIMPLEMENTED];
+        }
+        fprintf(outf,
+                "%-32s %10lu %7lu %6d %7d %7d %7d %7d %9d %6d\n",
+                "total",
+                total.bytes,
+                total.lines,
+                total.proto_calls,
+                total.memberc[REPORT_MEMBER_METHOD],
+                total.memberc[REPORT_MEMBER_GETTER],
+                total.memberc[REPORT_MEMBER_SETTER],
+                total.implc[REPORT_IMPL_HANDWRITTEN],
+                total.implc[REPORT_IMPL_GENERATED],
+                total.implc[REPORT_IMPL_UNIMPLEMENTED]);
+}
+
+/**
+ * output a string with CSV quoting
+ */
+static void csv_string(FILE *outf, const char *str)
+{
+        fputc('"', outf);
+        for (; *str != 0; str++) {
+                if (*str == '"') {
+                        fputc('"', outf);
+                }
+                fputc(*str, outf);
+        }
+        fputc('"', outf);
+}
+
+static void report_csv(FILE *outf)
+{
+        struct report_record *record;
+        int idx;
+
+        fprintf(outf,
+                "binding,name,type,bytes,lines,proto_calls,methods,getters,"
+                "setters,handwritten,generated,unimplemented,depth,"
+                "private_members\n");
+        for (idx = 0; idx < recordc; idx++) {
+                record = recordv + idx;
+                csv_string(outf, record->binding);
+                fputc(',', outf);
+                csv_string(outf, record->name);
+                fprintf(outf,
+                        ",%s,%lu,%lu,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
+                        record->type,
+                        record->bytes,
+                        record->lines,
+                        record->proto_calls,
+                        record->memberc[REPORT_MEMBER_METHOD],
+                        record->memberc[REPORT_MEMBER_GETTER],
+                        record->memberc[REPORT_MEMBER_SETTER],
+                        record->implc[REPORT_IMPL_HANDWRITTEN],
+                        record->implc[REPORT_IMPL_GENERATED],
+                        record->implc[REPORT_IMPL_UNIMPLEMENTED],
+                        record->depth,
+                        record->privatec);
+        }
+}
+
+/**
+ * output a string with JSON escaping
+ */
+static void json_string(FILE *outf, const char *str)
+{
+        fputc('"', outf);
+        for (; *str != 0; str++) {
+                if ((*str == '"') || (*str == '\\')) {
+                        fputc('\\', outf);
+                        fputc(*str, outf);
+                } else if ((unsigned char)*str < 0x20) {
+                        fprintf(outf, "\\u%04x", *str);
+                } else {
+                        fputc(*str, outf);
+                }
+        }
+        fputc('"', outf);
+}
+
+static void report_json(FILE *outf)
+{
+        struct report_record *record;
+        int idx;
+
+        fprintf(outf, "{\n  \"entries\": [\n");
+        for (idx = 0; idx < recordc; idx++) {
+                record = recordv + idx;
+                fprintf(outf, "    { \"binding\": ");
+                json_string(outf, record->binding);
+                fprintf(outf, ", \"name\": ");
+                json_string(outf, record->name);
+                fprintf(outf,
+                        ", \"type\": \"%s\","
+                        " \"bytes\": %lu, \"lines\": %lu,"
+                        " \"proto_calls\": %d,"
+                        " \"methods\": %d, \"getters\": %d, \"setters\": %d,"
+                        " \"handwritten\": %d, \"generated\": %d,"
+                        " \"unimplemented\": %d,"
+                        " \"depth\": %d, \"private_members\": %d }%s\n",
+                        record->type,
+                        record->bytes,
+                        record->lines,
+                        record->proto_calls,
+                        record->memberc[REPORT_MEMBER_METHOD],
+                        record->memberc[REPORT_MEMBER_GETTER],
+                        record->memberc[REPORT_MEMBER_SETTER],
+                        record->implc[REPORT_IMPL_HANDWRITTEN],
+                        record->implc[REPORT_IMPL_GENERATED],
+                        record->implc[REPORT_IMPL_UNIMPLEMENTED],
+                        record->depth,
+                        record->privatec,
+                        (idx == (recordc - 1)) ? "" : ",");
+        }
+        fprintf(outf, "  ]\n}\n");
+}
+
+static int report_file(const char *filename)
+{
+        FILE *outf;
+        size_t namel;
+
+        if (strcmp(filename, "-") == 0) {
+                report_json(stdout);
+                return 0;
+        }
+
+        outf = fopen(filename, "w");
+        if (outf == NULL) {
+                fprintf(stderr,
+                        "Error: unable to open report file %s (%s)\n",
+                        filename, strerror(errno));
+                return -1;
+        }
+
+        namel = strlen(filename);
+        if ((namel > 4) && (strcmp(filename + namel - 4, ".csv") == 0)) {
+                report_csv(outf);
+        } else {
+                report_json(outf);
+        }
+
+        fclose(outf);
+
+        return 0;
+}
+
+/* exported interface documented in report.h */
+int report_write(void)
+{
+        int res = 0;
+        int idx;
+
+        if (!options->report) {
+                return 0;
+        }
+
+        qsort(recordv, recordc, sizeof(struct report_record), compare_bytes);
+
+        if ((options->reportfilename == NULL) ||
+            (strcmp(options->reportfilename, "-") != 0)) {
+                report_text(stdout);
+        }
+
+        if (options->reportfilename != NULL) {
+                res = report_file(options->reportfilename);
+        }
+
+        for (idx = 0; idx < recordc; idx++) {
+                free(recordv[idx].binding);
+                free(recordv[idx].name);
+                free(recordv[idx].filename);
+        }
+        free(recordv);
+        recordv = NULL;
+        recordc = 0;
+
+        return res;
+}
@@ -0,0 +1,77 @@
+/* generated code size and cost report
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#ifndef nsgenbind_report_h
+#define nsgenbind_report_h
+
+/**
+ * kind of generated member function
+ */
+enum report_member {
+        REPORT_MEMBER_METHOD, /**< operation or iteration method */
+        REPORT_MEMBER_GETTER, /**< attribute getter */
+        REPORT_MEMBER_SETTER, /**< attribute setter */
+};
+
+/**
+ * source of the implementation of a generated member function
+ */
+enum report_impl {
+        REPORT_IMPL_HANDWRITTEN, /**< code from the binding */
+        REPORT_IMPL_GENERATED, /**< code generated by the tool */
+        REPORT_IMPL_UNIMPLEMENTED, /**< default stub implementation */
+};
+
+/**
+ * start reporting on an ir entry
+ *
+ * Members and output are accounted to the entry until the next one is
+ * started. If reporting is not enabled this does nothing.
+ *
+ * \param name The name of the entry.
+ * \param type The type of the entry e.g. "interface".
+ * \param filename The name of the file generated for the entry.
+ * \param depth The number of interfaces the entry inherits from.
+ * \param privatec The number of members in the private structure
+ *                 including those inherited.
+ */
+void report_entry(const char *name, const char *type, const char *filename, int depth, int privatec);
+
+/**
+ * account for a generated member function of the current entry
+ *
+ * \param member The kind of member function.
+ * \param impl The source of the implementation.
+ */
+void report_member(enum report_member member, enum report_impl impl);
+
+/**
+ * account for a generated output file
+ *
+ * If the file belongs to the current entry its size, number of lines
+ * and the duktape API calls made by its prototype function are counted.
+ *
+ * \param fname The leaf name of the output file.
+ * \param filef The output file open for reading.
+ */
+void report_output(const char *fname, FILE *filef);
+
+/**
+ * output the report
+ *
+ * The entries are sorted by bytes of output. A table is written to
+ * standard output and if a report filename was given the report is
+ * also written to it as CSV if the name ends in .csv and as JSON
+ * otherwise. A filename of - writes JSON to standard output in place
+ * of the table.
+ *
+ * \return 0 on success or -1 if the report file could not be written.
+ */
+int report_write(void);
+
+#endif
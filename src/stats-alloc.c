@@ -0,0 +1,53 @@
+/* generator allocation counting
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ *
+ * Only the command line tool is linked with this so the library does
+ * not replace the allocator of programs embedding it.
+ */
+
+#include <stdlib.h>
+
+#include "stats.h"
+
+#if defined(__GLIBC__)
+/* The C library allows the allocator to be replaced by symbol
+ * interposition. The replacements here count allocations and pass
+ * them on to the C library's own implementation. This also catches
+ * allocations made within the C library (e.g. by strdup) and by the
+ * generated parsers.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+        stats_alloc_count++;
+        stats_alloc_bytes += size;
+        return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+        stats_alloc_count++;
+        stats_alloc_bytes += nmemb * size;
+        return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+        stats_alloc_count++;
+        stats_alloc_bytes += size;
+        return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+        __libc_free(ptr);
+}
+#endif
@@ -0,0 +1,340 @@
+/* generator performance statistics
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "options.h"
+#include "stats.h"
+
+/**
+ * resources used by a phase, IDL file or ir entry
+ */
+struct stats_record {
+        const char *name;
+        double wall; /**< elapsed wall clock time in seconds */
+        double cpu; /**< elapsed cpu time in seconds */
+        unsigned long allocc; /**< number of allocations */
+        unsigned long long allocb; /**< bytes allocated */
+        unsigned long long outputb; /**< bytes of generated output */
+        long maxrss; /**< peak resident set size in kilobytes at end */
+};
+
+/**
+ * table of records
+ */
+struct stats_table {
+        int recordc;
+        struct stats_record *recordv;
+};
+
+static const char *phase_names[STATS_PHASE_COUNT] = {
+        "binding",
+        "idl",
+        "intercalate",
+        "ir",
+        "dump",
+        "output",
+};
+
+static struct stats_record phases[STATS_PHASE_COUNT];
+static struct stats_table idlfiles;
+static struct stats_table entries;
+
+unsigned long stats_alloc_count = 0;
+unsigned long long stats_alloc_bytes = 0;
+static unsigned long long output_bytes = 0;
+
+static long get_maxrss(void)
+{
+        struct rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+                return 0;
+        }
+#if defined(__APPLE__)
+        /* reported in bytes instead of kilobytes */
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+}
+
+/* exported interface documented in stats.h */
+void stats_mark(struct stats_mark *mark)
+{
+        struct timespec ts;
+        struct rusage usage;
+
+        if (!options->stats) {
+                return;
+        }
+
+        mark->allocc = stats_alloc_count;
+        mark->allocb = stats_alloc_bytes;
+        mark->outputb = output_bytes;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        mark->wall = ts.tv_sec + (ts.tv_nsec / 1e9);
+
+        getrusage(RUSAGE_SELF, &usage);
+        mark->cpu = usage.ru_utime.tv_sec + (usage.ru_utime.tv_usec / 1e6) +
+                usage.ru_stime.tv_sec + (usage.ru_stime.tv_usec / 1e6);
+}
+
+/**
+ * add the resources used since a mark to a record
+ */
+static void
+record_since(struct stats_record *record, const struct stats_mark *start)
+{
+        struct stats_mark now;
+
+        stats_mark(&now);
+
+        record->wall += now.wall - start->wall;
+        record->cpu += now.cpu - start->cpu;
+        record->allocc += now.allocc - start->allocc;
+        record->allocb += now.allocb - start->allocb;
+        record->outputb += now.outputb - start->outputb;
+        record->maxrss = get_maxrss();
+}
+
+/**
+ * add a new record to a table
+ *
+ * The resource usage is computed before the table is extended so the
+ * tables own allocations are not attributed to the record.
+ */
+static void
+table_add(struct stats_table *table,
+          const char *name,
+          const struct stats_mark *start)
+{
+        struct stats_record record;
+        struct stats_record *recordv;
+
+        memset(&record, 0, sizeof(record));
+        record_since(&record, start);
+
+        recordv = realloc(table->recordv,
+                          (table->recordc + 1) * sizeof(struct stats_record));
+        if (recordv == NULL) {
+                return;
+        }
+        table->recordv = recordv;
+
+        record.name = strdup(name);
+        table->recordv[table->recordc] = record;
+        table->recordc++;
+}
+
+/* exported interface documented in stats.h */
+void stats_phase(enum stats_phase phase, const struct stats_mark *start)
+{
+        if (!options->stats) {
+                return;
+        }
+        record_since(&phases[phase], start);
+}
+
+/* exported interface documented in stats.h */
+void stats_idlfile(const char *filename, const struct stats_mark *start)
+{
+        if (!options->stats) {
+                return;
+        }
+        table_add(&idlfiles, filename, start);
+}
+
+/* exported interface documented in stats.h */
+void stats_entry(const char *name, const struct stats_mark *start)
+{
+        if (!options->stats) {
+                return;
+        }
+        table_add(&entries, name, start);
+}
+
+/* exported interface documented in stats.h */
+void stats_output(unsigned long long size)
+{
+        output_bytes += size;
+}
+
+static void
+report_text_record(FILE *outf, const struct stats_record *record)
+{
+        fprintf(outf, "  %-32s %10.3f %10.3f %10lu %12llu %12llu %10ld\n",
+                record->name,
+                record->wall * 1000,
+                record->cpu * 1000,
+                record->allocc,
+                record->allocb,
+                record->outputb,
+                record->maxrss);
+}
+
+static void
+report_text_table(FILE *outf, const char *title, struct stats_table *table)
+{
+        int idx;
+
+        fprintf(outf, "\n%-34s %10s %10s %10s %12s %12s %10s\n",
+                title, "wall(ms)", "cpu(ms)", "allocs",
+                "alloc bytes", "output", "rss(KiB)");
+        for (idx = 0; idx < table->recordc; idx++) {
+                report_text_record(outf, table->recordv + idx);
+        }
+}
+
+static void report_text(FILE *outf)
+{
+        struct stats_table phase_table;
+        struct stats_record total;
+        int idx;
+
+        memset(&total, 0, sizeof(total));
+        for (idx = 0; idx < STATS_PHASE_COUNT; idx++) {
+                total.wall += phases[idx].wall;
+                total.cpu += phases[idx].cpu;
+                total.allocc += phases[idx].allocc;
+                total.allocb += phases[idx].allocb;
+                total.outputb += phases[idx].outputb;
+        }
+        total.name = "total";
+        total.maxrss = get_maxrss();
+
+        phase_table.recordc = STATS_PHASE_COUNT;
+        phase_table.recordv = phases;
+
+        report_text_table(outf, "Phase", &phase_table);
+        report_text_record(outf, &total);
+        report_text_table(outf, "IDL file", &idlfiles);
+        report_text_table(outf, "Entry", &entries);
+}
+
+/**
+ * output a string with JSON escaping
+ */
+static void json_string(FILE *outf, const char *str)
+{
+        fputc('"', outf);
+        for (; *str != 0; str++) {
+                if ((*str == '"') || (*str == '\\')) {
+                        fputc('\\', outf);
+                        fputc(*str, outf);
+                } else if ((unsigned char)*str < 0x20) {
+                        fprintf(outf, "\\u%04x", *str);
+                } else {
+                        fputc(*str, outf);
+                }
+        }
+        fputc('"', outf);
+}
+
+static void
+report_json_record(FILE *outf, const struct stats_record *record, bool last)
+{
+        fprintf(outf, "    { \"name\": ");
+        json_string(outf, record->name);
+        fprintf(outf,
+                ", \"wall_ms\": %.3f, \"cpu_ms\": %.3f,"
+                " \"allocs\": %lu, \"alloc_bytes\": %llu,"
+                " \"output_bytes\": %llu, \"maxrss_kib\": %ld }%s\n",
+                record->wall * 1000,
+                record->cpu * 1000,
+                record->allocc,
+                record->allocb,
+                record->outputb,
+                record->maxrss,
+                last ? "" : ",");
+}
+
+static void
+report_json_table(FILE *outf,
+                  const char *name,
+                  const struct stats_record *recordv,
+                  int recordc,
+                  bool last)
+{
+        int idx;
+
+        fprintf(outf, "  \"%s\": [\n", name);
+        for (idx = 0; idx < recordc; idx++) {
+                report_json_record(outf, recordv + idx, idx == (recordc - 1));
+        }
+        fprintf(outf, "  ]%s\n", last ? "" : ",");
+}
+
+static int report_json(const char *filename)
+{
+        FILE *outf;
+
+        if (strcmp(filename, "-") == 0) {
+                outf = stdout;
+        } else {
+                outf = fopen(filename, "w");
+                if (outf == NULL) {
+                        fprintf(stderr,
+                                "Error: unable to open statistics file %s (%s)\n",
+                                filename, strerror(errno));
+                        return -1;
+                }
+        }
+
+        fprintf(outf, "{\n");
+        fprintf(outf, "  \"binding\": ");
+        json_string(outf, options->infilename);
+        fprintf(outf, ",\n");
+        fprintf(outf, "  \"maxrss_kib\": %ld,\n", get_maxrss());
+        report_json_table(outf, "phases", phases, STATS_PHASE_COUNT, false);
+        report_json_table(outf, "idlfiles",
+                          idlfiles.recordv, idlfiles.recordc, false);
+        report_json_table(outf, "entries",
+                          entries.recordv, entries.recordc, true);
+        fprintf(outf, "}\n");
+
+        if (outf != stdout) {
+                fclose(outf);
+        }
+
+        return 0;
+}
+
+/* exported interface documented in stats.h */
+int stats_report(void)
+{
+        int idx;
+
+        if (!options->stats) {
+                return 0;
+        }
+
+        for (idx = 0; idx < STATS_PHASE_COUNT; idx++) {
+                phases[idx].name = phase_names[idx];
+        }
+
+        if (options->statsfilename == NULL) {
+                report_text(stdout);
+                return 0;
+        }
+
+        /* JSON on standard output replaces the textual report */
+        if (strcmp(options->statsfilename, "-") != 0) {
+                report_text(stdout);
+        }
+
+        return report_json(options->statsfilename);
+}
@@ -0,0 +1,96 @@
+/* generator performance statistics
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#ifndef nsgenbind_stats_h
+#define nsgenbind_stats_h
+
+/**
+ * phases of binding generation which are measured
+ */
+enum stats_phase {
+        STATS_PHASE_BINDING, /**< binding file parse */
+        STATS_PHASE_IDL, /**< Web IDL file parsing */
+        STATS_PHASE_INTERCALATE, /**< implements intercalation */
+        STATS_PHASE_IR, /**< intermediate representation construction */
+        STATS_PHASE_DUMP, /**< debug dumps of AST and IR */
+        STATS_PHASE_OUTPUT, /**< binding output generation */
+        STATS_PHASE_COUNT, /**< number of phases */
+};
+
+/**
+ * snapshot of the resource counters at a point in time
+ */
+struct stats_mark {
+        double wall; /**< monotonic wall clock time in seconds */
+        double cpu; /**< user and system cpu time in seconds */
+        unsigned long allocc; /**< number of allocations made */
+        unsigned long long allocb; /**< number of bytes allocated */
+        unsigned long long outputb; /**< number of bytes output */
+};
+
+/**
+ * allocations counted by the allocator replacement
+ *
+ * These remain zero unless stats-alloc.c is linked.
+ */
+extern unsigned long stats_alloc_count;
+extern unsigned long long stats_alloc_bytes;
+
+/**
+ * take a snapshot of the resource counters
+ *
+ * If statistics are not enabled this does nothing.
+ *
+ * \param mark The mark to fill in.
+ */
+void stats_mark(struct stats_mark *mark);
+
+/**
+ * record the resources used by a phase since a mark
+ *
+ * Phases may be recorded several times and are accumulated.
+ *
+ * \param phase The phase to record.
+ * \param start The mark taken at the start of the phase.
+ */
+void stats_phase(enum stats_phase phase, const struct stats_mark *start);
+
+/**
+ * record the resources used to parse an IDL file since a mark
+ *
+ * \param filename The name of the IDL file.
+ * \param start The mark taken before the file was parsed.
+ */
+void stats_idlfile(const char *filename, const struct stats_mark *start);
+
+/**
+ * record the resources used to generate an ir entry since a mark
+ *
+ * \param name The name of the entry.
+ * \param start The mark taken before generation of the entry.
+ */
+void stats_entry(const char *name, const struct stats_mark *start);
+
+/**
+ * account for bytes written to a generated output file
+ *
+ * \param size The number of bytes written.
+ */
+void stats_output(unsigned long long size);
+
+/**
+ * output the collected statistics
+ *
+ * A textual report is written to standard output and if a statistics
+ * filename was given the statistics are written to it as JSON.
+ *
+ * \return 0 on success or -1 if the JSON file could not be written.
+ */
+int stats_report(void);
+
+#endif
@@ -13,9 +13,15 @@
 #include <stdlib.h>
 #include <sys/types.h>
 #include <unistd.h>
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
 
 #include "options.h"
 #include "utils.h"
+#include "stats.h"
+#include "report.h"
 
 /* exported function documented in utils.h */
 char *genb_fpath(const char *fname)
@@ -73,7 +79,14 @@ FILE *genb_fopen_tmp(const char *fname)
         FILE *filef;
 
         if (options->dryrun) {
+                if (options->report) {
+                        /* output is measured but not kept */
+                        return tmpfile();
+                }
                 fpath = strdup("/dev/null");
+        } else if (options->output != NULL) {
+                /* output is passed to the callback when closed */
+                return tmpfile();
         } else {
                 fpath = genb_fpath_tmp(fname);
         }
@@ -90,6 +103,38 @@ FILE *genb_fopen_tmp(const char *fname)
         return filef;
 }
 
+/**
+ * pass the content of a generated file to the output callback
+ */
+static int genb_output(FILE *filef, const char *fname)
+{
+        char *data;
+        long size;
+        int res;
+
+        size = ftell(filef);
+        if (size < 0) {
+                fclose(filef);
+                return -1;
+        }
+
+        data = malloc(size + 1);
+        if (data == NULL) {
+                fclose(filef);
+                return -1;
+        }
+
+        rewind(filef);
+        size = fread(data, 1, size, filef);
+        data[size] = 0;
+        fclose(filef);
+
+        res = options->output(fname, data, size, options->outputpw);
+        free(data);
+
+        return res;
+}
+
 int genb_fclose_tmp(FILE *filef_tmp, const char *fname)
 {
         char *fpath;
@@ -99,12 +144,24 @@ int genb_fclose_tmp(FILE *filef_tmp, const char *fname)
         char fbuf[1024];
         size_t trd;
         size_t frd;
+        long outlen;
+
+        outlen = ftell(filef_tmp);
+        if (outlen > 0) {
+                stats_output(outlen);
+        }
+
+        report_output(fname, filef_tmp);
 
         if (options->dryrun) {
                 fclose(filef_tmp);
                 return 0;
         }
 
+        if (options->output != NULL) {
+                return genb_output(filef_tmp, fname);
+        }
+
         fpath = genb_fpath(fname);
         tpath = genb_fpath_tmp(fname);
 
@@ -150,6 +207,74 @@ close_done:
         return 0;
 }
 
+/* exported function documented in utils.h */
+char *genb_mapfile(FILE *filef, size_t *size)
+{
+#ifndef _WIN32
+        struct stat st;
+        size_t mapsize;
+        char *map;
+
+        if ((fstat(fileno(filef), &st) != 0) ||
+            (!S_ISREG(st.st_mode)) ||
+            (st.st_size == 0)) {
+                return NULL;
+        }
+
+        mapsize = st.st_size + 2;
+
+        /* reserve anonymous zeroed pages for the file and the nul bytes */
+        map = mmap(NULL, mapsize, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED) {
+                return NULL;
+        }
+
+        /* place the file over the start of the reservation, the remainder
+         * of its last page is zero filled
+         */
+        if (mmap(map, st.st_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_FIXED, fileno(filef), 0) == MAP_FAILED) {
+                munmap(map, mapsize);
+                return NULL;
+        }
+
+        *size = mapsize;
+
+        return map;
+#else
+        UNUSED(filef);
+        UNUSED(size);
+
+        return NULL;
+#endif
+}
+
+/* exported function documented in utils.h */
+int genb_unmapfile(char *map, size_t size)
+{
+#ifndef _WIN32
+        return munmap(map, size);
+#else
+        UNUSED(map);
+        UNUSED(size);
+
+        return 0;
+#endif
+}
+
+/* exported function documented in utils.h */
+uint64_t genb_hash(uint64_t hash, const void *data, size_t len)
+{
+        const unsigned char *byte = data;
+
+        while (len-- > 0) {
+                hash ^= *byte++;
+                hash *= 1099511628211ULL;
+        }
+
+        return hash;
+}
 
 #ifdef NEED_STRNDUP
 
@@ -9,6 +9,8 @@
 #ifndef nsgenbind_utils_h
 #define nsgenbind_utils_h
 
+#include <stdint.h>
+
 /**
  * get a pathname with the output prefix prepended
  *
@@ -32,10 +34,50 @@ FILE *genb_fopen(const char *fname, const char *mode);
 FILE *genb_fopen_tmp(const char *fname);
 
 /**
- * Close file opened with genb_fopen
+ * Close file opened with genb_fopen_tmp
+ *
+ * The target file is only replaced if the output differs from it. If
+ * an output callback is set the output is passed to it instead.
  */
 int genb_fclose_tmp(FILE *filef, const char *fname);
 
+/**
+ * Map an open file into memory for the lexer to read.
+ *
+ * The contents are mapped privately and followed by two nul bytes so
+ * the mapping is suitable for a flex scan_buffer call. Flex may write
+ * to the mapping while scanning but the file is never altered. Only
+ * the top level file is mapped, tokens are still copied out of it.
+ *
+ * \param filef The file to map.
+ * \param size Updated with the size of the mapping including the two
+ *             trailing nul bytes.
+ * \return The mapping or NULL if the file cannot be mapped in which
+ *         case the caller should read from the file instead.
+ */
+char *genb_mapfile(FILE *filef, size_t *size);
+
+/**
+ * Release a mapping made with genb_mapfile
+ */
+int genb_unmapfile(char *map, size_t size);
+
+/** initial value for genb_hash() */
+#define GENB_HASH_INIT 14695981039346656037ULL
+
+/**
+ * Add data to a hash.
+ *
+ * A 64 bit FNV-1a hash used to detect changes to input so it is not
+ * suitable where collisions could be provoked.
+ *
+ * \param hash The hash to add to, GENB_HASH_INIT for a new hash.
+ * \param data The data to add.
+ * \param len The length of the data.
+ * \return The updated hash.
+ */
+uint64_t genb_hash(uint64_t hash, const void *data, size_t len);
+
 #if defined(__APPLE__) || defined(_WIN32)
 #define NEED_STRNDUP 1
 char *strndup(const char *s, size_t n);
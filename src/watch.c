@@ -0,0 +1,285 @@
+/* input file change notification implementation
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#include "utils.h"
+#include "watch.h"
+
+/** time in milliseconds files must be quiet before changes are reported */
+#define WATCH_SETTLE_MS 50
+
+/** a watched file */
+struct watch_file {
+        int wd; /**< watch descriptor of the containing directory */
+        char *name; /**< leafname of the file */
+        int id; /**< identifier reported on change */
+};
+
+struct watch {
+        int fd; /**< notification file descriptor */
+        int filec; /**< number of watched files */
+        struct watch_file *filev; /**< watched files */
+};
+
+#ifdef __linux__
+
+/* exported interface documented in watch.h */
+int watch_new(struct watch **watch_out)
+{
+        struct watch *watch;
+
+        watch = calloc(1, sizeof(struct watch));
+        if (watch == NULL) {
+                return -1;
+        }
+
+        watch->fd = inotify_init();
+        if (watch->fd < 0) {
+                fprintf(stderr, "Error: unable to watch files: %s\n",
+                        strerror(errno));
+                free(watch);
+                return -1;
+        }
+
+        *watch_out = watch;
+
+        return 0;
+}
+
+/* exported interface documented in watch.h */
+int watch_add(struct watch *watch, const char *filename, int id)
+{
+        struct watch_file *filev;
+        const char *leaf;
+        char *dirname;
+        int wd;
+
+        leaf = strrchr(filename, '/');
+        if (leaf == NULL) {
+                dirname = strdup(".");
+                leaf = filename;
+        } else {
+                dirname = strndup(filename, leaf - filename);
+                leaf++;
+        }
+        if (dirname == NULL) {
+                return -1;
+        }
+
+        /* adding a directory already watched returns its descriptor */
+        wd = inotify_add_watch(watch->fd,
+                               (*dirname == 0) ? "/" : dirname,
+                               IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (wd < 0) {
+                fprintf(stderr, "Error: unable to watch %s: %s\n",
+                        filename, strerror(errno));
+                free(dirname);
+                return -1;
+        }
+        free(dirname);
+
+        filev = realloc(watch->filev,
+                        (watch->filec + 1) * sizeof(struct watch_file));
+        if (filev == NULL) {
+                return -1;
+        }
+        watch->filev = filev;
+
+        filev[watch->filec].wd = wd;
+        filev[watch->filec].name = strdup(leaf);
+        filev[watch->filec].id = id;
+        watch->filec++;
+
+        return 0;
+}
+
+/**
+ * check if any watched file is in a watched directory
+ */
+static bool watch_wd_used(struct watch *watch, int wd)
+{
+        int fidx;
+
+        for (fidx = 0; fidx < watch->filec; fidx++) {
+                if (watch->filev[fidx].wd == wd) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/* exported interface documented in watch.h */
+int watch_remove(struct watch *watch, int id)
+{
+        struct watch_file removed;
+        int fidx = 0;
+
+        while (fidx < watch->filec) {
+                if (watch->filev[fidx].id != id) {
+                        fidx++;
+                        continue;
+                }
+
+                removed = watch->filev[fidx];
+                watch->filec--;
+                memmove(&watch->filev[fidx],
+                        &watch->filev[fidx + 1],
+                        (watch->filec - fidx) * sizeof(struct watch_file));
+                free(removed.name);
+
+                /* stop watching directories with no watched files */
+                if (!watch_wd_used(watch, removed.wd)) {
+                        inotify_rm_watch(watch->fd, removed.wd);
+                }
+        }
+
+        return 0;
+}
+
+/**
+ * read pending events marking any watched files they refer to
+ */
+static int watch_read(struct watch *watch, bool *changedv)
+{
+        char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+        const struct inotify_event *event;
+        ssize_t len;
+        char *ptr;
+        int fidx;
+        int changedc = 0;
+
+        len = read(watch->fd, buf, sizeof(buf));
+        if (len <= 0) {
+                return -1;
+        }
+
+        for (ptr = buf; ptr < buf + len;
+             ptr += sizeof(struct inotify_event) + event->len) {
+                event = (const struct inotify_event *)ptr;
+                if (event->len == 0) {
+                        continue;
+                }
+                for (fidx = 0; fidx < watch->filec; fidx++) {
+                        if ((watch->filev[fidx].wd == event->wd) &&
+                            (strcmp(watch->filev[fidx].name,
+                                    event->name) == 0)) {
+                                changedv[watch->filev[fidx].id] = true;
+                                changedc++;
+                        }
+                }
+        }
+
+        return changedc;
+}
+
+/* exported interface documented in watch.h */
+int watch_wait(struct watch *watch, bool *changedv)
+{
+        struct pollfd pfd;
+        int changedc = 0;
+        int res;
+
+        pfd.fd = watch->fd;
+        pfd.events = POLLIN;
+
+        /* wait for a change to a watched file */
+        while (changedc == 0) {
+                res = watch_read(watch, changedv);
+                if (res < 0) {
+                        return -1;
+                }
+                changedc += res;
+        }
+
+        /* gather further changes until things settle */
+        while (poll(&pfd, 1, WATCH_SETTLE_MS) > 0) {
+                res = watch_read(watch, changedv);
+                if (res < 0) {
+                        return -1;
+                }
+                changedc += res;
+        }
+
+        return changedc;
+}
+
+/* exported interface documented in watch.h */
+int watch_free(struct watch *watch)
+{
+        int fidx;
+
+        close(watch->fd);
+        for (fidx = 0; fidx < watch->filec; fidx++) {
+                free(watch->filev[fidx].name);
+        }
+        free(watch->filev);
+        free(watch);
+
+        return 0;
+}
+
+#else
+
+/* exported interface documented in watch.h */
+int watch_new(struct watch **watch_out)
+{
+        UNUSED(watch_out);
+
+        fprintf(stderr, "Error: watching files is not supported on this platform\n");
+
+        return -1;
+}
+
+/* exported interface documented in watch.h */
+int watch_add(struct watch *watch, const char *filename, int id)
+{
+        UNUSED(watch);
+        UNUSED(filename);
+        UNUSED(id);
+
+        return -1;
+}
+
+/* exported interface documented in watch.h */
+int watch_remove(struct watch *watch, int id)
+{
+        UNUSED(watch);
+        UNUSED(id);
+
+        return -1;
+}
+
+/* exported interface documented in watch.h */
+int watch_wait(struct watch *watch, bool *changedv)
+{
+        UNUSED(watch);
+        UNUSED(changedv);
+
+        return -1;
+}
+
+/* exported interface documented in watch.h */
+int watch_free(struct watch *watch)
+{
+        UNUSED(watch);
+
+        return 0;
+}
+
+#endif
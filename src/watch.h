@@ -0,0 +1,67 @@
+/* input file change notification
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ */
+
+#ifndef nsgenbind_watch_h
+#define nsgenbind_watch_h
+
+#include <stdbool.h>
+
+struct watch;
+
+/**
+ * create a watch on a set of files
+ *
+ * \param watch_out updated with the new watch
+ * \return 0 on success or -1 if watching files is not possible.
+ */
+int watch_new(struct watch **watch_out);
+
+/**
+ * add a file to a watch
+ *
+ * The directory containing the file is watched so the file may be
+ * replaced, as many editors do when saving, as well as rewritten.
+ * Several files may share an identifier and a file may be added more
+ * than once with different identifiers.
+ *
+ * \param watch The watch to add the file to.
+ * \param filename The file to watch.
+ * \param id Identifier reported when the file changes.
+ * \return 0 on success.
+ */
+int watch_add(struct watch *watch, const char *filename, int id);
+
+/**
+ * remove the files added to a watch with an identifier
+ *
+ * \param watch The watch to remove the files from.
+ * \param id Identifier the files were added with.
+ * \return 0 on success.
+ */
+int watch_remove(struct watch *watch, int id);
+
+/**
+ * wait for watched files to change
+ *
+ * Blocks until at least one watched file changes and then collects
+ * further changes until the files have been quiet for a short time
+ * so a save touching several files is reported once.
+ *
+ * \param watch The watch to wait upon.
+ * \param changedv Array indexed by identifier, entries for changed
+ *                 files are set to true.
+ * \return The number of changed files or -1 on error.
+ */
+int watch_wait(struct watch *watch, bool *changedv);
+
+/**
+ * free a watch and stop watching its files
+ */
+int watch_free(struct watch *watch);
+
+#endif
@@ -25,7 +25,11 @@ static FILE *webidl_parsetracef;
 extern int webidl_debug;
 extern int webidl__flex_debug;
 extern void webidl_restart(FILE*);
-extern int webidl_parse(struct webidl_node **webidl_ast);
+extern struct yy_buffer_state *webidl__scan_buffer(char *base, size_t size);
+extern int webidl_lex_destroy(void);
+extern int webidl_lex_release(void);
+extern int webidl_parse(struct webidl_node **webidl_ast,
+                        struct webidl_definitions *definitions);
 
 struct webidl_node {
 	enum webidl_node_type type; /* the type of the node */
@@ -98,6 +102,7 @@ webidl_node_add(struct webidl_node *node, struct webidl_node *list)
 	case WEBIDL_NODE_TYPE_ROOT:
 	case WEBIDL_NODE_TYPE_INTERFACE:
 	case WEBIDL_NODE_TYPE_DICTIONARY:
+	case WEBIDL_NODE_TYPE_ENUM:
 	case WEBIDL_NODE_TYPE_LIST:
 	case WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE:
 	case WEBIDL_NODE_TYPE_ATTRIBUTE:
@@ -106,6 +111,10 @@ webidl_node_add(struct webidl_node *node, struct webidl_node *list)
 	case WEBIDL_NODE_TYPE_ARGUMENT:
 	case WEBIDL_NODE_TYPE_TYPE:
 	case WEBIDL_NODE_TYPE_CONST:
+	case WEBIDL_NODE_TYPE_ITERABLE:
+	case WEBIDL_NODE_TYPE_MAPLIKE:
+	case WEBIDL_NODE_TYPE_SETLIKE:
+	case WEBIDL_NODE_TYPE_CALLBACK:
 		break;
 
 	default:
@@ -147,6 +156,497 @@ webidl_new_number_node(enum webidl_node_type type,
 	return nn;
 }
 
+/**
+ * set of the allocations of an AST being freed
+ *
+ * Interfaces share the member lists of the interfaces they implement so
+ * nodes may be reached more than once and are gathered here before
+ * being freed. Open addressed with linear probing, size is a power of
+ * two.
+ */
+struct webidl_free_set {
+        unsigned int size;
+        unsigned int used;
+        void **entries;
+};
+
+static unsigned int webidl_free_set_slot(struct webidl_free_set *set, void *ptr)
+{
+        unsigned int slot;
+
+        slot = ((unsigned int)((size_t)ptr >> 4) * 2654435761U) & (set->size - 1);
+        while ((set->entries[slot] != NULL) && (set->entries[slot] != ptr)) {
+                slot = (slot + 1) & (set->size - 1);
+        }
+        return slot;
+}
+
+/**
+ * add an allocation to the set
+ *
+ * \return 1 if the allocation was added, 0 if it was already present
+ *         or -1 on allocation failure.
+ */
+static int webidl_free_set_add(struct webidl_free_set *set, void *ptr)
+{
+        void **entries;
+        unsigned int size;
+        unsigned int idx;
+        unsigned int slot;
+
+        if (((set->used + 1) * 2) > set->size) {
+                entries = set->entries;
+                size = set->size;
+
+                set->size = (size == 0) ? 32 : size * 2;
+                set->entries = calloc(set->size, sizeof(void *));
+                if (set->entries == NULL) {
+                        set->entries = entries;
+                        set->size = size;
+                        return -1;
+                }
+                for (idx = 0; idx < size; idx++) {
+                        if (entries[idx] != NULL) {
+                                slot = webidl_free_set_slot(set, entries[idx]);
+                                set->entries[slot] = entries[idx];
+                        }
+                }
+                free(entries);
+        }
+
+        slot = webidl_free_set_slot(set, ptr);
+        if (set->entries[slot] != NULL) {
+                return 0;
+        }
+        set->entries[slot] = ptr;
+        set->used++;
+
+        return 1;
+}
+
+/**
+ * gather the nodes of a list, the lists they hold and their values
+ */
+static int webidl_free_gather(struct webidl_free_set *set, struct webidl_node *node)
+{
+        void *value;
+        int res;
+
+        while (node != NULL) {
+                res = webidl_free_set_add(set, node);
+                if (res <= 0) {
+                        /* the rest of the list has already been gathered */
+                        return res;
+                }
+
+                value = webidl_node_gettext(node);
+                if (value == NULL) {
+                        value = webidl_node_getfloat(node);
+                }
+                if ((value != NULL) &&
+                    (webidl_free_set_add(set, value) < 0)) {
+                        return -1;
+                }
+
+                if (webidl_free_gather(set, webidl_node_getnode(node)) < 0) {
+                        return -1;
+                }
+
+                node = node->l;
+        }
+
+        return 0;
+}
+
+/* exported interface defined in webidl-ast.h */
+int webidl_node_free(struct webidl_node *node)
+{
+        struct webidl_free_set set = { 0, 0, NULL };
+        unsigned int idx;
+
+        if (webidl_free_gather(&set, node) < 0) {
+                /* unable to free without risking freeing twice */
+                free(set.entries);
+                return -1;
+        }
+
+        for (idx = 0; idx < set.size; idx++) {
+                free(set.entries[idx]);
+        }
+        free(set.entries);
+
+        return 0;
+}
+
+/* exported interface defined in webidl-ast.h */
+int webidl_node_free_moved(struct webidl_node *node, struct webidl_node *moved)
+{
+        struct webidl_node *child;
+
+        child = webidl_node_getnode(node);
+        if (child == moved) {
+                node->r.node = NULL;
+        } else {
+                while ((child != NULL) && (child->l != moved)) {
+                        child = child->l;
+                }
+                if (child == NULL) {
+                        /* not a child so freeing could take it too */
+                        return -1;
+                }
+                child->l = NULL;
+        }
+
+        return webidl_node_free(node);
+}
+
+/**
+ * copy a node and its children
+ *
+ * The nodes which follow the node are not copied.
+ *
+ * \param node The node to copy.
+ * \return The copy or NULL on allocation failure.
+ */
+static struct webidl_node *webidl_node_copy(struct webidl_node *node)
+{
+        struct webidl_node *copy;
+        struct webidl_node *child;
+        struct webidl_node **tail;
+
+        copy = calloc(1, sizeof(struct webidl_node));
+        if (copy == NULL) {
+                return NULL;
+        }
+        copy->type = node->type;
+        copy->r = node->r;
+
+        if (webidl_node_gettext(node) != NULL) {
+                copy->r.text = strdup(node->r.text);
+                if (copy->r.text == NULL) {
+                        free(copy);
+                        return NULL;
+                }
+        } else if (webidl_node_getfloat(node) != NULL) {
+                copy->r.flt = malloc(sizeof(float));
+                if (copy->r.flt == NULL) {
+                        free(copy);
+                        return NULL;
+                }
+                *copy->r.flt = *node->r.flt;
+        } else if (webidl_node_getnode(node) != NULL) {
+                /* copy the children keeping their order */
+                copy->r.node = NULL;
+                tail = &copy->r.node;
+                for (child = node->r.node; child != NULL; child = child->l) {
+                        *tail = webidl_node_copy(child);
+                        if (*tail == NULL) {
+                                webidl_node_free(copy);
+                                return NULL;
+                        }
+                        tail = &(*tail)->l;
+                }
+        }
+
+        return copy;
+}
+
+/** an interface or dictionary in a definition index */
+struct webidl_definition_entry {
+        enum webidl_node_type type; /**< type of definition */
+        const char *ident; /**< identifier of definition */
+        struct webidl_node *node; /**< definition node */
+};
+
+/**
+ * index of the interface and dictionary definitions of an AST
+ *
+ * open addressed with linear probing, size is a power of two
+ */
+struct webidl_definitions {
+        unsigned int size; /**< number of entries */
+        unsigned int used; /**< number of entries in use */
+        struct webidl_definition_entry *entries;
+};
+
+static struct webidl_definition_entry *
+webidl_definitions_slot(struct webidl_definitions *definitions,
+                        enum webidl_node_type type,
+                        const char *ident)
+{
+        struct webidl_definition_entry *entry;
+        unsigned int slot;
+
+        slot = genb_hash(GENB_HASH_INIT, ident, strlen(ident)) &
+                (definitions->size - 1);
+        for (;;) {
+                entry = &definitions->entries[slot];
+                if ((entry->ident == NULL) ||
+                    ((entry->type == type) &&
+                     (strcmp(entry->ident, ident) == 0))) {
+                        return entry;
+                }
+                slot = (slot + 1) & (definitions->size - 1);
+        }
+}
+
+static int webidl_definitions_grow(struct webidl_definitions *definitions)
+{
+        struct webidl_definition_entry *entries;
+        struct webidl_definition_entry *entry;
+        unsigned int size;
+        unsigned int idx;
+
+        entries = definitions->entries;
+        size = definitions->size;
+
+        definitions->size = (size == 0) ? 64 : size * 2;
+        definitions->entries = calloc(definitions->size,
+                                      sizeof(struct webidl_definition_entry));
+        if (definitions->entries == NULL) {
+                definitions->entries = entries;
+                definitions->size = size;
+                return -1;
+        }
+
+        for (idx = 0; idx < size; idx++) {
+                if (entries[idx].ident != NULL) {
+                        entry = webidl_definitions_slot(definitions,
+                                                        entries[idx].type,
+                                                        entries[idx].ident);
+                        *entry = entries[idx];
+                }
+        }
+        free(entries);
+
+        return 0;
+}
+
+/**
+ * get the identifier of a definition which may be extended
+ */
+static const char *webidl_definition_ident(struct webidl_node *node)
+{
+        if ((node->type != WEBIDL_NODE_TYPE_INTERFACE) &&
+            (node->type != WEBIDL_NODE_TYPE_DICTIONARY)) {
+                return NULL;
+        }
+        return webidl_node_gettext(
+                webidl_node_find_type(webidl_node_getnode(node),
+                                      NULL,
+                                      WEBIDL_NODE_TYPE_IDENT));
+}
+
+/* exported interface defined in webidl-ast.h */
+int
+webidl_node_add_definition(struct webidl_definitions *definitions,
+                           struct webidl_node *node)
+{
+        struct webidl_definition_entry *entry;
+        const char *ident;
+
+        if (node == NULL) {
+                return 0;
+        }
+
+        ident = webidl_definition_ident(node);
+        if (ident == NULL) {
+                return 0;
+        }
+
+        if (((definitions->used + 1) * 2) > definitions->size) {
+                if (webidl_definitions_grow(definitions) != 0) {
+                        return -1;
+                }
+        }
+
+        entry = webidl_definitions_slot(definitions, node->type, ident);
+        if (entry->ident == NULL) {
+                entry->type = node->type;
+                entry->ident = ident;
+                entry->node = node;
+                definitions->used++;
+        }
+
+        return 0;
+}
+
+/* exported interface defined in webidl-ast.h */
+struct webidl_node *
+webidl_node_find_definition(struct webidl_definitions *definitions,
+                            enum webidl_node_type type,
+                            const char *ident)
+{
+        if (definitions->size == 0) {
+                return NULL;
+        }
+        return webidl_definitions_slot(definitions, type, ident)->node;
+}
+
+/**
+ * index the definitions of an AST
+ *
+ * The list is indexed from its end so where an identifier is defined
+ * more than once the earliest definition is found, as
+ * webidl_node_find_type_ident() would.
+ */
+static int
+webidl_definitions_init(struct webidl_definitions *definitions,
+                        struct webidl_node *webidl_ast)
+{
+        if (webidl_ast == NULL) {
+                definitions->size = 0;
+                definitions->used = 0;
+                definitions->entries = NULL;
+                return 0;
+        }
+
+        if (webidl_definitions_init(definitions, webidl_ast->l) != 0) {
+                return -1;
+        }
+
+        if (webidl_node_add_definition(definitions, webidl_ast) != 0) {
+                free(definitions->entries);
+                return -1;
+        }
+
+        return 0;
+}
+
+/**
+ * add a copy of a definition to an AST
+ */
+static int
+webidl_merge_definition(struct webidl_definitions *index,
+                        struct webidl_node **webidl_ast,
+                        struct webidl_node *definition)
+{
+        struct webidl_node *existing = NULL;
+        struct webidl_node *copy;
+        struct webidl_node *child;
+        struct webidl_node *next;
+        struct webidl_node *members = NULL;
+        struct webidl_node **tail = &members;
+        const char *ident;
+
+        copy = webidl_node_copy(definition);
+        if (copy == NULL) {
+                return -1;
+        }
+
+        ident = webidl_definition_ident(copy);
+        if (ident != NULL) {
+                existing = webidl_node_find_definition(index,
+                                                       copy->type,
+                                                       ident);
+        }
+
+        if (existing == NULL) {
+                if (webidl_node_add_definition(index, copy) != 0) {
+                        webidl_node_free(copy);
+                        return -1;
+                }
+                *webidl_ast = webidl_node_prepend(*webidl_ast, copy);
+                return 0;
+        }
+
+        /* extend the existing definition with the members of the copy,
+         * the parser discards the identifier and extended attributes of
+         * a definition which extends another so they are freed
+         */
+        for (child = copy->r.node; child != NULL; child = next) {
+                next = child->l;
+                child->l = NULL;
+                if ((child->type == WEBIDL_NODE_TYPE_IDENT) ||
+                    (child->type == WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE)) {
+                        webidl_node_free(child);
+                } else {
+                        *tail = child;
+                        tail = &child->l;
+                }
+        }
+        free(copy);
+
+        webidl_node_add(existing, members);
+
+        return 0;
+}
+
+/**
+ * add copies of definitions to an AST from the end of the list
+ *
+ * definitions are prepended as they are parsed so the end of the list
+ * is merged first to add them in declaration order
+ */
+static int
+webidl_merge_definitions(struct webidl_definitions *index,
+                         struct webidl_node **webidl_ast,
+                         struct webidl_node *definitions)
+{
+        if (definitions == NULL) {
+                return 0;
+        }
+
+        if (webidl_merge_definitions(index,
+                                     webidl_ast,
+                                     definitions->l) != 0) {
+                return -1;
+        }
+
+        return webidl_merge_definition(index, webidl_ast, definitions);
+}
+
+/* exported interface defined in webidl-ast.h */
+int
+webidl_node_merge(struct webidl_node **webidl_ast,
+                  struct webidl_node *definitions)
+{
+        struct webidl_definitions index;
+        int res;
+
+        if (webidl_definitions_init(&index, *webidl_ast) != 0) {
+                return -1;
+        }
+
+        res = webidl_merge_definitions(&index, webidl_ast, definitions);
+
+        free(index.entries);
+
+        return res;
+}
+
+/* exported interface defined in webidl-ast.h */
+uint64_t webidl_node_hash(struct webidl_node *node, uint64_t hash)
+{
+        struct webidl_node *child;
+        char *text;
+        float *flt;
+        int *number;
+
+        hash = genb_hash(hash, &node->type, sizeof(node->type));
+
+        text = webidl_node_gettext(node);
+        flt = webidl_node_getfloat(node);
+        number = webidl_node_getint(node);
+        if (text != NULL) {
+                hash = genb_hash(hash, text, strlen(text) + 1);
+        } else if (flt != NULL) {
+                hash = genb_hash(hash, flt, sizeof(float));
+        } else if (number != NULL) {
+                hash = genb_hash(hash, number, sizeof(int));
+        } else {
+                for (child = webidl_node_getnode(node);
+                     child != NULL;
+                     child = child->l) {
+                        hash = webidl_node_hash(child, hash);
+                }
+                /* mark the end of the children */
+                hash = genb_hash(hash, "", 1);
+        }
+
+        return hash;
+}
+
 
 int
 webidl_node_for_each_type(struct webidl_node *node,
@@ -249,26 +749,27 @@ webidl_node_find_type_ident(struct webidl_node *root_node,
 {
 	struct webidl_node *node;
 	struct webidl_node *ident_node;
+	struct webidl_node *found = NULL;
 
-	node = webidl_node_find_type(root_node,	NULL, type);
-
-	while (node != NULL) {
+	/* searches find the matching node furthest along the list so
+	 * keep the last match in a single pass
+	 */
+	for (node = root_node; node != NULL; node = node->l) {
+		if (node->type != type) {
+			continue;
+		}
 
 		ident_node = webidl_node_find_type(webidl_node_getnode(node),
 					      NULL,
 					      WEBIDL_NODE_TYPE_IDENT);
-		if (ident_node != NULL) {
-			if (strcmp(ident_node->r.text, ident) == 0)
-				break;
+		if ((ident_node != NULL) &&
+		    (strcmp(ident_node->r.text, ident) == 0)) {
+			found = node;
 		}
-
-		node = webidl_node_find_type(root_node,	node, type);
-
 	}
-	return node;
+	return found;
 }
 
-
 /* exported interface defined in webidl-ast.h */
 char *webidl_node_gettext(struct webidl_node *node)
 {
@@ -339,6 +840,7 @@ struct webidl_node *webidl_node_getnode(struct webidl_node *node)
 		case WEBIDL_NODE_TYPE_ROOT:
 		case WEBIDL_NODE_TYPE_INTERFACE:
 		case WEBIDL_NODE_TYPE_DICTIONARY:
+		case WEBIDL_NODE_TYPE_ENUM:
 		case WEBIDL_NODE_TYPE_LIST:
 		case WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE:
 		case WEBIDL_NODE_TYPE_ATTRIBUTE:
@@ -347,6 +849,10 @@ struct webidl_node *webidl_node_getnode(struct webidl_node *node)
 		case WEBIDL_NODE_TYPE_ARGUMENT:
 		case WEBIDL_NODE_TYPE_TYPE:
 		case WEBIDL_NODE_TYPE_CONST:
+		case WEBIDL_NODE_TYPE_ITERABLE:
+		case WEBIDL_NODE_TYPE_MAPLIKE:
+		case WEBIDL_NODE_TYPE_SETLIKE:
+		case WEBIDL_NODE_TYPE_CALLBACK:
 			return node->r.node;
 		default:
 			break;
@@ -378,6 +884,9 @@ static const char *webidl_node_type_to_str(enum webidl_node_type type)
 	case WEBIDL_NODE_TYPE_DICTIONARY:
 		return "Dictionary";
 
+	case WEBIDL_NODE_TYPE_ENUM:
+		return "Enum";
+
 	case WEBIDL_NODE_TYPE_LIST:
 		return "List";
 
@@ -435,6 +944,18 @@ static const char *webidl_node_type_to_str(enum webidl_node_type type)
 	case WEBIDL_NODE_TYPE_SPECIAL:
 		return "Special";
 
+	case WEBIDL_NODE_TYPE_ITERABLE:
+		return "Iterable";
+
+	case WEBIDL_NODE_TYPE_MAPLIKE:
+		return "Maplike";
+
+	case WEBIDL_NODE_TYPE_SETLIKE:
+		return "Setlike";
+
+	case WEBIDL_NODE_TYPE_CALLBACK:
+		return "Callback";
+
 	default:
 		return "Unknown";
 	}
@@ -619,13 +1140,22 @@ static FILE *idlopen(const char *filename)
 int webidl_parsefile(char *filename, struct webidl_node **webidl_ast)
 {
 	FILE *idlfile;
+        char *idlmap;
+        size_t idlmapsize;
+        struct webidl_definitions definitions;
         int ret;
 
+        /* definitions in the file may extend those already parsed */
+        if (webidl_definitions_init(&definitions, *webidl_ast) != 0) {
+                return -1;
+        }
+
 	idlfile = idlopen(filename);
 	if (!idlfile) {
 		fprintf(stderr, "Error opening %s: %s\n",
 			filename,
 			strerror(errno));
+                free(definitions.entries);
 		return 2;
 	}
 
@@ -645,11 +1175,30 @@ int webidl_parsefile(char *filename, struct webidl_node **webidl_ast)
                 webidl_parsetracef = NULL;
         }
 
-	/* set flex to read from file */
-	webidl_restart(idlfile);
+        /* map the top level file if possible otherwise read from it */
+        idlmap = genb_mapfile(idlfile, &idlmapsize);
+        if (idlmap != NULL) {
+                fclose(idlfile);
+                webidl__scan_buffer(idlmap, idlmapsize);
+        } else {
+                webidl_restart(idlfile);
+        }
 
 	/* parse the file */
-	ret = webidl_parse(webidl_ast);
+	ret = webidl_parse(webidl_ast, &definitions);
+
+        free(definitions.entries);
+
+        /* release lexer buffers before the mapping they may refer to */
+        if (webidl_lex_release() != 0) {
+                ret = 3;
+        }
+        webidl_lex_destroy();
+        if (idlmap != NULL) {
+                genb_unmapfile(idlmap, idlmapsize);
+        } else {
+                fclose(idlfile);
+        }
 
         /* close tracefile if open */
         if (webidl_parsetracef != NULL) {
@@ -729,57 +1278,196 @@ static int implements_copy_nodes(struct webidl_node *src_node,
 	return 0;
 }
 
-static int
-intercalate_implements(struct webidl_node *interface_node, void *ctx)
+/** progress of an interface through intercalation */
+enum intercalate_state {
+        INTERCALATE_PENDING, /**< implements not yet processed */
+        INTERCALATE_ACTIVE, /**< implements being processed */
+        INTERCALATE_DONE, /**< all implemented members present */
+};
+
+/** an interface in the intercalation index */
+struct intercalate_entry {
+        const char *name; /**< interface identifier */
+        struct webidl_node *node; /**< interface node */
+        enum intercalate_state state; /**< intercalation progress */
+};
+
+/**
+ * index of interfaces by name used during intercalation
+ *
+ * open addressed with linear probing, size is a power of two
+ */
+struct intercalate_index {
+        unsigned int size;
+        struct intercalate_entry *entries;
+};
+
+static struct intercalate_entry *
+intercalate_index_slot(struct intercalate_index *index, const char *name)
+{
+        unsigned int slot;
+
+        slot = genb_hash(GENB_HASH_INIT, name, strlen(name)) &
+                (index->size - 1);
+        while ((index->entries[slot].name != NULL) &&
+               (strcmp(index->entries[slot].name, name) != 0)) {
+                slot = (slot + 1) & (index->size - 1);
+        }
+        return &index->entries[slot];
+}
+
+static int intercalate_index_add(struct webidl_node *interface_node, void *ctx)
+{
+        struct intercalate_index *index = ctx;
+        struct intercalate_entry *entry;
+        const char *name;
+
+        name = webidl_node_gettext(
+                webidl_node_find_type(webidl_node_getnode(interface_node),
+                                      NULL,
+                                      WEBIDL_NODE_TYPE_IDENT));
+        if (name == NULL) {
+                return 0;
+        }
+
+        entry = intercalate_index_slot(index, name);
+        if (entry->name == NULL) {
+                /* the list is visited from its end so keeping the first
+                 * interface added for a name matches what
+                 * webidl_node_find_type_ident() returns
+                 */
+                entry->name = name;
+                entry->node = interface_node;
+                entry->state = INTERCALATE_PENDING;
+        }
+
+        return 0;
+}
+
+/**
+ * ensure all the members an interface implements are present
+ *
+ * Each interface is processed once, implementing interfaces then use the
+ * completed member lists so a widely implemented interface is not
+ * processed for every implementer. Implemented interfaces may not form a
+ * cycle, if they do the cycle is broken at the interface found to
+ * already be in progress.
+ */
+static void
+intercalate_interface(struct intercalate_index *index,
+                      struct intercalate_entry *entry)
 {
 	struct webidl_node *implements_node;
-	struct webidl_node *implements_interface_node;
-	struct webidl_node *webidl_ast = ctx;
+	struct intercalate_entry *implements_entry;
+
+        if (entry->state != INTERCALATE_PENDING) {
+                return;
+        }
+        entry->state = INTERCALATE_ACTIVE;
 
 	implements_node = webidl_node_find_type(
-		webidl_node_getnode(interface_node),
+		webidl_node_getnode(entry->node),
 		NULL,
 		WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS);
 	while (implements_node != NULL) {
 
-		implements_interface_node = webidl_node_find_type_ident(
-			webidl_ast,
-			WEBIDL_NODE_TYPE_INTERFACE,
-			webidl_node_gettext(implements_node));
+		implements_entry = intercalate_index_slot(
+                        index,
+                        webidl_node_gettext(implements_node));
+                if (implements_entry->name != NULL) {
+                        /* ensure the implemented interface is complete */
+                        intercalate_interface(index, implements_entry);
 
-		/* recurse, ensuring all subordinate interfaces have
-		 * their implements intercalated first
-		 */
-		intercalate_implements(implements_interface_node, webidl_ast);
-
-		implements_copy_nodes(implements_interface_node, interface_node);
+                        /* the member lists are shared not copied */
+                        implements_copy_nodes(implements_entry->node,
+                                              entry->node);
+                }
 
 		/* once we have copied the implemntation remove entry */
-		webidl_unlink(interface_node, implements_node);
+		webidl_unlink(entry->node, implements_node);
+		free(implements_node->r.text);
+		free(implements_node);
 
 		implements_node = webidl_node_find_type(
-			webidl_node_getnode(interface_node),
-			implements_node,
+			webidl_node_getnode(entry->node),
+			NULL,
 			WEBIDL_NODE_TYPE_INTERFACE_IMPLEMENTS);
 	}
+
+        entry->state = INTERCALATE_DONE;
+}
+
+static int
+intercalate_implements(struct webidl_node *interface_node, void *ctx)
+{
+	struct intercalate_index *index = ctx;
+        struct intercalate_entry *entry;
+        struct intercalate_entry unindexed;
+        const char *name;
+
+        name = webidl_node_gettext(
+                webidl_node_find_type(webidl_node_getnode(interface_node),
+                                      NULL,
+                                      WEBIDL_NODE_TYPE_IDENT));
+
+        if (name != NULL) {
+                entry = intercalate_index_slot(index, name);
+        } else {
+                entry = NULL;
+        }
+
+        if ((entry == NULL) || (entry->node != interface_node)) {
+                /* interface without a usable name still has its
+                 * implements processed
+                 */
+                unindexed.name = name;
+                unindexed.node = interface_node;
+                unindexed.state = INTERCALATE_PENDING;
+                entry = &unindexed;
+        }
+
+        intercalate_interface(index, entry);
+
 	return 0;
 }
 
 /* exported interface defined in webidl-ast.h */
 int webidl_intercalate_implements(struct webidl_node *webidl_ast)
 {
+        struct intercalate_index index;
+        int interfacec;
         int res = 0;
+
         if (webidl_ast != NULL) {
+                /* index the interfaces by name */
+                interfacec = webidl_node_enumerate_type(webidl_ast,
+                                                WEBIDL_NODE_TYPE_INTERFACE);
+                index.size = 16;
+                while (index.size < (unsigned int)(interfacec * 2)) {
+                        index.size *= 2;
+                }
+                index.entries = calloc(index.size,
+                                       sizeof(struct intercalate_entry));
+                if (index.entries == NULL) {
+                        return -1;
+                }
+                webidl_node_for_each_type(webidl_ast,
+                                          WEBIDL_NODE_TYPE_INTERFACE,
+                                          intercalate_index_add,
+                                          &index);
+
                 /* for each interface:
                  *   for each implements entry:
-                 *     find interface from implemets
-                 *     recusrse into that interface
-                 *     copy the interface into this one
+                 *     find interface from implemets in the index
+                 *     ensure that interface is complete
+                 *     share its member lists with this one
                  */
                 res = webidl_node_for_each_type(webidl_ast,
                                                 WEBIDL_NODE_TYPE_INTERFACE,
                                                 intercalate_implements,
-                                                webidl_ast);
+                                                &index);
+
+                free(index.entries);
         }
         return res;
 }
@@ -9,6 +9,8 @@
 #ifndef nsgenbind_webidl_ast_h
 #define nsgenbind_webidl_ast_h
 
+#include <stdint.h>
+
 enum webidl_node_type {
 	/* generic node types which define structure or attributes */
 	WEBIDL_NODE_TYPE_ROOT = 0,
@@ -27,6 +29,7 @@ enum webidl_node_type {
 	WEBIDL_NODE_TYPE_CONST,
 
 	WEBIDL_NODE_TYPE_DICTIONARY, /**< node is a dictionary */
+	WEBIDL_NODE_TYPE_ENUM, /**< node is an enumeration */
 
 	WEBIDL_NODE_TYPE_INHERITANCE, /**< node has inheritance */
 	WEBIDL_NODE_TYPE_SPECIAL,
@@ -46,6 +49,13 @@ enum webidl_node_type {
 
 	WEBIDL_NODE_TYPE_EXTENDED_ATTRIBUTE,
 
+	WEBIDL_NODE_TYPE_ITERABLE, /**< iterable declaration */
+	WEBIDL_NODE_TYPE_MAPLIKE, /**< maplike declaration */
+	WEBIDL_NODE_TYPE_SETLIKE, /**< setlike declaration */
+	WEBIDL_NODE_TYPE_CALLBACK, /**< callback function or marker on a
+				    * callback interface
+				    */
+
 };
 
 enum webidl_type {
@@ -87,6 +97,9 @@ enum webidl_type_special {
 
 struct webidl_node;
 
+/** index of the definitions of the AST being parsed */
+struct webidl_definitions;
+
 /** callback for search and iteration routines */
 typedef int (webidl_callback_t)(struct webidl_node *node, void *ctx);
 
@@ -108,6 +121,56 @@ struct webidl_node *webidl_node_append(struct webidl_node *list, struct webidl_n
 
 struct webidl_node *webidl_node_add(struct webidl_node *node, struct webidl_node *list);
 
+/**
+ * free a web IDL AST
+ *
+ * The node, the nodes which follow it and all their children are freed
+ * including lists shared by intercalating implements.
+ *
+ * \param node The node to free from (usually tree root) or NULL.
+ * \return 0 on success or -1 if the AST could not be freed.
+ */
+int webidl_node_free(struct webidl_node *node);
+
+/**
+ * free a node whose children have been moved to another node
+ *
+ * The node and its children before the first moved child are freed,
+ * the moved child and those following it are not.
+ *
+ * \param node The node to free.
+ * \param moved The first child moved to another node.
+ * \return 0 on success or -1 if the node could not be freed.
+ */
+int webidl_node_free_moved(struct webidl_node *node, struct webidl_node *moved);
+
+/**
+ * add copies of the definitions of a separately parsed file to an AST
+ *
+ * Interfaces and dictionaries already in the AST are extended with the
+ * members of the copies as the parser extends a repeated or partial
+ * definition, so adding files in turn gives the AST parsing them in
+ * turn would. The definitions are not altered so a file need only be
+ * parsed again when it changes.
+ *
+ * \param webidl_ast The AST to add to, updated with the new list head.
+ * \param definitions The definitions parsed from the file.
+ * \return 0 on success or -1 on allocation failure.
+ */
+int webidl_node_merge(struct webidl_node **webidl_ast, struct webidl_node *definitions);
+
+/**
+ * add a node and its children to a hash
+ *
+ * The nodes which follow the node are not included so the hash of a
+ * definition changes only when the definition does.
+ *
+ * \param node The node to hash.
+ * \param hash The hash to add to, GENB_HASH_INIT for a new hash.
+ * \return The updated hash.
+ */
+uint64_t webidl_node_hash(struct webidl_node *node, uint64_t hash);
+
 /* node contents acessors */
 char *webidl_node_gettext(struct webidl_node *node);
 struct webidl_node *webidl_node_getnode(struct webidl_node *node);
@@ -148,6 +211,27 @@ webidl_node_find_type_ident(struct webidl_node *root_node,
 			    enum webidl_node_type type, 
 			    const char *ident);
 
+/**
+ * find a top level interface or dictionary definition by identifier
+ *
+ * Equivalent to webidl_node_find_type_ident() on the root of the AST
+ * being parsed but looks the identifier up in the index of its
+ * definitions so lookups while parsing do not scan every definition.
+ */
+struct webidl_node *
+webidl_node_find_definition(struct webidl_definitions *definitions,
+                            enum webidl_node_type type,
+                            const char *ident);
+
+/**
+ * add a definition added to the AST being parsed to its index
+ *
+ * \return 0 on success or -1 if the index could not be extended.
+ */
+int
+webidl_node_add_definition(struct webidl_definitions *definitions,
+                           struct webidl_node *node);
+
 
 
 /**
@@ -27,18 +27,22 @@
                  (Loc).last_line,  (Loc).last_column)
 
 #include "utils.h"
+#include "webidl-ast.h"
+
 #include "webidl-parser.h"
 #include "webidl-lexer.h"
 
-#include "webidl-ast.h"
-
 char *errtxt;
 
 static void
-webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
+webidl_error(YYLTYPE *locp,
+             struct webidl_node **winbind_ast,
+             struct webidl_definitions *definitions,
+             const char *str)
 {
     UNUSED(locp);
     UNUSED(winbind_ast);
+    UNUSED(definitions);
     errtxt = strdup(str);
 }
 
@@ -51,6 +55,7 @@ webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
 %pure-parser
 %error-verbose
 %parse-param { struct webidl_node **webidl_ast }
+%parse-param { struct webidl_definitions *definitions }
 
 %union
 {
@@ -91,6 +96,7 @@ webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
 %token TOK_LEGACYCALLER
 %token TOK_LEGACYITERABLE
 %token TOK_LONG
+%token TOK_MAPLIKE
 %token TOK_MODULE
 %token TOK_NAN
 %token TOK_NATIVE
@@ -107,6 +113,7 @@ webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
 %token TOK_READONLY
 %token TOK_REQUIRED
 %token TOK_SETRAISES
+%token TOK_SETLIKE
 %token TOK_SETTER
 %token TOK_SEQUENCE
 %token TOK_SHORT
@@ -143,6 +150,7 @@ webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
 
 %type <node> Exception
 %type <node> Enum
+%type <node> EnumValueList
 %type <node> Typedef
 %type <node> ImplementsStatement
 
@@ -180,6 +188,8 @@ webidl_error(YYLTYPE *locp, struct webidl_node **winbind_ast, const char *str)
 %type <text> ArgumentNameKeyword
 %type <node> Ellipsis
 %type <node> Iterable
+%type <node> MaplikeOrSetlike
+%type <node> MaplikeOrSetlikeRest
 %type <node> OptionalType
 %type <node> Default
 %type <node> DefaultValue
@@ -233,8 +243,16 @@ Definitions:
         |
         Definitions ExtendedAttributeList Definition
         {
-            webidl_node_add($3, $2);
+            if (webidl_node_add($3, $2) != $3) {
+                /* definition did not take the extended attributes */
+                webidl_node_free($2);
+            }
             $$ = *webidl_ast = webidl_node_prepend(*webidl_ast, $3);
+
+            /* index the definition so it can be extended */
+            if (webidl_node_add_definition(definitions, $3) != 0) {
+                YYABORT;
+            }
         }
         |
         error
@@ -267,6 +285,14 @@ CallbackOrInterface
         :
         TOK_CALLBACK CallbackRestOrInterface
         {
+            /* mark callback interfaces so they may be invoked */
+            if (($2 != NULL) &&
+                (webidl_node_gettype($2) == WEBIDL_NODE_TYPE_INTERFACE)) {
+                    webidl_node_add($2,
+                                    webidl_node_new(WEBIDL_NODE_TYPE_CALLBACK,
+                                                    NULL,
+                                                    NULL));
+            }
             $$ = $2;
         }
         |
@@ -297,7 +323,7 @@ Interface:
                 members = webidl_node_new(WEBIDL_NODE_TYPE_LIST, members, $5);
 
 
-                interface_node = webidl_node_find_type_ident(*webidl_ast,
+                interface_node = webidl_node_find_definition(definitions,
                                                      WEBIDL_NODE_TYPE_INTERFACE,
                                                              $2);
 
@@ -316,6 +342,7 @@ Interface:
                         /* link member node into interfaces_node */
                         webidl_node_add(interface_node, members);
 
+                        free($2);
                         $$ = NULL; /* updating so no need to add a new node */
                 }
         }
@@ -344,7 +371,7 @@ PartialInterface:
             struct webidl_node *members;
             struct webidl_node *interface_node;
 
-            interface_node = webidl_node_find_type_ident(*webidl_ast,
+            interface_node = webidl_node_find_definition(definitions,
                                                      WEBIDL_NODE_TYPE_INTERFACE,
                                                      $2);
 
@@ -362,6 +389,7 @@ PartialInterface:
                 /* link member node into interfaces_node */
                 webidl_node_add(interface_node, members);
 
+                free($2);
                 $$ = NULL; /* updating so no need to add a new node */
             }
         }
@@ -425,6 +453,7 @@ InterfaceMembers:
                                 $$ = webidl_node_prepend($1, $3);
                         } else {
                                 webidl_node_add(member_node, list_node);
+                                webidl_node_free_moved($3, list_node);
                                 $$ = $1; /* updated existing node do not add new one */
                         }
                 }
@@ -444,6 +473,8 @@ InterfaceMember:
         StaticMember
         |
         Iterable
+        |
+        MaplikeOrSetlike
         ;
 
  /* [11] */
@@ -462,8 +493,8 @@ Dictionary:
 
                 members = webidl_node_new(WEBIDL_NODE_TYPE_LIST, members, $5);
 
-                dictionary_node = webidl_node_find_type_ident(
-                                         *webidl_ast,
+                dictionary_node = webidl_node_find_definition(
+                                         definitions,
                                          WEBIDL_NODE_TYPE_DICTIONARY,
                                          $2);
 
@@ -482,6 +513,7 @@ Dictionary:
                         /* link member node into interfaces_node */
                         webidl_node_add(dictionary_node, members);
 
+                        free($2);
                         $$ = NULL; /* updating so no need to add a new node */
                 }
         }
@@ -493,10 +525,11 @@ DictionaryMembers:
                 $$ = NULL; /* empty */
         }
         |
-        ExtendedAttributeList DictionaryMember DictionaryMembers
+        DictionaryMembers ExtendedAttributeList DictionaryMember
         {
                 /** \todo handle ExtendedAttributeList */
-                $$ = webidl_node_append($3, $2);
+                webidl_node_free($2);
+                $$ = webidl_node_prepend($1, $3);
         }
         ;
 
@@ -551,8 +584,8 @@ PartialDictionary:
                 struct webidl_node *members;
                 struct webidl_node *dictionary_node;
 
-                dictionary_node = webidl_node_find_type_ident(
-                                         *webidl_ast,
+                dictionary_node = webidl_node_find_definition(
+                                         definitions,
                                          WEBIDL_NODE_TYPE_DICTIONARY,
                                          $2);
 
@@ -574,6 +607,7 @@ PartialDictionary:
                         /* link member node into dictionary node */
                         webidl_node_add(dictionary_node, members);
 
+                        free($2);
                         $$ = NULL; /* updating so no need to add a new node */
                 }
         }
@@ -607,6 +641,8 @@ DefaultValue:
 Exception:
         TOK_EXCEPTION TOK_IDENTIFIER Inheritance '{' ExceptionMembers '}' ';'
         {
+            free($2);
+            free($3);
             $$ = NULL;
         }
         ;
@@ -633,29 +669,41 @@ Inheritance:
 
 /* [20] */
 Enum:
-        TOK_ENUM TOK_IDENTIFIER '{' EnumValueList '}' ';'
+        TOK_ENUM TOK_IDENTIFIER '{' EnumValueList EnumValueListComma '}' ';'
         {
-                $$ = NULL;
+                struct webidl_node *values;
+
+                values = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $4);
+
+                values = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, values, $2);
+
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_ENUM, NULL, values);
         }
         ;
 
  /* Second edition changes enumeration rules to allow trailing comma */
 
-  /* SE[20] */
+  /* SE[20] values are prepended so they are found in declaration order */
 EnumValueList:
-        TOK_STRING_LITERAL EnumValueListComma
+        TOK_STRING_LITERAL
+        {
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_STRING,
+                                     NULL,
+                                     $1);
+        }
+        |
+        EnumValueList ',' TOK_STRING_LITERAL
+        {
+                $$ = webidl_node_prepend($1,
+                        webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_STRING,
+                                        NULL,
+                                        $3));
+        }
         ;
 
  /* SE[21] */
 EnumValueListComma:
-        ',' EnumValueListString
-        |
-        /* empty */
-        ;
-
- /* SE[22] */
-EnumValueListString:
-        TOK_STRING_LITERAL EnumValueListComma
+        ','
         |
         /* empty */
         ;
@@ -665,7 +713,15 @@ EnumValueListString:
 CallbackRest:
         TOK_IDENTIFIER '=' ReturnType '(' ArgumentList ')' ';'
         {
-                $$ = NULL;
+                /* argument list */
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $5);
+
+                /* return type */
+                $$ = webidl_node_prepend($3, $$);
+
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_IDENT, $$, $1);
+
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_CALLBACK, NULL, $$);
         }
         ;
 
@@ -673,6 +729,9 @@ CallbackRest:
 Typedef:
         TOK_TYPEDEF ExtendedAttributeList Type TOK_IDENTIFIER ';'
         {
+                webidl_node_free($2);
+                webidl_node_free($3);
+                free($4);
                 $$ = NULL;
         }
         ;
@@ -686,7 +745,7 @@ ImplementsStatement:
             struct webidl_node *interface_node;
 
 
-            interface_node = webidl_node_find_type_ident(*webidl_ast,
+            interface_node = webidl_node_find_definition(definitions,
                                                      WEBIDL_NODE_TYPE_INTERFACE,
                                                      $1);
 
@@ -704,6 +763,7 @@ ImplementsStatement:
                 /* link implements node into interfaces_node */
                 webidl_node_add(interface_node, implements);
 
+                free($1);
                 $$ = NULL; /* updating so no need to add a new node */
             }
         }
@@ -770,6 +830,7 @@ FloatLiteral:
                 float *value;
                 value = malloc(sizeof(float));
                 *value = strtof($1, NULL);
+                free($1);
                 $$ = webidl_node_new(WEBIDL_NODE_TYPE_LITERAL_FLOAT,
                                      NULL,
                                      value);
@@ -1083,7 +1144,7 @@ OptionalIdentifier:
 
 
  /* [41] an empty list or a list of non empty comma separated arguments, note
-  * this is right associative so the tree build is ass backwards
+  * the list is built in reverse order
   */
 ArgumentList:
         /* empty */
@@ -1091,30 +1152,24 @@ ArgumentList:
                 $$ = NULL;
         }
         |
-        Argument Arguments
-        {
-                $$ = webidl_node_append($2, $1);
-        }
+        Arguments
         ;
 
- /* [42] */
+ /* [42] altered from original grammar to be left recursive */
 Arguments:
-        /* empty */
-        {
-                $$ = NULL;
-        }
+        Argument
         |
-        ',' Argument Arguments
+        Arguments ',' Argument
         {
-                $$ = webidl_node_append($3, $2);
+                $$ = webidl_node_prepend($1, $3);
         }
         ;
 
-
  /* [43] */
 Argument:
         ExtendedAttributeList OptionalOrRequiredArgument
         {
+                webidl_node_free($1);
                 $$ = $2;
         }
         ;
@@ -1160,16 +1215,35 @@ Ellipsis:
         }
         ;
 
- /* SE[59] */
+ /* SE[59]
+  * The key (if any) and value types are each held in a list node, the
+  * value type being the last
+  */
 Iterable:
         TOK_ITERABLE '<' Type OptionalType '>' ';'
         {
-                $$ = NULL;
+                struct webidl_node *types;
+
+                types = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $3);
+                if ($4 != NULL) {
+                        /* pair iterator with key and value types */
+                        types = webidl_node_append(
+                                types,
+                                webidl_node_new(WEBIDL_NODE_TYPE_LIST,
+                                                NULL,
+                                                $4));
+                }
+
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_ITERABLE, NULL, types);
         }
         |
         TOK_LEGACYITERABLE '<' Type '>' ';'
         {
-                $$ = NULL;
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_ITERABLE,
+                                     NULL,
+                                     webidl_node_new(WEBIDL_NODE_TYPE_LIST,
+                                                     NULL,
+                                                     $3));
         }
         ;
 
@@ -1182,7 +1256,59 @@ OptionalType:
         |
         ',' Type
         {
-                $$ = NULL;
+                $$ = $2;
+        }
+        ;
+
+ /* SE[61]
+  * The readonly prefix is shared with attributes to keep the grammar
+  * LALR(1) so the inherit modifier has to be rejected here
+  */
+MaplikeOrSetlike:
+        Inherit ReadOnly MaplikeOrSetlikeRest
+        {
+                if ($1) {
+                        webidl_error(&@1,
+                                     webidl_ast,
+                                     definitions,
+                                     "inherit is not valid on maplike or setlike");
+                        YYERROR;
+                }
+
+                /* deal with readonly modifier */
+                if ($2) {
+                        webidl_node_add($3,
+                                        webidl_new_number_node(
+                                                WEBIDL_NODE_TYPE_MODIFIER,
+                                                NULL,
+                                                WEBIDL_TYPE_MODIFIER_READONLY));
+                }
+
+                $$ = $3;
+        }
+        ;
+
+ /* SE[62] */
+MaplikeOrSetlikeRest:
+        TOK_MAPLIKE '<' Type ',' Type '>' ';'
+        {
+                struct webidl_node *types;
+
+                types = webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $3);
+                types = webidl_node_append(
+                        types,
+                        webidl_node_new(WEBIDL_NODE_TYPE_LIST, NULL, $5));
+
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_MAPLIKE, NULL, types);
+        }
+        |
+        TOK_SETLIKE '<' Type '>' ';'
+        {
+                $$ = webidl_node_new(WEBIDL_NODE_TYPE_SETLIKE,
+                                     NULL,
+                                     webidl_node_new(WEBIDL_NODE_TYPE_LIST,
+                                                     NULL,
+                                                     $3));
         }
         ;
 
@@ -1614,6 +1740,11 @@ ArgumentNameKeyword:
             $$ = strdup("legacyiterable");
         }
         |
+        TOK_MAPLIKE
+        {
+            $$ = strdup("maplike");
+        }
+        |
         TOK_PARTIAL
         {
             $$ = strdup("partial");
@@ -1624,6 +1755,11 @@ ArgumentNameKeyword:
             $$ = strdup("required");
         }
         |
+        TOK_SETLIKE
+        {
+            $$ = strdup("setlike");
+        }
+        |
         TOK_SETTER
         {
             $$ = strdup("setter");
@@ -1673,6 +1809,7 @@ Type:
         UnionType TypeSuffix
         {
             /* todo handle suffix */
+            webidl_node_free($2);
             $$ = $1;
         }
         ;
@@ -1708,6 +1845,7 @@ UnionMemberType:
         UnionType TypeSuffix
         {
             /* todo handle suffix */
+            webidl_node_free($2);
             $$ = $1;
         }
         |
@@ -1912,6 +2050,7 @@ OptionalLong:
 PromiseType:
         TOK_PROMISE '<' ReturnType '>'
         {
+            webidl_node_free($3);
             $$ = NULL;
         }
         ;
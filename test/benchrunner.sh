@@ -0,0 +1,118 @@
+#!/bin/sh
+#
+# Benchmark the binding generator against synthetic corpora
+#
+# Each parameter of the corpus generator is swept in turn with the
+# others held at their base values. The time taken by each phase of
+# the generator is recorded so behaviour which does not scale
+# linearly shows up as a curve.
+
+BUILDDIR=$1
+TESTSRCDIR=$2
+
+# locations
+# benchmark output
+BENCHOUTDIR=${BUILDDIR}/bench
+# benchmark results
+RESULTFILE=${BENCHOUTDIR}/results.csv
+
+# genbind tool
+NSGENBIND=${BUILDDIR}/nsgenbind
+
+# corpus generator
+MKCORPUS=${TESTSRCDIR}/mkcorpus.sh
+
+# base corpus parameters
+BASE_INTERFACES=${BENCH_INTERFACES:-50}
+BASE_DEPTH=${BENCH_DEPTH:-4}
+BASE_MEMBERS=${BENCH_MEMBERS:-8}
+BASE_FANIN=${BENCH_FANIN:-2}
+BASE_OVERLOADS=${BENCH_OVERLOADS:-2}
+BASE_DICTSIZE=${BENCH_DICTSIZE:-8}
+
+# multipliers applied to the swept parameter
+SCALES=${BENCH_SCALES:-"1 2 4 8"}
+
+PHASES="binding idl intercalate ir dump output"
+
+mkdir -p ${BENCHOUTDIR}
+
+# get the wall time of each phase from the JSON statistics
+phase_times() {
+  awk -v phases="${PHASES}" '
+    /"name": "/ {
+      split($0, f, "\"")
+      name = f[4]
+      if (match($0, /"wall_ms": [0-9.]+/)) {
+        wall[name] = substr($0, RSTART + 11, RLENGTH - 11)
+      }
+    }
+    END {
+      n = split(phases, p, " ")
+      for (i = 1; i <= n; i++) {
+        printf(",%s", (p[i] in wall) ? wall[p[i]] : "0")
+      }
+    }' $1
+}
+
+# run a single benchmark
+bench() {
+  SWEEP=$1
+  shift
+
+  CORPUSNAME=$(echo "$@" | tr ' ' '-')
+  CORPUSDIR=${BENCHOUTDIR}/corpus-${CORPUSNAME}
+  OUTDIR=${CORPUSDIR}/out
+  STATSFILE=${CORPUSDIR}/stats.json
+
+  if [ ! -f ${CORPUSDIR}/bench.bnd ]; then
+    ${MKCORPUS} ${CORPUSDIR} "$@" || return 1
+  fi
+
+  mkdir -p ${OUTDIR}
+
+  ${NSGENBIND} -n --stats=${STATSFILE} -I ${CORPUSDIR} ${CORPUSDIR}/bench.bnd ${OUTDIR} >/dev/null 2>${CORPUSDIR}/err
+  RESULT=$?
+
+  if [ ${RESULT} -ne 0 ]; then
+    echo "    BENCH: ${SWEEP} $*......FAIL"
+    return 1
+  fi
+
+  TIMES=$(phase_times ${STATSFILE})
+
+  echo "${SWEEP},$(echo "$@" | tr ' ' ',')${TIMES}" >> ${RESULTFILE}
+
+  echo "    BENCH: ${SWEEP} $*......$(echo ${TIMES} | tr ',' ' ')"
+}
+
+echo "sweep,interfaces,depth,members,fanin,overloads,dictsize,$(echo ${PHASES} | tr ' ' ',')" > ${RESULTFILE}
+
+echo "    BENCH: parameters are interfaces depth members fanin overloads dictsize"
+echo "    BENCH: phase wall times (ms) are ${PHASES}"
+
+for SCALE in ${SCALES};do
+  bench interfaces $((BASE_INTERFACES * SCALE)) ${BASE_DEPTH} ${BASE_MEMBERS} ${BASE_FANIN} ${BASE_OVERLOADS} ${BASE_DICTSIZE}
+done
+
+for SCALE in ${SCALES};do
+  bench depth ${BASE_INTERFACES} $((BASE_DEPTH * SCALE)) ${BASE_MEMBERS} ${BASE_FANIN} ${BASE_OVERLOADS} ${BASE_DICTSIZE}
+done
+
+for SCALE in ${SCALES};do
+  bench members ${BASE_INTERFACES} ${BASE_DEPTH} $((BASE_MEMBERS * SCALE)) ${BASE_FANIN} ${BASE_OVERLOADS} ${BASE_DICTSIZE}
+done
+
+for SCALE in ${SCALES};do
+  bench fanin ${BASE_INTERFACES} ${BASE_DEPTH} ${BASE_MEMBERS} $((BASE_FANIN * SCALE)) ${BASE_OVERLOADS} ${BASE_DICTSIZE}
+done
+
+for SCALE in ${SCALES};do
+  bench overloads ${BASE_INTERFACES} ${BASE_DEPTH} ${BASE_MEMBERS} ${BASE_FANIN} $((BASE_OVERLOADS * SCALE)) ${BASE_DICTSIZE}
+done
+
+for SCALE in ${SCALES};do
+  bench dictsize ${BASE_INTERFACES} ${BASE_DEPTH} ${BASE_MEMBERS} ${BASE_FANIN} ${BASE_OVERLOADS} $((BASE_DICTSIZE * SCALE))
+done
+
+echo "    BENCH: results in ${RESULTFILE}"
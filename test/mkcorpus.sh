@@ -0,0 +1,131 @@
+#!/bin/sh
+#
+# Generate a synthetic WebIDL and binding corpus for benchmarking
+#
+# usage: mkcorpus.sh outdir interfaces depth members fanin overloads dictsize
+#
+#  outdir     directory to place bench.idl and bench.bnd in
+#  interfaces number of interfaces
+#  depth      length of the inheritance chains the interfaces form
+#  members    attributes, operations and constants on each interface
+#  fanin      number of mixin interfaces each interface implements
+#  overloads  number of overloads of each operation
+#  dictsize   number of members on each dictionary
+#
+# The output depends only upon the parameters so runs are repeatable.
+
+if [ $# -ne 7 ]; then
+  echo "usage: $0 outdir interfaces depth members fanin overloads dictsize" >&2
+  exit 1
+fi
+
+OUTDIR=$1
+
+mkdir -p ${OUTDIR}
+
+awk -v outdir="${OUTDIR}" \
+    -v ifacec=$2 -v depth=$3 -v memberc=$4 \
+    -v fanin=$5 -v overloadc=$6 -v dictsize=$7 '
+function typename(n) {
+  n = n % 4
+  if (n == 0) return "DOMString"
+  if (n == 1) return "long"
+  if (n == 2) return "boolean"
+  return "unsigned short"
+}
+
+BEGIN {
+  idl = outdir "/bench.idl"
+  bnd = outdir "/bench.bnd"
+
+  if (depth < 1) depth = 1
+  mixinc = fanin
+  dictc = int(ifacec / 4) + 1
+
+  print "/* synthetic benchmark corpus */" > idl
+  printf("/* interfaces:%d depth:%d members:%d fanin:%d overloads:%d dictsize:%d */\n\n",
+         ifacec, depth, memberc, fanin, overloadc, dictsize) > idl
+
+  # mixins
+  for (m = 0; m < mixinc; m++) {
+    printf("[NoInterfaceObject]\ninterface BenchMixin%d {\n", m) > idl
+    for (a = 0; a < memberc; a++) {
+      printf("  attribute %s mixin%dAttr%d;\n", typename(a), m, a) > idl
+    }
+    printf("};\n\n") > idl
+  }
+
+  # interfaces
+  for (i = 0; i < ifacec; i++) {
+    if ((i % depth) == 0) {
+      printf("interface BenchInterface%d {\n", i) > idl
+    } else {
+      printf("interface BenchInterface%d : BenchInterface%d {\n", i, i - 1) > idl
+    }
+    for (c = 0; c < memberc; c++) {
+      printf("  const unsigned short BENCH_%d_CONST_%d = %d;\n", i, c, c) > idl
+    }
+    for (a = 0; a < memberc; a++) {
+      if ((a % 3) == 0) {
+        printf("  readonly attribute %s iface%dAttr%d;\n", typename(a), i, a) > idl
+      } else {
+        printf("  attribute %s iface%dAttr%d;\n", typename(a), i, a) > idl
+      }
+    }
+    for (o = 0; o < memberc; o++) {
+      for (v = 0; v < overloadc; v++) {
+        printf("  %s iface%dOp%d(", typename(o), i, o) > idl
+        for (p = 0; p <= v; p++) {
+          if (p > 0) printf(", ") > idl
+          printf("%s arg%d", typename(p + v), p) > idl
+        }
+        printf(");\n") > idl
+      }
+    }
+    printf("};\n\n") > idl
+
+    for (m = 0; m < mixinc; m++) {
+      printf("BenchInterface%d implements BenchMixin%d;\n", i, (i + m) % mixinc) > idl
+    }
+    if (mixinc > 0) printf("\n") > idl
+  }
+
+  # dictionaries
+  for (d = 0; d < dictc; d++) {
+    if (d == 0) {
+      printf("dictionary BenchDictionary%d {\n", d) > idl
+    } else {
+      printf("dictionary BenchDictionary%d : BenchDictionary%d {\n", d, d - 1) > idl
+    }
+    for (e = 0; e < dictsize; e++) {
+      if ((e % 2) == 0) {
+        printf("  long dict%dMember%d = %d;\n", d, e, e) > idl
+      } else {
+        printf("  boolean dict%dMember%d = false;\n", d, e) > idl
+      }
+    }
+    printf("};\n\n") > idl
+  }
+
+  # binding
+  print "/* synthetic benchmark binding */\n" > bnd
+  print "binding duk_libdom {" > bnd
+  print "\twebidl \"bench.idl\";" > bnd
+  print "};\n" > bnd
+
+  for (i = 0; i < ifacec; i++) {
+    printf("class BenchInterface%d {\n", i) > bnd
+    printf("\tprivate int value%d;\n", i) > bnd
+    printf("};\n\n") > bnd
+
+    if (memberc > 0) {
+      printf("getter BenchInterface%d::iface%dAttr0()\n%%{\n", i, i) > bnd
+      printf("\tduk_push_int(ctx, priv->value%d);\n", i) > bnd
+      printf("\treturn 1;\n%%}\n\n") > bnd
+
+      printf("method BenchInterface%d::iface%dOp0()\n%%{\n", i, i) > bnd
+      printf("\treturn 0;\n%%}\n\n") > bnd
+    }
+  }
+}
+'
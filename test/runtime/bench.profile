@@ -0,0 +1,12 @@
+# Call frequency profile of the runtime benchmark
+#
+# Generate the benchmark bindings with --profile-use=bench.profile to
+# mark the functions it exercises hot and the rest cold.
+BenchElement::width getter 1000000
+BenchElement::width setter 1000000
+BenchNode::add method 1000000
+BenchNode::mode method 1000000
+BenchElement::area getter 1000000
+BenchElement::onbench getter 1000000
+BenchElement constructor 1000000
+BenchElement finalizer 1000000
@@ -0,0 +1,1651 @@
+/* stub duktape implementation for the runtime benchmark harness
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ *
+ * There is no interpreter. Values live on a value stack with call
+ * frames, strings are interned so property keys compare by pointer,
+ * objects are reference counted and finalizers are run when the last
+ * reference goes away just as duktape does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <setjmp.h>
+
+#include "duktape.h"
+
+struct duk_hobject;
+
+/** tagged value */
+typedef struct {
+        int type; /**< DUK_TYPE_ */
+        union {
+                duk_bool_t b;
+                duk_double_t n;
+                const char *s; /**< interned string */
+                void *p;
+                struct duk_hobject *o;
+        } u;
+} duk_tval;
+
+/** object property */
+struct duk_prop {
+        const char *key; /**< interned key */
+        duk_uint_t flags;
+        duk_tval value;
+        struct duk_hobject *getter;
+        struct duk_hobject *setter;
+};
+
+/** object */
+struct duk_hobject {
+        unsigned long refcount;
+        int finalized;
+
+        struct duk_hobject *proto;
+        struct duk_hobject *finalizer;
+
+        struct duk_hobject *target; /**< proxy target or NULL */
+        struct duk_hobject *handler; /**< proxy handler or NULL */
+
+        duk_c_function func; /**< native function or NULL */
+        duk_int_t nargs; /**< number of arguments or DUK_VARARGS */
+
+        int propc;
+        int propalloc;
+        struct duk_prop *propv;
+};
+
+/** error catch point */
+struct duk_catcher {
+        jmp_buf env;
+        struct duk_catcher *prev;
+};
+
+/** heap and thread context */
+struct duk_hthread {
+        duk_tval *stack;
+        duk_idx_t size; /**< allocated size of stack */
+        duk_idx_t top; /**< absolute index of first unused entry */
+        duk_idx_t bottom; /**< absolute index of current frame bottom */
+        duk_tval this_binding; /**< this of current frame */
+
+        struct duk_hobject *global;
+        struct duk_hobject *stash; /**< global stash */
+
+        struct duk_catcher *catcher;
+        const char *error; /**< message of error being thrown */
+
+        /* string intern table (open addressing) */
+        char **strtab;
+        size_t strtab_size;
+        size_t strtab_used;
+
+        unsigned long live; /**< number of live objects */
+};
+
+static void fatal(const char *msg)
+{
+        fprintf(stderr, "stub duktape: fatal: %s\n", msg);
+        abort();
+}
+
+/* string interning */
+
+static unsigned long str_hash(const char *str, size_t len)
+{
+        unsigned long hash = 2166136261UL;
+        size_t idx;
+
+        for (idx = 0; idx < len; idx++) {
+                hash = (hash ^ (unsigned char)str[idx]) * 16777619UL;
+        }
+        return hash;
+}
+
+static void strtab_grow(duk_context *ctx)
+{
+        char **old = ctx->strtab;
+        size_t oldsize = ctx->strtab_size;
+        size_t idx;
+
+        ctx->strtab_size = (oldsize == 0) ? 256 : oldsize * 2;
+        ctx->strtab = calloc(ctx->strtab_size, sizeof(char *));
+        if (ctx->strtab == NULL) {
+                fatal("out of memory");
+        }
+
+        for (idx = 0; idx < oldsize; idx++) {
+                if (old[idx] != NULL) {
+                        size_t slot;
+                        slot = str_hash(old[idx], strlen(old[idx])) &
+                                (ctx->strtab_size - 1);
+                        while (ctx->strtab[slot] != NULL) {
+                                slot = (slot + 1) & (ctx->strtab_size - 1);
+                        }
+                        ctx->strtab[slot] = old[idx];
+                }
+        }
+        free(old);
+}
+
+static const char *intern(duk_context *ctx, const char *str, size_t len)
+{
+        size_t slot;
+        char *s;
+
+        if ((ctx->strtab_used * 2) >= ctx->strtab_size) {
+                strtab_grow(ctx);
+        }
+
+        slot = str_hash(str, len) & (ctx->strtab_size - 1);
+        while (ctx->strtab[slot] != NULL) {
+                s = ctx->strtab[slot];
+                if ((strncmp(s, str, len) == 0) && (s[len] == 0)) {
+                        return s;
+                }
+                slot = (slot + 1) & (ctx->strtab_size - 1);
+        }
+
+        s = malloc(len + 1);
+        if (s == NULL) {
+                fatal("out of memory");
+        }
+        memcpy(s, str, len);
+        s[len] = 0;
+        ctx->strtab[slot] = s;
+        ctx->strtab_used++;
+
+        return s;
+}
+
+/* reference counting */
+
+static void obj_decref(duk_context *ctx, struct duk_hobject *obj);
+
+static void obj_incref(struct duk_hobject *obj)
+{
+        if (obj != NULL) {
+                obj->refcount++;
+        }
+}
+
+static void tval_incref(duk_tval *tv)
+{
+        if (tv->type == DUK_TYPE_OBJECT) {
+                obj_incref(tv->u.o);
+        }
+}
+
+static void tval_decref(duk_context *ctx, duk_tval *tv)
+{
+        if (tv->type == DUK_TYPE_OBJECT) {
+                obj_decref(ctx, tv->u.o);
+        }
+}
+
+static struct duk_hobject *find_finalizer(struct duk_hobject *obj)
+{
+        while (obj != NULL) {
+                if (obj->finalizer != NULL) {
+                        return obj->finalizer;
+                }
+                obj = obj->proto;
+        }
+        return NULL;
+}
+
+static void push_tval(duk_context *ctx, duk_tval *tv);
+
+static void obj_free(duk_context *ctx, struct duk_hobject *obj)
+{
+        int idx;
+
+        for (idx = 0; idx < obj->propc; idx++) {
+                tval_decref(ctx, &obj->propv[idx].value);
+                if (obj->propv[idx].getter != NULL) {
+                        obj_decref(ctx, obj->propv[idx].getter);
+                }
+                if (obj->propv[idx].setter != NULL) {
+                        obj_decref(ctx, obj->propv[idx].setter);
+                }
+        }
+        free(obj->propv);
+
+        if (obj->proto != NULL) {
+                obj_decref(ctx, obj->proto);
+        }
+        if (obj->finalizer != NULL) {
+                obj_decref(ctx, obj->finalizer);
+        }
+        if (obj->target != NULL) {
+                obj_decref(ctx, obj->target);
+        }
+        if (obj->handler != NULL) {
+                obj_decref(ctx, obj->handler);
+        }
+
+        free(obj);
+        ctx->live--;
+}
+
+static void obj_decref(duk_context *ctx, struct duk_hobject *obj)
+{
+        struct duk_hobject *fin;
+        duk_tval tv;
+
+        if (--obj->refcount > 0) {
+                return;
+        }
+
+        if (!obj->finalized) {
+                fin = find_finalizer(obj);
+                if (fin != NULL) {
+                        obj->finalized = 1;
+                        /* hold a reference over the finalizer call */
+                        obj->refcount = 1;
+
+                        tv.type = DUK_TYPE_OBJECT;
+                        tv.u.o = fin;
+                        push_tval(ctx, &tv);
+                        tv.u.o = obj;
+                        push_tval(ctx, &tv);
+                        duk_call(ctx, 1);
+                        duk_pop(ctx);
+
+                        if (--obj->refcount > 0) {
+                                /* rescued by the finalizer */
+                                return;
+                        }
+                }
+        }
+
+        obj_free(ctx, obj);
+}
+
+static struct duk_hobject *obj_new(duk_context *ctx)
+{
+        struct duk_hobject *obj;
+
+        obj = calloc(1, sizeof(*obj));
+        if (obj == NULL) {
+                fatal("out of memory");
+        }
+        ctx->live++;
+        return obj;
+}
+
+/* value stack */
+
+static duk_idx_t resolve(duk_context *ctx, duk_idx_t idx)
+{
+        duk_idx_t abs;
+
+        if (idx < 0) {
+                abs = ctx->top + idx;
+        } else {
+                abs = ctx->bottom + idx;
+        }
+        if ((abs < ctx->bottom) || (abs >= ctx->top)) {
+                fatal("invalid stack index");
+        }
+        return abs;
+}
+
+static duk_tval *get_tval(duk_context *ctx, duk_idx_t idx)
+{
+        return &ctx->stack[resolve(ctx, idx)];
+}
+
+/* push a value taking a new reference */
+static void push_tval(duk_context *ctx, duk_tval *tv)
+{
+        duk_tval copy = *tv; /* tv may be on the stack being resized */
+
+        if (ctx->top == ctx->size) {
+                ctx->size = (ctx->size == 0) ? 64 : ctx->size * 2;
+                ctx->stack = realloc(ctx->stack, ctx->size * sizeof(duk_tval));
+                if (ctx->stack == NULL) {
+                        fatal("out of memory");
+                }
+        }
+        tval_incref(&copy);
+        ctx->stack[ctx->top++] = copy;
+}
+
+/* pop values down to an absolute index dropping their references */
+static void unwind(duk_context *ctx, duk_idx_t abs)
+{
+        duk_tval tv;
+
+        while (ctx->top > abs) {
+                tv = ctx->stack[--ctx->top];
+                tval_decref(ctx, &tv);
+        }
+}
+
+static duk_tval *get_object_tval(duk_context *ctx, duk_idx_t idx)
+{
+        duk_tval *tv = get_tval(ctx, idx);
+
+        if (tv->type != DUK_TYPE_OBJECT) {
+                duk_error(ctx, DUK_ERR_TYPE_ERROR, "not an object");
+        }
+        return tv;
+}
+
+/* exported interface documented in duktape.h */
+duk_context *duk_create_heap_default(void)
+{
+        duk_context *ctx;
+
+        ctx = calloc(1, sizeof(*ctx));
+        if (ctx == NULL) {
+                return NULL;
+        }
+        ctx->this_binding.type = DUK_TYPE_UNDEFINED;
+        ctx->global = obj_new(ctx);
+        ctx->global->refcount = 1;
+        ctx->stash = obj_new(ctx);
+        ctx->stash->refcount = 1;
+
+        return ctx;
+}
+
+/* exported interface documented in duktape.h */
+void duk_destroy_heap(duk_context *ctx)
+{
+        size_t idx;
+
+        ctx->bottom = 0;
+        unwind(ctx, 0);
+        obj_decref(ctx, ctx->global);
+        obj_decref(ctx, ctx->stash);
+
+        for (idx = 0; idx < ctx->strtab_size; idx++) {
+                free(ctx->strtab[idx]);
+        }
+        free(ctx->strtab);
+        free(ctx->stack);
+        free(ctx);
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t duk_get_top(duk_context *ctx)
+{
+        return ctx->top - ctx->bottom;
+}
+
+/* exported interface documented in duktape.h */
+void duk_set_top(duk_context *ctx, duk_idx_t idx)
+{
+        duk_idx_t abs = ctx->bottom + idx;
+        duk_tval tv;
+
+        if (idx < 0) {
+                fatal("invalid stack top");
+        }
+        tv.type = DUK_TYPE_UNDEFINED;
+        while (ctx->top < abs) {
+                push_tval(ctx, &tv);
+        }
+        unwind(ctx, abs);
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t duk_normalize_index(duk_context *ctx, duk_idx_t idx)
+{
+        return resolve(ctx, idx) - ctx->bottom;
+}
+
+/* exported interface documented in duktape.h */
+void duk_pop(duk_context *ctx)
+{
+        duk_pop_n(ctx, 1);
+}
+
+/* exported interface documented in duktape.h */
+void duk_pop_2(duk_context *ctx)
+{
+        duk_pop_n(ctx, 2);
+}
+
+/* exported interface documented in duktape.h */
+void duk_pop_3(duk_context *ctx)
+{
+        duk_pop_n(ctx, 3);
+}
+
+/* exported interface documented in duktape.h */
+void duk_pop_n(duk_context *ctx, duk_idx_t count)
+{
+        if ((ctx->top - count) < ctx->bottom) {
+                fatal("stack underflow");
+        }
+        unwind(ctx, ctx->top - count);
+}
+
+/* exported interface documented in duktape.h */
+void duk_dup(duk_context *ctx, duk_idx_t idx)
+{
+        push_tval(ctx, get_tval(ctx, idx));
+}
+
+/* exported interface documented in duktape.h */
+void duk_replace(duk_context *ctx, duk_idx_t idx)
+{
+        duk_idx_t abs = resolve(ctx, idx);
+        duk_tval old;
+
+        old = ctx->stack[abs];
+        ctx->stack[abs] = ctx->stack[--ctx->top];
+        tval_decref(ctx, &old);
+}
+
+/* exported interface documented in duktape.h */
+void duk_insert(duk_context *ctx, duk_idx_t idx)
+{
+        duk_idx_t abs = resolve(ctx, idx);
+        duk_tval tv;
+
+        tv = ctx->stack[ctx->top - 1];
+        memmove(&ctx->stack[abs + 1], &ctx->stack[abs],
+                (ctx->top - 1 - abs) * sizeof(duk_tval));
+        ctx->stack[abs] = tv;
+}
+
+/* exported interface documented in duktape.h */
+void duk_remove(duk_context *ctx, duk_idx_t idx)
+{
+        duk_idx_t abs = resolve(ctx, idx);
+        duk_tval tv;
+
+        tv = ctx->stack[abs];
+        memmove(&ctx->stack[abs], &ctx->stack[abs + 1],
+                (ctx->top - 1 - abs) * sizeof(duk_tval));
+        ctx->top--;
+        tval_decref(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_undefined(duk_context *ctx)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_UNDEFINED;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_null(duk_context *ctx)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_NULL;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_boolean(duk_context *ctx, duk_bool_t val)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_BOOLEAN;
+        tv.u.b = val ? 1 : 0;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_int(duk_context *ctx, duk_int_t val)
+{
+        duk_push_number(ctx, val);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_uint(duk_context *ctx, duk_uint_t val)
+{
+        duk_push_number(ctx, val);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_number(duk_context *ctx, duk_double_t val)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_NUMBER;
+        tv.u.n = val;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_push_string(duk_context *ctx, const char *str)
+{
+        if (str == NULL) {
+                duk_push_null(ctx);
+                return NULL;
+        }
+        return duk_push_lstring(ctx, str, strlen(str));
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_push_lstring(duk_context *ctx, const char *str, size_t len)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_STRING;
+        tv.u.s = intern(ctx, str, len);
+        push_tval(ctx, &tv);
+        return tv.u.s;
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_pointer(duk_context *ctx, void *ptr)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_POINTER;
+        tv.u.p = ptr;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t duk_push_object(duk_context *ctx)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = obj_new(ctx);
+        push_tval(ctx, &tv);
+        return duk_get_top(ctx) - 1;
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t duk_push_array(duk_context *ctx)
+{
+        return duk_push_object(ctx);
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t
+duk_push_c_function(duk_context *ctx, duk_c_function func, duk_int_t nargs)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = obj_new(ctx);
+        tv.u.o->func = func;
+        tv.u.o->nargs = nargs;
+        push_tval(ctx, &tv);
+        return duk_get_top(ctx) - 1;
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_this(duk_context *ctx)
+{
+        push_tval(ctx, &ctx->this_binding);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_global_object(duk_context *ctx)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = ctx->global;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+void duk_push_global_stash(duk_context *ctx)
+{
+        duk_tval tv;
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = ctx->stash;
+        push_tval(ctx, &tv);
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t duk_push_proxy(duk_context *ctx, duk_uint_t proxy_flags)
+{
+        struct duk_hobject *proxy;
+        duk_tval tv;
+
+        (void)proxy_flags;
+
+        proxy = obj_new(ctx);
+        proxy->target = get_object_tval(ctx, -2)->u.o;
+        proxy->handler = get_object_tval(ctx, -1)->u.o;
+        obj_incref(proxy->target);
+        obj_incref(proxy->handler);
+        duk_pop_2(ctx);
+
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = proxy;
+        push_tval(ctx, &tv);
+        return duk_get_top(ctx) - 1;
+}
+
+/* exported interface documented in duktape.h */
+duk_idx_t duk_push_heapptr(duk_context *ctx, void *ptr)
+{
+        duk_tval tv;
+        if (ptr == NULL) {
+                tv.type = DUK_TYPE_UNDEFINED;
+        } else {
+                tv.type = DUK_TYPE_OBJECT;
+                tv.u.o = ptr;
+        }
+        push_tval(ctx, &tv);
+        return duk_get_top(ctx) - 1;
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t duk_get_type(duk_context *ctx, duk_idx_t idx)
+{
+        duk_idx_t abs = (idx < 0) ? ctx->top + idx : ctx->bottom + idx;
+
+        if ((abs < ctx->bottom) || (abs >= ctx->top)) {
+                return DUK_TYPE_NONE;
+        }
+        return ctx->stack[abs].type;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_check_type(duk_context *ctx, duk_idx_t idx, duk_int_t type)
+{
+        return duk_get_type(ctx, idx) == type;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_undefined(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_UNDEFINED;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_null(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_NULL;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_null_or_undefined(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_is_null(ctx, idx) || duk_is_undefined(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_boolean(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_BOOLEAN;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_number(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_NUMBER;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_string(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_STRING;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_object(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_OBJECT;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_pointer(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_get_type(ctx, idx) == DUK_TYPE_POINTER;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_is_function(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_is_object(ctx, idx) &&
+                (get_tval(ctx, idx)->u.o->func != NULL);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_strict_equals(duk_context *ctx, duk_idx_t idx1, duk_idx_t idx2)
+{
+        duk_tval *a;
+        duk_tval *b;
+
+        if ((duk_get_type(ctx, idx1) == DUK_TYPE_NONE) ||
+            (duk_get_type(ctx, idx2) == DUK_TYPE_NONE)) {
+                return 0;
+        }
+
+        a = get_tval(ctx, idx1);
+        b = get_tval(ctx, idx2);
+        if (a->type != b->type) {
+                return 0;
+        }
+
+        switch (a->type) {
+        case DUK_TYPE_BOOLEAN:
+                return a->u.b == b->u.b;
+        case DUK_TYPE_NUMBER:
+                return a->u.n == b->u.n;
+        case DUK_TYPE_STRING:
+                return a->u.s == b->u.s;
+        case DUK_TYPE_POINTER:
+                return a->u.p == b->u.p;
+        case DUK_TYPE_OBJECT:
+                return a->u.o == b->u.o;
+        default:
+                return 1;
+        }
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_get_boolean(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_boolean(ctx, idx)) {
+                return 0;
+        }
+        return get_tval(ctx, idx)->u.b;
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t duk_get_int(duk_context *ctx, duk_idx_t idx)
+{
+        return (duk_int_t)duk_get_number(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+duk_uint_t duk_get_uint(duk_context *ctx, duk_idx_t idx)
+{
+        duk_double_t val = duk_get_number(ctx, idx);
+        return (val < 0) ? 0 : (duk_uint_t)val;
+}
+
+/* exported interface documented in duktape.h */
+duk_double_t duk_get_number(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_number(ctx, idx)) {
+                return 0;
+        }
+        return get_tval(ctx, idx)->u.n;
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_get_string(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_string(ctx, idx)) {
+                return NULL;
+        }
+        return get_tval(ctx, idx)->u.s;
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_get_lstring(duk_context *ctx, duk_idx_t idx, duk_size_t *len)
+{
+        const char *str = duk_get_string(ctx, idx);
+
+        if (len != NULL) {
+                *len = (str == NULL) ? 0 : strlen(str);
+        }
+        return str;
+}
+
+/* exported interface documented in duktape.h */
+void *duk_get_pointer(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_pointer(ctx, idx)) {
+                return NULL;
+        }
+        return get_tval(ctx, idx)->u.p;
+}
+
+/* exported interface documented in duktape.h */
+void *duk_get_heapptr(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_object(ctx, idx)) {
+                return NULL;
+        }
+        return get_tval(ctx, idx)->u.o;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_require_boolean(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_boolean(ctx, idx)) {
+                duk_error(ctx, DUK_ERR_TYPE_ERROR, "boolean required");
+        }
+        return duk_get_boolean(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t duk_require_int(duk_context *ctx, duk_idx_t idx)
+{
+        return (duk_int_t)duk_require_number(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+duk_double_t duk_require_number(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_number(ctx, idx)) {
+                duk_error(ctx, DUK_ERR_TYPE_ERROR, "number required");
+        }
+        return duk_get_number(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_require_string(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_string(ctx, idx)) {
+                duk_error(ctx, DUK_ERR_TYPE_ERROR, "string required");
+        }
+        return duk_get_string(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+void *duk_require_pointer(duk_context *ctx, duk_idx_t idx)
+{
+        if (!duk_is_pointer(ctx, idx)) {
+                duk_error(ctx, DUK_ERR_TYPE_ERROR, "pointer required");
+        }
+        return duk_get_pointer(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+duk_size_t duk_get_length(duk_context *ctx, duk_idx_t idx)
+{
+        duk_tval *tv = get_tval(ctx, idx);
+        duk_size_t length = 0;
+        duk_size_t index;
+        const char *key;
+        char *end;
+        int pidx;
+
+        if (tv->type == DUK_TYPE_STRING) {
+                return strlen(tv->u.s);
+        }
+        if (tv->type != DUK_TYPE_OBJECT) {
+                return 0;
+        }
+
+        /* there is no array part, the length follows the index keys */
+        for (pidx = 0; pidx < tv->u.o->propc; pidx++) {
+                key = tv->u.o->propv[pidx].key;
+                if ((*key < '0') || (*key > '9')) {
+                        continue;
+                }
+                index = strtoul(key, &end, 10);
+                if ((*end == 0) && (index >= length)) {
+                        length = index + 1;
+                }
+        }
+        return length;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_to_boolean(duk_context *ctx, duk_idx_t idx)
+{
+        duk_tval *tv = get_tval(ctx, idx);
+        duk_bool_t res;
+
+        switch (tv->type) {
+        case DUK_TYPE_BOOLEAN:
+                res = tv->u.b;
+                break;
+        case DUK_TYPE_NUMBER:
+                res = (tv->u.n != 0) && (tv->u.n == tv->u.n);
+                break;
+        case DUK_TYPE_STRING:
+                res = (tv->u.s[0] != 0);
+                break;
+        case DUK_TYPE_OBJECT:
+        case DUK_TYPE_POINTER:
+                res = 1;
+                break;
+        default:
+                res = 0;
+                break;
+        }
+        tval_decref(ctx, tv);
+        tv->type = DUK_TYPE_BOOLEAN;
+        tv->u.b = res;
+        return res;
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t duk_to_int(duk_context *ctx, duk_idx_t idx)
+{
+        duk_tval *tv = get_tval(ctx, idx);
+        duk_double_t res;
+
+        switch (tv->type) {
+        case DUK_TYPE_BOOLEAN:
+                res = tv->u.b;
+                break;
+        case DUK_TYPE_NUMBER:
+                res = tv->u.n;
+                break;
+        case DUK_TYPE_STRING:
+                res = strtod(tv->u.s, NULL);
+                break;
+        default:
+                res = 0;
+                break;
+        }
+        tval_decref(ctx, tv);
+        tv->type = DUK_TYPE_NUMBER;
+        tv->u.n = (duk_int_t)res;
+        return (duk_int_t)res;
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_to_string(duk_context *ctx, duk_idx_t idx)
+{
+        duk_tval *tv = get_tval(ctx, idx);
+        char buf[64];
+        const char *str;
+
+        switch (tv->type) {
+        case DUK_TYPE_STRING:
+                return tv->u.s;
+        case DUK_TYPE_UNDEFINED:
+                str = "undefined";
+                break;
+        case DUK_TYPE_NULL:
+                str = "null";
+                break;
+        case DUK_TYPE_BOOLEAN:
+                str = tv->u.b ? "true" : "false";
+                break;
+        case DUK_TYPE_NUMBER:
+                snprintf(buf, sizeof(buf), "%.17g", tv->u.n);
+                str = buf;
+                break;
+        case DUK_TYPE_POINTER:
+                snprintf(buf, sizeof(buf), "%p", tv->u.p);
+                str = buf;
+                break;
+        default:
+                str = "[object Object]";
+                break;
+        }
+        str = intern(ctx, str, strlen(str));
+
+        tv = get_tval(ctx, idx);
+        tval_decref(ctx, tv);
+        tv = get_tval(ctx, idx);
+        tv->type = DUK_TYPE_STRING;
+        tv->u.s = str;
+        return str;
+}
+
+/* exported interface documented in duktape.h */
+const char *duk_safe_to_string(duk_context *ctx, duk_idx_t idx)
+{
+        return duk_to_string(ctx, idx);
+}
+
+/* exported interface documented in duktape.h */
+void duk_concat(duk_context *ctx, duk_idx_t count)
+{
+        size_t len = 0;
+        duk_idx_t idx;
+        char *buf;
+
+        for (idx = -count; idx < 0; idx++) {
+                len += strlen(duk_to_string(ctx, idx));
+        }
+        buf = malloc(len + 1);
+        if (buf == NULL) {
+                fatal("out of memory");
+        }
+        buf[0] = 0;
+        for (idx = -count; idx < 0; idx++) {
+                strcat(buf, duk_get_string(ctx, idx));
+        }
+        duk_pop_n(ctx, count);
+        duk_push_lstring(ctx, buf, len);
+        free(buf);
+}
+
+/* properties */
+
+static struct duk_prop *
+find_own_prop(struct duk_hobject *obj, const char *key)
+{
+        int idx;
+
+        for (idx = 0; idx < obj->propc; idx++) {
+                if (obj->propv[idx].key == key) {
+                        return &obj->propv[idx];
+                }
+        }
+        return NULL;
+}
+
+static struct duk_prop *find_prop(struct duk_hobject *obj, const char *key)
+{
+        struct duk_prop *prop;
+
+        while (obj != NULL) {
+                prop = find_own_prop(obj, key);
+                if (prop != NULL) {
+                        return prop;
+                }
+                obj = obj->proto;
+        }
+        return NULL;
+}
+
+static struct duk_prop *add_own_prop(struct duk_hobject *obj, const char *key)
+{
+        struct duk_prop *prop;
+
+        if (obj->propc == obj->propalloc) {
+                obj->propalloc = (obj->propalloc == 0) ? 8 : obj->propalloc * 2;
+                obj->propv = realloc(obj->propv,
+                                     obj->propalloc * sizeof(struct duk_prop));
+                if (obj->propv == NULL) {
+                        fatal("out of memory");
+                }
+        }
+        prop = &obj->propv[obj->propc++];
+        memset(prop, 0, sizeof(*prop));
+        prop->key = key;
+        prop->value.type = DUK_TYPE_UNDEFINED;
+        prop->flags = DUK_DEFPROP_WRITABLE |
+                DUK_DEFPROP_ENUMERABLE |
+                DUK_DEFPROP_CONFIGURABLE;
+        return prop;
+}
+
+/*
+ * push the handler trap for an operation on a proxy
+ *
+ * Hidden keys and operations without a trap go to the target. On success
+ * the stack holds the trap, handler, target and key ready for the call.
+ */
+static int
+proxy_trap(duk_context *ctx,
+           struct duk_hobject *proxy,
+           const char *trap,
+           const char *key)
+{
+        struct duk_prop *prop;
+        duk_tval tv;
+
+        if ((unsigned char)key[0] == 0xff) {
+                return 0;
+        }
+
+        prop = find_prop(proxy->handler, intern(ctx, trap, strlen(trap)));
+        if ((prop == NULL) || (prop->value.type != DUK_TYPE_OBJECT)) {
+                return 0;
+        }
+
+        push_tval(ctx, &prop->value);
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = proxy->handler;
+        push_tval(ctx, &tv);
+        tv.u.o = proxy->target;
+        push_tval(ctx, &tv);
+        duk_push_string(ctx, key);
+        return 1;
+}
+
+/* the object operations on a proxy without a trap apply to */
+static struct duk_hobject *proxy_target(struct duk_hobject *obj)
+{
+        while (obj->handler != NULL) {
+                obj = obj->target;
+        }
+        return obj;
+}
+
+/* call an accessor with the object at an absolute index as this */
+static void
+call_accessor(duk_context *ctx,
+              struct duk_hobject *func,
+              duk_idx_t this_abs,
+              int nargs)
+{
+        duk_tval tv;
+
+        tv.type = DUK_TYPE_OBJECT;
+        tv.u.o = func;
+        push_tval(ctx, &tv);
+        duk_insert(ctx, -1 - nargs);
+        push_tval(ctx, &ctx->stack[this_abs]);
+        duk_insert(ctx, -1 - nargs);
+        duk_call_method(ctx, nargs);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t
+duk_get_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key)
+{
+        duk_idx_t abs = resolve(ctx, obj_idx);
+        struct duk_hobject *obj;
+        struct duk_prop *prop;
+
+        if (ctx->stack[abs].type != DUK_TYPE_OBJECT) {
+                duk_push_undefined(ctx);
+                return 0;
+        }
+
+        obj = ctx->stack[abs].u.o;
+        if (obj->handler != NULL) {
+                if (proxy_trap(ctx, obj, "get", key)) {
+                        /* receiver */
+                        push_tval(ctx, &ctx->stack[abs]);
+                        duk_call_method(ctx, 3);
+                        return !duk_is_undefined(ctx, -1);
+                }
+                obj = proxy_target(obj);
+        }
+
+        key = intern(ctx, key, strlen(key));
+        prop = find_prop(obj, key);
+        if (prop == NULL) {
+                duk_push_undefined(ctx);
+                return 0;
+        }
+
+        if (prop->getter != NULL) {
+                call_accessor(ctx, prop->getter, abs, 0);
+        } else if (prop->setter != NULL) {
+                duk_push_undefined(ctx);
+        } else {
+                push_tval(ctx, &prop->value);
+        }
+        return 1;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t
+duk_put_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key)
+{
+        duk_idx_t abs = resolve(ctx, obj_idx);
+        struct duk_hobject *obj;
+        struct duk_prop *prop;
+        duk_tval old;
+
+        obj = proxy_target(get_object_tval(ctx, obj_idx)->u.o);
+
+        key = intern(ctx, key, strlen(key));
+        prop = find_prop(obj, key);
+        if ((prop != NULL) &&
+            ((prop->getter != NULL) || (prop->setter != NULL))) {
+                if (prop->setter == NULL) {
+                        duk_pop(ctx);
+                        return 0;
+                }
+                call_accessor(ctx, prop->setter, abs, 1);
+                duk_pop(ctx);
+                return 1;
+        }
+
+        prop = find_own_prop(obj, key);
+        if (prop == NULL) {
+                prop = add_own_prop(obj, key);
+        }
+        old = prop->value;
+        prop->value = ctx->stack[--ctx->top];
+        tval_decref(ctx, &old);
+        return 1;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t
+duk_del_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key)
+{
+        struct duk_hobject *obj;
+        struct duk_prop *prop;
+        struct duk_prop old;
+
+        obj = proxy_target(get_object_tval(ctx, obj_idx)->u.o);
+        key = intern(ctx, key, strlen(key));
+        prop = find_own_prop(obj, key);
+        if (prop == NULL) {
+                return 1;
+        }
+
+        old = *prop;
+        *prop = obj->propv[--obj->propc];
+
+        tval_decref(ctx, &old.value);
+        if (old.getter != NULL) {
+                obj_decref(ctx, old.getter);
+        }
+        if (old.setter != NULL) {
+                obj_decref(ctx, old.setter);
+        }
+        return 1;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t
+duk_has_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key)
+{
+        struct duk_hobject *obj;
+        duk_bool_t res;
+
+        obj = get_object_tval(ctx, obj_idx)->u.o;
+        if (obj->handler != NULL) {
+                if (proxy_trap(ctx, obj, "has", key)) {
+                        duk_call_method(ctx, 2);
+                        res = duk_to_boolean(ctx, -1);
+                        duk_pop(ctx);
+                        return res;
+                }
+                obj = proxy_target(obj);
+        }
+        key = intern(ctx, key, strlen(key));
+        return find_prop(obj, key) != NULL;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_get_prop(duk_context *ctx, duk_idx_t obj_idx)
+{
+        duk_idx_t abs = resolve(ctx, obj_idx);
+        const char *key;
+
+        /* keys are coerced to strings before any proxy trap sees them */
+        key = duk_to_string(ctx, -1);
+        duk_pop(ctx);
+        return duk_get_prop_string(ctx, abs - ctx->bottom, key);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_has_prop(duk_context *ctx, duk_idx_t obj_idx)
+{
+        duk_idx_t abs = resolve(ctx, obj_idx);
+        const char *key;
+
+        key = duk_to_string(ctx, -1);
+        duk_pop(ctx);
+        return duk_has_prop_string(ctx, abs - ctx->bottom, key);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t
+duk_get_prop_index(duk_context *ctx, duk_idx_t obj_idx, duk_uint_t arr_idx)
+{
+        char key[32];
+
+        snprintf(key, sizeof(key), "%u", arr_idx);
+        return duk_get_prop_string(ctx, obj_idx, key);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t
+duk_put_prop_index(duk_context *ctx, duk_idx_t obj_idx, duk_uint_t arr_idx)
+{
+        char key[32];
+
+        snprintf(key, sizeof(key), "%u", arr_idx);
+        return duk_put_prop_string(ctx, obj_idx, key);
+}
+
+/* exported interface documented in duktape.h */
+void duk_def_prop(duk_context *ctx, duk_idx_t obj_idx, duk_uint_t flags)
+{
+        struct duk_hobject *obj;
+        struct duk_prop *prop;
+        duk_idx_t count = 1;
+        duk_idx_t key_abs;
+        const char *key;
+        duk_tval tv;
+
+        obj = get_object_tval(ctx, obj_idx)->u.o;
+
+        if (flags & DUK_DEFPROP_HAVE_VALUE) count++;
+        if (flags & DUK_DEFPROP_HAVE_GETTER) count++;
+        if (flags & DUK_DEFPROP_HAVE_SETTER) count++;
+
+        key_abs = ctx->top - count;
+        key = duk_to_string(ctx, key_abs - ctx->bottom);
+
+        prop = find_own_prop(obj, key);
+        if (prop == NULL) {
+                prop = add_own_prop(obj, key);
+        }
+
+        if (flags & DUK_DEFPROP_HAVE_WRITABLE) {
+                prop->flags = (prop->flags & ~DUK_DEFPROP_WRITABLE) |
+                        (flags & DUK_DEFPROP_WRITABLE);
+        }
+        if (flags & DUK_DEFPROP_HAVE_ENUMERABLE) {
+                prop->flags = (prop->flags & ~DUK_DEFPROP_ENUMERABLE) |
+                        (flags & DUK_DEFPROP_ENUMERABLE);
+        }
+        if (flags & DUK_DEFPROP_HAVE_CONFIGURABLE) {
+                prop->flags = (prop->flags & ~DUK_DEFPROP_CONFIGURABLE) |
+                        (flags & DUK_DEFPROP_CONFIGURABLE);
+        }
+
+        key_abs++;
+        if (flags & DUK_DEFPROP_HAVE_VALUE) {
+                tv = prop->value;
+                prop->value = ctx->stack[key_abs++];
+                tval_incref(&prop->value);
+                tval_decref(ctx, &tv);
+        }
+        if (flags & DUK_DEFPROP_HAVE_GETTER) {
+                if (prop->getter != NULL) {
+                        obj_decref(ctx, prop->getter);
+                }
+                prop->getter = ctx->stack[key_abs++].u.o;
+                obj_incref(prop->getter);
+        }
+        if (flags & DUK_DEFPROP_HAVE_SETTER) {
+                if (prop->setter != NULL) {
+                        obj_decref(ctx, prop->setter);
+                }
+                prop->setter = ctx->stack[key_abs++].u.o;
+                obj_incref(prop->setter);
+        }
+
+        duk_pop_n(ctx, count);
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_get_global_string(duk_context *ctx, const char *key)
+{
+        duk_bool_t res;
+
+        duk_push_global_object(ctx);
+        res = duk_get_prop_string(ctx, -1, key);
+        duk_remove(ctx, -2);
+        return res;
+}
+
+/* exported interface documented in duktape.h */
+duk_bool_t duk_put_global_string(duk_context *ctx, const char *key)
+{
+        duk_bool_t res;
+
+        duk_push_global_object(ctx);
+        duk_insert(ctx, -2);
+        res = duk_put_prop_string(ctx, -2, key);
+        duk_pop(ctx);
+        return res;
+}
+
+/* exported interface documented in duktape.h */
+void duk_get_prototype(duk_context *ctx, duk_idx_t idx)
+{
+        struct duk_hobject *obj;
+        duk_tval tv;
+
+        obj = get_object_tval(ctx, idx)->u.o;
+        if (obj->proto == NULL) {
+                duk_push_undefined(ctx);
+        } else {
+                tv.type = DUK_TYPE_OBJECT;
+                tv.u.o = obj->proto;
+                push_tval(ctx, &tv);
+        }
+}
+
+/* exported interface documented in duktape.h */
+void duk_set_prototype(duk_context *ctx, duk_idx_t idx)
+{
+        struct duk_hobject *obj;
+        struct duk_hobject *old;
+        duk_tval *tv;
+
+        obj = get_object_tval(ctx, idx)->u.o;
+        old = obj->proto;
+
+        tv = get_tval(ctx, -1);
+        if (tv->type == DUK_TYPE_OBJECT) {
+                obj->proto = tv->u.o;
+                obj_incref(obj->proto);
+        } else {
+                obj->proto = NULL;
+        }
+        duk_pop(ctx);
+
+        if (old != NULL) {
+                obj_decref(ctx, old);
+        }
+}
+
+/* exported interface documented in duktape.h */
+void duk_get_finalizer(duk_context *ctx, duk_idx_t idx)
+{
+        struct duk_hobject *fin;
+        duk_tval tv;
+
+        fin = find_finalizer(get_object_tval(ctx, idx)->u.o);
+        if (fin == NULL) {
+                duk_push_undefined(ctx);
+        } else {
+                tv.type = DUK_TYPE_OBJECT;
+                tv.u.o = fin;
+                push_tval(ctx, &tv);
+        }
+}
+
+/* exported interface documented in duktape.h */
+void duk_set_finalizer(duk_context *ctx, duk_idx_t idx)
+{
+        struct duk_hobject *obj;
+        struct duk_hobject *old;
+        duk_tval *tv;
+
+        obj = get_object_tval(ctx, idx)->u.o;
+        old = obj->finalizer;
+
+        tv = get_tval(ctx, -1);
+        if (tv->type == DUK_TYPE_OBJECT) {
+                obj->finalizer = tv->u.o;
+                obj_incref(obj->finalizer);
+        } else {
+                obj->finalizer = NULL;
+        }
+        duk_pop(ctx);
+
+        if (old != NULL) {
+                obj_decref(ctx, old);
+        }
+}
+
+/* calls */
+
+static void call_common(duk_context *ctx, duk_idx_t nargs, int has_this)
+{
+        duk_idx_t func_abs = ctx->top - nargs - 1 - has_this;
+        duk_idx_t saved_bottom = ctx->bottom;
+        duk_tval saved_this = ctx->this_binding;
+        struct duk_hobject *func;
+        duk_tval ret;
+        duk_ret_t rc;
+
+        if ((func_abs < ctx->bottom) ||
+            (ctx->stack[func_abs].type != DUK_TYPE_OBJECT) ||
+            (ctx->stack[func_abs].u.o->func == NULL)) {
+                duk_error(ctx, DUK_ERR_TYPE_ERROR, "not callable");
+        }
+        func = ctx->stack[func_abs].u.o;
+
+        if (has_this) {
+                ctx->this_binding = ctx->stack[func_abs + 1];
+        } else {
+                ctx->this_binding.type = DUK_TYPE_UNDEFINED;
+        }
+        ctx->bottom = func_abs + 1 + has_this;
+
+        if (func->nargs != DUK_VARARGS) {
+                duk_set_top(ctx, func->nargs);
+        }
+
+        rc = func->func(ctx);
+        if (rc < 0) {
+                ctx->bottom = saved_bottom;
+                ctx->this_binding = saved_this;
+                duk_error(ctx, -rc, "error returned from native function");
+        }
+
+        ret.type = DUK_TYPE_UNDEFINED;
+        if ((rc > 0) && (ctx->top > ctx->bottom)) {
+                ret = ctx->stack[ctx->top - 1];
+                tval_incref(&ret);
+        }
+
+        ctx->bottom = saved_bottom;
+        ctx->this_binding = saved_this;
+        unwind(ctx, func_abs);
+
+        push_tval(ctx, &ret);
+        tval_decref(ctx, &ret);
+}
+
+/* exported interface documented in duktape.h */
+void duk_call(duk_context *ctx, duk_idx_t nargs)
+{
+        call_common(ctx, nargs, 0);
+}
+
+/* exported interface documented in duktape.h */
+void duk_call_method(duk_context *ctx, duk_idx_t nargs)
+{
+        call_common(ctx, nargs, 1);
+}
+
+/* run a call catching any error */
+static duk_int_t
+protected_call(duk_context *ctx, duk_idx_t nargs, int has_this)
+{
+        struct duk_catcher catcher;
+        duk_idx_t saved_bottom = ctx->bottom;
+        duk_tval saved_this = ctx->this_binding;
+        duk_idx_t base = ctx->top - nargs - 1 - has_this;
+
+        catcher.prev = ctx->catcher;
+        ctx->catcher = &catcher;
+        if (setjmp(catcher.env) == 0) {
+                call_common(ctx, nargs, has_this);
+                ctx->catcher = catcher.prev;
+                return DUK_EXEC_SUCCESS;
+        }
+
+        ctx->catcher = catcher.prev;
+        ctx->bottom = saved_bottom;
+        ctx->this_binding = saved_this;
+        unwind(ctx, base);
+        duk_push_string(ctx, ctx->error);
+        return DUK_EXEC_ERROR;
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t duk_pcall(duk_context *ctx, duk_idx_t nargs)
+{
+        return protected_call(ctx, nargs, 0);
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t duk_pcall_method(duk_context *ctx, duk_idx_t nargs)
+{
+        return protected_call(ctx, nargs, 1);
+}
+
+/* move the results of a safe call down to the base of its arguments */
+static void
+safe_call_results(duk_context *ctx, duk_idx_t base, duk_ret_t rc, duk_idx_t nrets)
+{
+        duk_tval rets[8];
+        duk_idx_t retc = 0;
+        duk_idx_t idx;
+
+        if (nrets > 8) {
+                fatal("too many return values");
+        }
+        if (rc > nrets) {
+                rc = nrets;
+        }
+        for (idx = rc; idx > 0; idx--) {
+                rets[retc] = ctx->stack[ctx->top - idx];
+                tval_incref(&rets[retc]);
+                retc++;
+        }
+        unwind(ctx, base);
+        for (idx = 0; idx < retc; idx++) {
+                push_tval(ctx, &rets[idx]);
+                tval_decref(ctx, &rets[idx]);
+        }
+        for (; retc < nrets; retc++) {
+                duk_push_undefined(ctx);
+        }
+}
+
+/* exported interface documented in duktape.h */
+duk_int_t
+duk_safe_call(duk_context *ctx,
+              duk_safe_call_function func,
+              void *udata,
+              duk_idx_t nargs,
+              duk_idx_t nrets)
+{
+        struct duk_catcher catcher;
+        duk_idx_t saved_bottom = ctx->bottom;
+        duk_tval saved_this = ctx->this_binding;
+        duk_idx_t base = ctx->top - nargs;
+        duk_ret_t rc;
+
+        catcher.prev = ctx->catcher;
+        ctx->catcher = &catcher;
+        if (setjmp(catcher.env) == 0) {
+                ctx->bottom = base;
+                ctx->this_binding.type = DUK_TYPE_UNDEFINED;
+
+                rc = func(ctx, udata);
+
+                ctx->catcher = catcher.prev;
+                ctx->bottom = saved_bottom;
+                ctx->this_binding = saved_this;
+                safe_call_results(ctx, base, rc, nrets);
+                return DUK_EXEC_SUCCESS;
+        }
+
+        ctx->catcher = catcher.prev;
+        ctx->bottom = saved_bottom;
+        ctx->this_binding = saved_this;
+        unwind(ctx, base);
+        duk_push_string(ctx, ctx->error);
+        duk_set_top(ctx, base + nrets - saved_bottom);
+        return DUK_EXEC_ERROR;
+}
+
+/* exported interface documented in duktape.h */
+duk_ret_t duk_error(duk_context *ctx, duk_errcode_t err_code, const char *fmt, ...)
+{
+        char msg[256];
+        va_list ap;
+
+        va_start(ap, fmt);
+        vsnprintf(msg, sizeof(msg), fmt, ap);
+        va_end(ap);
+
+        ctx->error = intern(ctx, msg, strlen(msg));
+
+        if (ctx->catcher == NULL) {
+                fprintf(stderr, "stub duktape: uncaught error %d: %s\n",
+                        err_code, msg);
+                abort();
+        }
+        longjmp(ctx->catcher->env, 1);
+}
+
+/* exported interface documented in duktape.h */
+duk_ret_t duk_throw(duk_context *ctx)
+{
+        return duk_error(ctx, DUK_ERR_ERROR, "%s", duk_to_string(ctx, -1));
+}
+
+/* exported interface documented in duktape.h */
+unsigned long duk_stub_live_objects(duk_context *ctx)
+{
+        return ctx->live;
+}
@@ -0,0 +1,183 @@
+/* stub duktape interface for the runtime benchmark harness
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ *
+ * Only the subset of the duktape 2 API used by generated bindings and
+ * the harness is provided. The value stack, call frames, prototype
+ * chains, accessor properties and reference counted finalisation
+ * behave as they do in duktape so generated code follows the same
+ * paths it would in a browser.
+ */
+
+#ifndef stub_duktape_h
+#define stub_duktape_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct duk_hthread duk_context;
+
+typedef int duk_idx_t;
+typedef int duk_ret_t;
+typedef int duk_int_t;
+typedef unsigned int duk_uint_t;
+typedef size_t duk_size_t;
+typedef int duk_bool_t;
+typedef int duk_errcode_t;
+typedef double duk_double_t;
+
+typedef duk_ret_t (*duk_c_function)(duk_context *ctx);
+typedef duk_ret_t (*duk_safe_call_function)(duk_context *ctx, void *udata);
+
+#define DUK_VARARGS ((duk_int_t) (-1))
+#define DUK_INVALID_INDEX ((duk_idx_t) (-0x7fffffffL - 1))
+
+#define DUK_WELLKNOWN_SYMBOL(desc) ("\x81" desc "\xff")
+
+#define DUK_TYPE_NONE 0
+#define DUK_TYPE_UNDEFINED 1
+#define DUK_TYPE_NULL 2
+#define DUK_TYPE_BOOLEAN 3
+#define DUK_TYPE_NUMBER 4
+#define DUK_TYPE_STRING 5
+#define DUK_TYPE_OBJECT 6
+#define DUK_TYPE_BUFFER 7
+#define DUK_TYPE_POINTER 8
+#define DUK_TYPE_LIGHTFUNC 9
+
+#define DUK_ERR_NONE 0
+#define DUK_ERR_ERROR 1
+#define DUK_ERR_EVAL_ERROR 2
+#define DUK_ERR_RANGE_ERROR 3
+#define DUK_ERR_REFERENCE_ERROR 4
+#define DUK_ERR_SYNTAX_ERROR 5
+#define DUK_ERR_TYPE_ERROR 6
+#define DUK_ERR_URI_ERROR 7
+
+#define DUK_RET_ERROR (-DUK_ERR_ERROR)
+#define DUK_RET_TYPE_ERROR (-DUK_ERR_TYPE_ERROR)
+#define DUK_RET_RANGE_ERROR (-DUK_ERR_RANGE_ERROR)
+
+#define DUK_EXEC_SUCCESS 0
+#define DUK_EXEC_ERROR 1
+
+#define DUK_DEFPROP_WRITABLE (1U << 0)
+#define DUK_DEFPROP_ENUMERABLE (1U << 1)
+#define DUK_DEFPROP_CONFIGURABLE (1U << 2)
+#define DUK_DEFPROP_HAVE_WRITABLE (1U << 3)
+#define DUK_DEFPROP_HAVE_ENUMERABLE (1U << 4)
+#define DUK_DEFPROP_HAVE_CONFIGURABLE (1U << 5)
+#define DUK_DEFPROP_HAVE_VALUE (1U << 6)
+#define DUK_DEFPROP_HAVE_GETTER (1U << 7)
+#define DUK_DEFPROP_HAVE_SETTER (1U << 8)
+#define DUK_DEFPROP_FORCE (1U << 9)
+
+/* heap lifetime */
+duk_context *duk_create_heap_default(void);
+void duk_destroy_heap(duk_context *ctx);
+
+/* value stack manipulation */
+duk_idx_t duk_get_top(duk_context *ctx);
+void duk_set_top(duk_context *ctx, duk_idx_t idx);
+duk_idx_t duk_normalize_index(duk_context *ctx, duk_idx_t idx);
+void duk_pop(duk_context *ctx);
+void duk_pop_2(duk_context *ctx);
+void duk_pop_3(duk_context *ctx);
+void duk_pop_n(duk_context *ctx, duk_idx_t count);
+void duk_dup(duk_context *ctx, duk_idx_t idx);
+void duk_replace(duk_context *ctx, duk_idx_t idx);
+void duk_insert(duk_context *ctx, duk_idx_t idx);
+void duk_remove(duk_context *ctx, duk_idx_t idx);
+
+/* pushing values */
+void duk_push_undefined(duk_context *ctx);
+void duk_push_null(duk_context *ctx);
+void duk_push_boolean(duk_context *ctx, duk_bool_t val);
+void duk_push_int(duk_context *ctx, duk_int_t val);
+void duk_push_uint(duk_context *ctx, duk_uint_t val);
+void duk_push_number(duk_context *ctx, duk_double_t val);
+const char *duk_push_string(duk_context *ctx, const char *str);
+const char *duk_push_lstring(duk_context *ctx, const char *str, size_t len);
+void duk_push_pointer(duk_context *ctx, void *ptr);
+duk_idx_t duk_push_object(duk_context *ctx);
+duk_idx_t duk_push_array(duk_context *ctx);
+duk_idx_t duk_push_c_function(duk_context *ctx, duk_c_function func, duk_int_t nargs);
+void duk_push_this(duk_context *ctx);
+void duk_push_global_object(duk_context *ctx);
+void duk_push_global_stash(duk_context *ctx);
+duk_idx_t duk_push_heapptr(duk_context *ctx, void *ptr);
+duk_idx_t duk_push_proxy(duk_context *ctx, duk_uint_t proxy_flags);
+
+/* type checks */
+duk_int_t duk_get_type(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_check_type(duk_context *ctx, duk_idx_t idx, duk_int_t type);
+duk_bool_t duk_is_undefined(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_null(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_null_or_undefined(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_boolean(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_number(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_string(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_object(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_pointer(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_is_function(duk_context *ctx, duk_idx_t idx);
+#define duk_is_callable(ctx, idx) duk_is_function((ctx), (idx))
+duk_bool_t duk_strict_equals(duk_context *ctx, duk_idx_t idx1, duk_idx_t idx2);
+
+/* getting values */
+duk_bool_t duk_get_boolean(duk_context *ctx, duk_idx_t idx);
+duk_int_t duk_get_int(duk_context *ctx, duk_idx_t idx);
+duk_uint_t duk_get_uint(duk_context *ctx, duk_idx_t idx);
+duk_double_t duk_get_number(duk_context *ctx, duk_idx_t idx);
+const char *duk_get_string(duk_context *ctx, duk_idx_t idx);
+const char *duk_get_lstring(duk_context *ctx, duk_idx_t idx, duk_size_t *len);
+void *duk_get_pointer(duk_context *ctx, duk_idx_t idx);
+void *duk_get_heapptr(duk_context *ctx, duk_idx_t idx);
+duk_bool_t duk_require_boolean(duk_context *ctx, duk_idx_t idx);
+duk_int_t duk_require_int(duk_context *ctx, duk_idx_t idx);
+duk_double_t duk_require_number(duk_context *ctx, duk_idx_t idx);
+const char *duk_require_string(duk_context *ctx, duk_idx_t idx);
+void *duk_require_pointer(duk_context *ctx, duk_idx_t idx);
+duk_size_t duk_get_length(duk_context *ctx, duk_idx_t idx);
+
+/* coercion */
+duk_bool_t duk_to_boolean(duk_context *ctx, duk_idx_t idx);
+duk_int_t duk_to_int(duk_context *ctx, duk_idx_t idx);
+const char *duk_to_string(duk_context *ctx, duk_idx_t idx);
+const char *duk_safe_to_string(duk_context *ctx, duk_idx_t idx);
+void duk_concat(duk_context *ctx, duk_idx_t count);
+
+/* properties */
+duk_bool_t duk_get_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key);
+duk_bool_t duk_put_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key);
+duk_bool_t duk_del_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key);
+duk_bool_t duk_has_prop_string(duk_context *ctx, duk_idx_t obj_idx, const char *key);
+duk_bool_t duk_get_prop(duk_context *ctx, duk_idx_t obj_idx);
+duk_bool_t duk_has_prop(duk_context *ctx, duk_idx_t obj_idx);
+duk_bool_t duk_get_prop_index(duk_context *ctx, duk_idx_t obj_idx, duk_uint_t arr_idx);
+duk_bool_t duk_put_prop_index(duk_context *ctx, duk_idx_t obj_idx, duk_uint_t arr_idx);
+void duk_def_prop(duk_context *ctx, duk_idx_t obj_idx, duk_uint_t flags);
+duk_bool_t duk_get_global_string(duk_context *ctx, const char *key);
+duk_bool_t duk_put_global_string(duk_context *ctx, const char *key);
+void duk_get_prototype(duk_context *ctx, duk_idx_t idx);
+void duk_set_prototype(duk_context *ctx, duk_idx_t idx);
+void duk_get_finalizer(duk_context *ctx, duk_idx_t idx);
+void duk_set_finalizer(duk_context *ctx, duk_idx_t idx);
+
+/* calls */
+void duk_call(duk_context *ctx, duk_idx_t nargs);
+void duk_call_method(duk_context *ctx, duk_idx_t nargs);
+duk_int_t duk_pcall(duk_context *ctx, duk_idx_t nargs);
+duk_int_t duk_pcall_method(duk_context *ctx, duk_idx_t nargs);
+duk_int_t duk_safe_call(duk_context *ctx, duk_safe_call_function func, void *udata, duk_idx_t nargs, duk_idx_t nrets);
+
+/* errors */
+duk_ret_t duk_error(duk_context *ctx, duk_errcode_t err_code, const char *fmt, ...);
+duk_ret_t duk_throw(duk_context *ctx);
+
+/* stub statistics */
+unsigned long duk_stub_live_objects(duk_context *ctx);
+
+#endif
@@ -0,0 +1,87 @@
+/* fake DOM node layer for the runtime benchmark harness
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ *
+ * Stands in for libdom nodes. Reference counting behaves as libdom
+ * does so the init and fini code of the generated bindings does
+ * comparable work.
+ */
+
+#ifndef fakedom_h
+#define fakedom_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct fakedom_node {
+        unsigned int refcnt;
+        int depth;
+        int value;
+        int width;
+        int length;
+        bool hidden;
+};
+
+static inline struct fakedom_node *fakedom_node_create(int depth)
+{
+        struct fakedom_node *node;
+
+        node = calloc(1, sizeof(*node));
+        if (node != NULL) {
+                node->refcnt = 1;
+                node->depth = depth;
+        }
+        return node;
+}
+
+static inline void fakedom_node_ref(struct fakedom_node *node)
+{
+        node->refcnt++;
+}
+
+static inline void fakedom_node_unref(struct fakedom_node *node)
+{
+        if (--node->refcnt == 0) {
+                free(node);
+        }
+}
+
+/* the parts of libdom generated event handler getters use */
+typedef struct fakedom_node dom_event_target;
+
+typedef struct dom_string {
+        size_t len;
+        char data[];
+} dom_string;
+
+typedef enum {
+        DOM_NO_ERR = 0,
+        DOM_NO_MEM_ERR = 1,
+} dom_exception;
+
+static inline dom_exception
+dom_string_create(const uint8_t *ptr, size_t len, dom_string **str)
+{
+        dom_string *ret;
+
+        ret = malloc(sizeof(*ret) + len);
+        if (ret == NULL) {
+                return DOM_NO_MEM_ERR;
+        }
+        ret->len = len;
+        memcpy(ret->data, ptr, len);
+        *str = ret;
+        return DOM_NO_ERR;
+}
+
+static inline void dom_string_unref(dom_string *str)
+{
+        free(str);
+}
+
+#endif
@@ -0,0 +1,638 @@
+/* runtime benchmark harness for generated bindings
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ *
+ * Drives the bindings generated from bench.bnd through the stub
+ * duktape in the same way script would and reports the throughput of
+ * each kind of binding call.
+ *
+ * usage: harness [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "harness.h"
+#include "binding.h"
+#include "private.h"
+#include "prototype.h"
+
+#define PROTO_BENCHNODE PROTO_NAME(BENCHNODE)
+#define PROTO_BENCHELEMENT PROTO_NAME(BENCHELEMENT)
+#define PROTO_BENCHLIST PROTO_NAME(BENCHLIST)
+#define PROTO_BENCHMAP PROTO_NAME(BENCHMAP)
+
+typedef void (bench_fn)(duk_context *ctx, long iterations);
+
+static double now(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+static long content_attribute_lookups;
+
+/* exported interface documented in harness.h */
+bool dukky_get_current_value_of_event_handler(duk_context *ctx,
+                                              dom_string *name,
+                                              dom_event_target *et)
+{
+        (void)name;
+        (void)et;
+
+        content_attribute_lookups++;
+
+        /* ... node */
+        duk_push_null(ctx);
+        duk_insert(ctx, -2);
+        /* ... handler node */
+        return true;
+}
+
+/**
+ * create an object for a node in the way the browser does
+ *
+ * leaves the new object on the top of the stack
+ *
+ * \return The node the object wraps.
+ */
+static struct fakedom_node *
+create_object(duk_context *ctx, const char *proto, int depth)
+{
+        struct fakedom_node *node;
+
+        node = fakedom_node_create(depth);
+
+        duk_push_object(ctx);
+        /* obj */
+        duk_get_global_string(ctx, PROTO_MAGIC);
+        duk_get_prop_string(ctx, -1, proto);
+        duk_replace(ctx, -2);
+        /* obj proto */
+        duk_set_prototype(ctx, -2);
+        /* obj */
+        duk_get_prop_string(ctx, -1, INIT_MAGIC);
+        /* obj init */
+        duk_dup(ctx, -2);
+        duk_push_pointer(ctx, node);
+        /* obj init obj node */
+        duk_call(ctx, 2);
+        /* obj obj-or-proxy */
+        duk_replace(ctx, -2);
+
+        /* the binding holds its own reference */
+        fakedom_node_unref(node);
+
+        return node;
+}
+
+static void bench_getter(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        create_object(ctx, PROTO_BENCHNODE, 1);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -1, "value");
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+}
+
+static void bench_inherited_getter(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -1, "depth");
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+}
+
+static void bench_setter(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_push_int(ctx, idx);
+                duk_put_prop_string(ctx, -2, "width");
+        }
+        duk_pop(ctx);
+}
+
+static void bench_method(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        create_object(ctx, PROTO_BENCHNODE, 1);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -1, "add");
+                duk_dup(ctx, -2);
+                duk_push_int(ctx, idx);
+                duk_push_int(ctx, 1);
+                duk_call_method(ctx, 2);
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+}
+
+static void bench_enum_argument(duk_context *ctx, long iterations)
+{
+        long idx;
+        long count = 0;
+
+        create_object(ctx, PROTO_BENCHNODE, 1);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -1, "mode");
+                duk_dup(ctx, -2);
+                duk_push_string(ctx, "paused");
+                duk_call_method(ctx, 1);
+                count += duk_get_int(ctx, -1);
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+
+        if (count != iterations * DUKKY_BENCH_MODE_PAUSED) {
+                fprintf(stderr, "enum conversion failed\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static void bench_same_object_getter(duk_context *ctx, long iterations)
+{
+        long idx;
+        long count = 0;
+
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+        duk_get_prop_string(ctx, -1, "style");
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -2, "style");
+                count += duk_strict_equals(ctx, -1, -2);
+                duk_pop(ctx);
+        }
+        duk_pop_2(ctx);
+
+        if (count != iterations) {
+                fprintf(stderr, "[SameObject] getter returned a new object\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static void bench_pure_getter(duk_context *ctx, long iterations)
+{
+        long idx;
+        long width = 0;
+
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+        for (idx = 0; idx < iterations; idx++) {
+                /* changing the width invalidates the cached area */
+                if ((idx % 64) == 0) {
+                        width = idx % 1000;
+                        duk_push_int(ctx, width);
+                        duk_put_prop_string(ctx, -2, "width");
+                }
+                duk_get_prop_string(ctx, -1, "area");
+                if (duk_get_int(ctx, -1) != width * 2) {
+                        fprintf(stderr, "[Pure] getter returned a stale value\n");
+                        exit(EXIT_FAILURE);
+                }
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+}
+
+static void bench_lifecycle(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        for (idx = 0; idx < iterations; idx++) {
+                create_object(ctx, PROTO_BENCHELEMENT, 2);
+                /* dropping the last reference runs the finalizer */
+                duk_pop(ctx);
+        }
+}
+
+static void bench_instanceof(duk_context *ctx, long iterations)
+{
+        long idx;
+        long count = 0;
+
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+        for (idx = 0; idx < iterations; idx++) {
+                count += dukky_instanceof(ctx, -1, PROTO_BENCHNODE);
+        }
+        duk_pop(ctx);
+
+        if (count != iterations) {
+                fprintf(stderr, "instanceof failed\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static void bench_wrapper_lookup(duk_context *ctx, long iterations)
+{
+        struct fakedom_node *node;
+        long idx;
+        long count = 0;
+
+        node = create_object(ctx, PROTO_BENCHELEMENT, 2);
+        for (idx = 0; idx < iterations; idx++) {
+                if (dukky_wrapper_push(ctx, node)) {
+                        count += duk_strict_equals(ctx, -1, -2);
+                        duk_pop(ctx);
+                }
+        }
+        duk_pop(ctx);
+
+        if (count != iterations) {
+                fprintf(stderr, "wrapper lookup failed\n");
+                exit(EXIT_FAILURE);
+        }
+        if (dukky_wrapper_find(ctx, node) != NULL) {
+                fprintf(stderr, "wrapper not removed by finalizer\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+/*
+ * drop a collection from the top of the stack
+ *
+ * The instance holds its proxy alive and duktape collects the cycle
+ * with mark and sweep. The stub only counts references so the hidden
+ * reference is removed first.
+ */
+static void pop_collection(duk_context *ctx)
+{
+        duk_del_prop_string(ctx, -1, MAGIC(PROXY));
+        duk_pop(ctx);
+}
+
+static void bench_indexed_property(duk_context *ctx, long iterations)
+{
+        struct fakedom_node *node;
+        long idx;
+        long count = 0;
+
+        node = create_object(ctx, PROTO_BENCHLIST, 1);
+        node->length = 100;
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_index(ctx, -1, idx % 128);
+                if (duk_is_number(ctx, -1)) {
+                        count += duk_get_int(ctx, -1);
+                }
+                duk_pop(ctx);
+        }
+        pop_collection(ctx);
+
+        /* indexes past the length are undefined */
+        if (count != (iterations / 128) * 9900 +
+            ((iterations % 128) < 100 ?
+             (iterations % 128) * ((iterations % 128) - 1) : 9900)) {
+                fprintf(stderr, "indexed property failed\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static void bench_named_property(duk_context *ctx, long iterations)
+{
+        long idx;
+        long count = 0;
+
+        create_object(ctx, PROTO_BENCHLIST, 1);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -1, "first");
+                count += duk_is_number(ctx, -1);
+                duk_pop(ctx);
+        }
+        /* ordinary properties are not named properties */
+        duk_get_prop_string(ctx, -1, "length");
+        count += duk_is_number(ctx, -1);
+        duk_pop(ctx);
+        pop_collection(ctx);
+
+        if (count != iterations + 1) {
+                fprintf(stderr, "named property failed\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static void bench_iterator_next(duk_context *ctx, long iterations)
+{
+        struct fakedom_node *node;
+        long idx;
+        long count = 0;
+
+        node = create_object(ctx, PROTO_BENCHLIST, 1);
+        node->length = 100;
+        duk_push_undefined(ctx);
+        for (idx = 0; idx < iterations; idx++) {
+                if (duk_is_undefined(ctx, -1)) {
+                        /* list undefined */
+                        duk_get_prop_string(ctx, -2, "values");
+                        duk_dup(ctx, -3);
+                        duk_call_method(ctx, 0);
+                        duk_replace(ctx, -2);
+                        count = 0;
+                }
+                /* list iterator */
+                duk_get_prop_string(ctx, -1, "next");
+                duk_dup(ctx, -2);
+                duk_call_method(ctx, 0);
+                /* list iterator result */
+                duk_get_prop_string(ctx, -1, "done");
+                if (duk_get_boolean(ctx, -1)) {
+                        if (count != node->length) {
+                                fprintf(stderr, "iterator ended early\n");
+                                exit(EXIT_FAILURE);
+                        }
+                        duk_pop_3(ctx);
+                        duk_push_undefined(ctx);
+                        continue;
+                }
+                duk_pop(ctx);
+                duk_get_prop_string(ctx, -1, "value");
+                if (duk_get_int(ctx, -1) != count * 2) {
+                        fprintf(stderr, "iterator returned a wrong value\n");
+                        exit(EXIT_FAILURE);
+                }
+                count++;
+                duk_pop_2(ctx);
+        }
+        duk_pop(ctx);
+        pop_collection(ctx);
+}
+
+static long foreach_sum;
+
+static duk_ret_t foreach_callback(duk_context *ctx)
+{
+        /* value key map */
+        foreach_sum += duk_get_int(ctx, 0);
+        return 0;
+}
+
+static void bench_foreach(duk_context *ctx, long iterations)
+{
+        struct fakedom_node *node;
+        long idx;
+
+        foreach_sum = 0;
+        node = create_object(ctx, PROTO_BENCHMAP, 1);
+        node->length = 100;
+        for (idx = 0; idx < iterations; idx += node->length) {
+                duk_get_prop_string(ctx, -1, "forEach");
+                duk_dup(ctx, -2);
+                duk_push_c_function(ctx, foreach_callback, 3);
+                duk_call_method(ctx, 1);
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+
+        if (foreach_sum != ((iterations + 99) / 100) * 9900) {
+                fprintf(stderr, "forEach failed\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static duk_ret_t invoked_callback(duk_context *ctx)
+{
+        /* value mode */
+        duk_push_int(ctx, duk_get_int(ctx, 0) +
+                     (strcmp(duk_get_string(ctx, 1), "running") == 0));
+        return 1;
+}
+
+static void bench_callback_invoke(duk_context *ctx, long iterations)
+{
+        struct dukky_callback cb = { NULL, 0 };
+        long idx;
+
+        duk_push_c_function(ctx, invoked_callback, 2);
+        dukky_callback_set(ctx, -1, &cb);
+        duk_pop(ctx);
+
+        for (idx = 0; idx < iterations; idx++) {
+                if ((dukky_bench_callback_invoke(ctx, &cb, DUK_INVALID_INDEX,
+                                idx, DUKKY_BENCH_MODE_RUNNING) !=
+                     DUK_EXEC_SUCCESS) ||
+                    (duk_get_int(ctx, -1) != idx + 1)) {
+                        fprintf(stderr, "callback invocation failed\n");
+                        exit(EXIT_FAILURE);
+                }
+                duk_pop(ctx);
+        }
+
+        dukky_callback_clear(ctx, &cb);
+
+        /* the slot array lives for the heap so drop it for the leak check */
+        duk_push_global_stash(ctx);
+        duk_del_prop_string(ctx, -1, MAGIC(CALLBACKS));
+        duk_pop(ctx);
+}
+
+static void bench_callback_argument(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        create_object(ctx, PROTO_BENCHNODE, 1);
+        duk_push_c_function(ctx, invoked_callback, 2);
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -2, "invoke");
+                duk_dup(ctx, -3);
+                duk_dup(ctx, -3);
+                duk_push_int(ctx, idx);
+                duk_call_method(ctx, 2);
+                if (duk_get_int(ctx, -1) != idx + 1) {
+                        fprintf(stderr, "callback argument failed\n");
+                        exit(EXIT_FAILURE);
+                }
+                duk_pop(ctx);
+        }
+        duk_pop_2(ctx);
+}
+
+static void bench_event_handler_getter(duk_context *ctx, long iterations)
+{
+        long idx;
+
+        content_attribute_lookups = 0;
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+
+        /* an unset handler falls back to the content attribute */
+        duk_get_prop_string(ctx, -1, "onbench");
+        if (!duk_is_null(ctx, -1) || (content_attribute_lookups != 1)) {
+                fprintf(stderr, "event handler fallback failed\n");
+                exit(EXIT_FAILURE);
+        }
+        duk_pop(ctx);
+
+        duk_push_c_function(ctx, invoked_callback, 2);
+        duk_put_prop_string(ctx, -2, "onbench");
+        for (idx = 0; idx < iterations; idx++) {
+                duk_get_prop_string(ctx, -1, "onbench");
+                if (!duk_is_function(ctx, -1)) {
+                        fprintf(stderr, "event handler was not stored\n");
+                        exit(EXIT_FAILURE);
+                }
+                duk_pop(ctx);
+        }
+        duk_pop(ctx);
+
+        if (content_attribute_lookups != 1) {
+                fprintf(stderr, "event handler read was not from its slot\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static long dispatched;
+
+static duk_ret_t inline_handler(duk_context *ctx)
+{
+        /* event */
+        dispatched += duk_get_int(ctx, 0);
+        return 0;
+}
+
+static void bench_event_handler_dispatch(duk_context *ctx, long iterations)
+{
+        struct dukky_callback *cb;
+        void *priv;
+        int slot;
+        long idx;
+
+        dispatched = 0;
+        create_object(ctx, PROTO_BENCHELEMENT, 2);
+        duk_push_c_function(ctx, inline_handler, 1);
+        duk_put_prop_string(ctx, -2, "onbench");
+        duk_get_prop_string(ctx, -1, PRIVATE_MAGIC);
+        priv = duk_get_pointer(ctx, -1);
+        duk_pop(ctx);
+
+        /* what the dispatcher does for each event on the target */
+        for (idx = 0; idx < iterations; idx++) {
+                slot = dukky_event_handler_from_string("bench", 5);
+                cb = dukky_event_handler_get(priv, slot);
+                if (cb != NULL) {
+                        duk_push_int(ctx, 1);
+                        dukky_event_handler_non_null_invoke(ctx, cb, -2, -1);
+                        duk_pop_2(ctx);
+                }
+        }
+        duk_pop(ctx);
+
+        if (dispatched != iterations) {
+                fprintf(stderr, "event handler dispatch failed\n");
+                exit(EXIT_FAILURE);
+        }
+}
+
+static const struct {
+        const char *name;
+        bench_fn *fn;
+} benchmarks[] = {
+        { "getter", bench_getter },
+        { "inherited getter", bench_inherited_getter },
+        { "setter", bench_setter },
+        { "method", bench_method },
+        { "enum argument", bench_enum_argument },
+        { "[SameObject] getter", bench_same_object_getter },
+        { "[Pure] getter", bench_pure_getter },
+        { "constructor/finalizer", bench_lifecycle },
+        { "instanceof", bench_instanceof },
+        { "wrapper lookup", bench_wrapper_lookup },
+        { "indexed property", bench_indexed_property },
+        { "named property", bench_named_property },
+        { "iterator next", bench_iterator_next },
+        { "forEach entry", bench_foreach },
+        { "callback invoke", bench_callback_invoke },
+        { "callback argument", bench_callback_argument },
+        { "event handler getter", bench_event_handler_getter },
+        { "event handler dispatch", bench_event_handler_dispatch },
+        { NULL, NULL },
+};
+
+int main(int argc, char **argv)
+{
+        duk_context *ctx;
+        long iterations = 1000000;
+        double start;
+        double elapsed;
+        unsigned long live;
+        int idx;
+
+        if (argc > 1) {
+                iterations = strtol(argv[1], NULL, 10);
+        }
+
+        ctx = duk_create_heap_default();
+        if (ctx == NULL) {
+                fprintf(stderr, "unable to create heap\n");
+                return EXIT_FAILURE;
+        }
+
+        /* the prototypes are looked up through the global object */
+        duk_push_global_object(ctx);
+        duk_dup(ctx, -1);
+        duk_put_prop_string(ctx, -2, PROTO_MAGIC);
+        duk_pop(ctx);
+
+        dukky_create_prototypes(ctx);
+
+        printf("%-24s %12s %14s\n", "benchmark", "ns/call", "calls/sec");
+        for (idx = 0; benchmarks[idx].name != NULL; idx++) {
+                live = duk_stub_live_objects(ctx);
+
+                start = now();
+                benchmarks[idx].fn(ctx, iterations);
+                elapsed = now() - start;
+
+                if (duk_stub_live_objects(ctx) != live) {
+                        fprintf(stderr, "%s leaked %lu objects\n",
+                                benchmarks[idx].name,
+                                duk_stub_live_objects(ctx) - live);
+                        return EXIT_FAILURE;
+                }
+
+                printf("%-24s %12.1f %14.0f\n",
+                       benchmarks[idx].name,
+                       (elapsed * 1e9) / iterations,
+                       iterations / elapsed);
+        }
+
+#ifdef DUKKY_PROFILE_COUNT
+        /* bindings generated with profiling counters */
+        printf("\n%-40s %12s %14s\n", "function", "calls", "ns/call");
+        for (idx = 0; idx < DUKKY_PROFILE_COUNT; idx++) {
+                if (dukky_profile_table[idx].calls != 0) {
+                        printf("%-40s %12lu %14.1f\n",
+                               dukky_profile_table[idx].name,
+                               dukky_profile_table[idx].calls,
+                               (double)dukky_profile_table[idx].nsec /
+                               dukky_profile_table[idx].calls);
+                }
+        }
+#endif
+
+        if (duk_get_top(ctx) != 0) {
+                fprintf(stderr, "value stack not balanced\n");
+                return EXIT_FAILURE;
+        }
+
+        /* break the global object reference cycle */
+        duk_push_global_object(ctx);
+        duk_del_prop_string(ctx, -1, PROTO_MAGIC);
+        duk_pop(ctx);
+
+        duk_destroy_heap(ctx);
+
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,33 @@
+/* runtime benchmark harness environment for generated bindings
+ *
+ * This file is part of nsgenbind.
+ * Licensed under the MIT License,
+ *                http://www.opensource.org/licenses/mit-license.php
+ * Copyright 2026 nsgenbind contributors
+ *
+ * Provides what the browser would for generated bindings: the duktape
+ * API, the DOM node layer and logging.
+ */
+
+#ifndef harness_h
+#define harness_h
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "duktape.h"
+#include "fakedom.h"
+
+#define LOG(fmt, ...) do { } while (0)
+
+/**
+ * push the handler compiled from a content attribute below the node
+ *
+ * the harness elements have no content attributes so this pushes null
+ */
+bool dukky_get_current_value_of_event_handler(duk_context *ctx,
+                                              dom_string *name,
+                                              dom_event_target *et);
+
+#endif
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Benchmark the runtime cost of generated bindings
+#
+# The bindings generated from runtime/bench.bnd are built against the
+# stub duktape and fake DOM node layer in runtime/ and the throughput
+# of getters, setters, method calls, object construction and
+# finalisation, instanceof checks, wrapper cache lookups, indexed
+# and named property access, iteration, callback invocation and event
+# handler dispatch is reported.
+
+BUILDDIR=$1
+TESTSRCDIR=$2
+
+# locations
+RUNTIMESRCDIR=${TESTSRCDIR}/runtime
+RUNTIMEOUTDIR=${BUILDDIR}/runtime
+GENDIR=${RUNTIMEOUTDIR}/bindings
+
+# genbind tool
+NSGENBIND=${BUILDDIR}/nsgenbind
+
+# compiler
+CC=${CC:-cc}
+RUNTIME_CFLAGS=${RUNTIME_CFLAGS:-"-O2"}
+
+ITERATIONS=${BENCH_ITERATIONS:-1000000}
+
+# additional generator flags e.g. -p to measure profiling overhead or
+# --profile-use=runtime/bench.profile for hot and cold placement
+GENFLAGS=${NSGENBIND_FLAGS:-""}
+
+mkdir -p ${GENDIR}
+
+${NSGENBIND} ${GENFLAGS} -I ${RUNTIMESRCDIR} ${RUNTIMESRCDIR}/bench.bnd ${GENDIR}
+if [ $? -ne 0 ]; then
+  echo "    RUNTIME: binding generation......FAIL"
+  exit 1
+fi
+
+SOURCES="${RUNTIMESRCDIR}/harness.c ${RUNTIMESRCDIR}/duktape.c"
+for SRC in $(sed -n 's/^NSGENBIND_SOURCES:=//p' ${GENDIR}/Makefile);do
+  SOURCES="${SOURCES} ${GENDIR}/${SRC}"
+done
+
+${CC} -std=c99 -D_POSIX_C_SOURCE=200809L ${RUNTIME_CFLAGS} -I${RUNTIMESRCDIR} -I${GENDIR} -o ${RUNTIMEOUTDIR}/harness ${SOURCES}
+if [ $? -ne 0 ]; then
+  echo "    RUNTIME: harness build......FAIL"
+  exit 1
+fi
+
+${RUNTIMEOUTDIR}/harness ${ITERATIONS}
@@ -50,6 +50,17 @@ for TEST in ${BINDINGTESTS};do
 
   RESULT=$?
 
+  # lines expected in the intermediate representation dump
+  EXPECTFILE=${BINDINGDIR}/${TESTNAME}.expect
+  if [ ${RESULT} -eq 0 ] && [ -f ${EXPECTFILE} ]; then
+    while IFS= read -r EXPECT; do
+      if ! grep -qF -- "${EXPECT}" ${TESTDIR}/ir-map; then
+        echo "Missing from ir-map: ${EXPECT}" >>${ERRFILE}
+        RESULT=1
+      fi
+    done <${EXPECTFILE}
+  fi
+
   echo >> ${LOGFILE}
   cat ${ERRFILE} >> ${LOGFILE}
   echo >> ${LOGFILE}